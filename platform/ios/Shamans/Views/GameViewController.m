@@ -223,10 +223,12 @@
         {            
             Player* localPlayer = Engine_LocalPlayer(&g_engine);
             
-            UnitInfo resultInfo[SCENE_SYSTEM_UNITS_MAX];
-            NSInteger unitCount = (NSInteger)Player_GetResultUnitInfos(localPlayer, resultInfo);
+            int capacity = g_engine.sceneSystem.unitCapacity + localPlayer->unitSpawnInfoCount;
+            UnitInfo* resultInfo = malloc(sizeof(UnitInfo) * MAX(capacity, 1));
+            NSInteger unitCount = resultInfo ? (NSInteger)Player_GetResultUnitInfos(localPlayer, resultInfo, capacity) : 0;
             
             [_gameDelegate gameViewControllerFinished:self withResult:g_engine.result unitInfo:resultInfo unitCount:unitCount];
+            free(resultInfo);
         }
         else
         {
@@ -118,6 +118,15 @@ typedef struct
     Command (*command)(const Player* controller, const Unit* unit, const AiReport* report);
 } AiAction;
 
+/* walking distance when the unit and target are on the nav mesh, otherwise straight line */
+static int Ai_InMoveRange(const Unit* unit, const float* moveCosts, const NavPoly* targetPoly, Vec3 targetPosition)
+{
+    if (moveCosts && targetPoly)
+        return moveCosts[targetPoly->index] < unit->moveRange;
+    
+    return Vec3_DistSq(unit->position, targetPosition) < unit->moveRange * unit->moveRange;
+}
+
 static AiReport Ai_BuildReport(const Player* controller, const Unit* unit)
 {
     Engine* engine = controller->engine;
@@ -163,14 +172,25 @@ static AiReport Ai_BuildReport(const Player* controller, const Unit* unit)
     float targetDist = HUGE_VALF;
     float closestDist = HUGE_VALF;
     
+    // path costs to everywhere this unit can walk, shared by the move range checks below
+    const float* moveCosts = NULL;
+    
+    if (unit->navPoly)
+        moveCosts = NavSystem_Flood(&engine->navSystem, unit->navPoly, unit->position, unit->moveRange, NULL);
+    
 
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+    // commands this turn may have moved or spawned units since the last tick
+    SceneSystem_UpdateHot(&engine->sceneSystem);
+    const SceneHot* hot = &engine->sceneSystem.hot;
+    
+    for (int i = 0; i < hot->liveUnitCount; ++i)
     {
-        Unit* other = engine->sceneSystem.units + i;
-        if (other->dead || other == unit) continue;
-        if (other->state == kUnitStateDead) continue;
+        if (hot->liveUnits[i] == unit->index) continue;
+        if (hot->unitFlags[i] & kSceneHotDying) continue;
+        
+        Unit* other = engine->sceneSystem.units + hot->liveUnits[i];
         
-        float distSq = Vec3_DistSq(unit->position, other->position);
+        float distSq = Vec3_DistSq(unit->position, hot->unitPositions[i]);
         int inRange = distSq < unit->viewRadius * unit->viewRadius;
         
         float closeMoveRange = unit->moveRange + 0.5f;
@@ -178,7 +198,7 @@ static AiReport Ai_BuildReport(const Player* controller, const Unit* unit)
 
         int canSee = unit->isAlerted ? inRange : Unit_CanSee(unit, other, 1.0f);
         
-        if (other->playerId != controller->playerId)
+        if (hot->unitPlayerIds[i] != controller->playerId)
         {
             if (canSee && (!report.target || distSq < targetDist))
             {
@@ -219,7 +239,7 @@ static AiReport Ai_BuildReport(const Player* controller, const Unit* unit)
         if (targetDistSq < primaryWeapon->range * primaryWeapon->range)
             report.conds |= kAiCondTargetInRange;
         
-        if (targetDist < unit->moveRange * unit->moveRange)
+        if (Ai_InMoveRange(unit, moveCosts, report.target->navPoly, report.target->position))
             report.conds |= kAiCondTargetInMoveRange;
         
         if (report.conds & kAiCondTargetInRange)
@@ -240,7 +260,7 @@ static AiReport Ai_BuildReport(const Player* controller, const Unit* unit)
         if (targetDistSq < closeDist * closeDist)
             report.conds |= kAiCondTargetClose;
         
-        if (NavSystem_LineIntersectsSolid(&controller->engine->navSystem, AABB_Center(unit->bounds), AABB_Center(report.target->bounds), 5.0f))
+        if (NavSystem_PolyLineIntersectsSolid(&controller->engine->navSystem, unit->navPoly, report.target->navPoly, AABB_Center(unit->bounds), AABB_Center(report.target->bounds)))
             report.conds |= kAiCondObstacleBetweenTarget;
         
         if (report.target->hp < report.target->maxHp / 3)
@@ -257,7 +277,7 @@ static AiReport Ai_BuildReport(const Player* controller, const Unit* unit)
         }
     }
     
-    for (int i = 0; i < SCENE_SYSTEM_PROPS_MAX; ++i)
+    for (int i = 0; i < controller->engine->sceneSystem.propCapacity; ++i)
     {
         const Prop* prop = controller->engine->sceneSystem.props + i;
         if (prop->dead) continue;
@@ -270,7 +290,7 @@ static AiReport Ai_BuildReport(const Player* controller, const Unit* unit)
             if (distSq < healerRange * healerRange)
                 report.conds |= kAiCondInsideHealer;
             
-            if (distSq < unit->moveRange * unit->moveRange)
+            if (Ai_InMoveRange(unit, moveCosts, prop->navPoly, prop->position))
                 report.conds |= kAiCondHealerInMoveRange;
         }
         
@@ -291,7 +311,7 @@ static Unit* Ai_FindNextUnit(const Player* controller)
 {
     Engine* engine = controller->engine;
 
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+    for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
     {
         Unit* other = engine->sceneSystem.units + i;
         
@@ -420,6 +440,7 @@ static Command Ai_Charge(const Player* controller, const Unit* unit, const AiRep
         NavSystem* nav = &controller->engine->navSystem;
         
         NavPath tempPath;
+        NavPath_Init(&tempPath);
         
         // find a path from the target to this unit
         int status = NavSystem_FindPath(nav,
@@ -428,6 +449,7 @@ static Command Ai_Charge(const Player* controller, const Unit* unit, const AiRep
                                        unit->position,
                                        report->target->navPoly,
                                        unit->navPoly,
+                                       NULL,
                                        &tempPath);
         
         if (status)
@@ -437,6 +459,8 @@ static Command Ai_Charge(const Player* controller, const Unit* unit, const AiRep
             Vec3 point = NavPath_PointAt(&tempPath, primaryWeapon->range * 0.7f);
             newCommand.position = point;
         }
+        
+        NavPath_Shutdown(&tempPath);
     }
 
     return newCommand;
@@ -664,7 +688,7 @@ static Command Ai_Retreat(const Player* controller, const Unit* unit, const AiRe
         // find the neighboring poly that is furthest away from enemies.
         float closestEnemyDistSq = HUGE_VALF;
         
-        for (int j = 0; j < SCENE_SYSTEM_UNITS_MAX; ++j)
+        for (int j = 0; j < controller->engine->sceneSystem.unitCapacity; ++j)
         {
             const Unit* other = controller->engine->sceneSystem.units + j;
             if (other->dead || other->playerId == controller->playerId) continue;
@@ -756,7 +780,7 @@ static Command Ai_Heal(const Player* controller, const Unit* unit, const AiRepor
     const Prop* closestTarget = NULL;
     float bestDist = 0;
     
-    for (int i = 0; i < SCENE_SYSTEM_PROPS_MAX; ++i)
+    for (int i = 0; i < controller->engine->sceneSystem.propCapacity; ++i)
     {
         const Prop* prop = controller->engine->sceneSystem.props + i;
         
@@ -781,18 +805,22 @@ static Command Ai_Heal(const Player* controller, const Unit* unit, const AiRepor
         NavSystem* nav = &controller->engine->navSystem;
                 
         NavPath tempPath;
+        NavPath_Init(&tempPath);
+        
         if (NavSystem_FindPath(nav,
                                1.0f,
                                closestTarget->position,
                                unit->position,
                                closestTarget->navPoly,
                                unit->navPoly,
+                               NULL,
                                &tempPath))
         {
             
         }
         
         Vec3 point = NavPath_PointAt(&tempPath, closeRange);
+        NavPath_Shutdown(&tempPath);
         
         Command newCommand;
         newCommand.playerId = controller->playerId;
@@ -877,7 +905,7 @@ static Command Ai_Teleport(const Player* controller, const Unit* unit, const AiR
         Vec3 center = teleportPoly->plane.point;
         AABB bounds = AABB_CreateCentered(center, Vec3_Create(3.0f, 3.0f, 3.0f));
         
-        for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+        for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
         {
             const Unit* other = engine->sceneSystem.units + i;
             
@@ -970,7 +998,7 @@ static Command Ai_SpawnAlly(const Player* controller, const Unit* unit, const Ai
             {
                 AABB bounds = AABB_CreateCentered(openPoint, Vec3_Create(2.0f, 2.0f, 2.0f));
                 
-                for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+                for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
                 {
                     const Unit* other = engine->sceneSystem.units + i;
                     
@@ -1195,7 +1223,7 @@ static void Ai_OnEvent(Player* controller, const PlayerEvent* event)
         }
         case kPlayerEventStartTurn:
         {
-            for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+            for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
             {
                 Unit* other = engine->sceneSystem.units + i;
                 if (other->dead || other->playerId != controller->playerId) continue;
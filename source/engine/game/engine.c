@@ -7,6 +7,12 @@
 #include <assert.h>
 #include <time.h>
 
+// units after one target before they share a flow field, see Unit_StartPath
+#define ENGINE_SHARED_PATH_UNITS 8
+
+// units steer to keep this much of their radius apart, less than the distance they stop from a target
+#define ENGINE_AVOID_RADIUS_SCALE 0.5f
+
 Engine g_engine;
 
 extern const WeaponInfo g_engineWeaponTable[];
@@ -20,84 +26,79 @@ extern void Engine_UnloadAssets(Engine* engine);
 
 static void Engine_BuildFogView(const Engine* engine, int playerId, FogView* view)
 {
-    int observers[SCENE_SYSTEM_UNITS_MAX];
-    short observerCount = 0;
+    const SceneHot* hot = &engine->sceneSystem.hot;
+    FogView_Reserve(view, engine->sceneSystem.unitCapacity, engine->sceneSystem.propCapacity);
+    
+    Vec3* observerPoints = view->observerPoints;
+    float* observerRadiiSq = view->observerRadiiSq;
+    int observerCount = 0;
     
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+    for (int i = 0; i < hot->liveUnitCount; ++i)
     {
-        const Unit* unit = engine->sceneSystem.units + i;
-        if (unit->dead) continue;
-        
-        if (unit->playerId == playerId)
+        if (hot->unitPlayerIds[i] == playerId)
         {
-            observers[observerCount] = unit->index;
+            observerPoints[observerCount] = hot->unitPositions[i];
+            observerRadiiSq[observerCount] = (float)(hot->unitViewRadii[i] * hot->unitViewRadii[i]);
             ++observerCount;
         }
     }
     
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+    for (int i = 0; i < hot->liveUnitCount; ++i)
     {
-        const Unit* unit = engine->sceneSystem.units + i;
-        if (unit->dead) continue;
+        int unitIndex = hot->liveUnits[i];
         
-        if (unit->playerId != playerId)
+        if (hot->unitPlayerIds[i] != playerId)
         {
             float visibilty = 0.0f;
             
             for (int j = 0; j < observerCount; ++j)
             {
-                const Unit* observer = engine->sceneSystem.units + observers[j];
-                
-                Vec3 vec = Vec3_Sub(unit->position, observer->position);
+                Vec3 vec = Vec3_Sub(hot->unitPositions[i], observerPoints[j]);
                 float distSq = Vec3_Dot(vec, vec);
-                float rSq = (observer->viewRadius * observer->viewRadius);
                 
-                float power = (rSq) / (distSq * 1.8f);
+                float power = (observerRadiiSq[j]) / (distSq * 1.8f);
                 visibilty += power * power;
             }
             
-            view->unitVisibility[i] = MIN(visibilty, 1.0f);
+            view->unitVisibility[unitIndex] = MIN(visibilty, 1.0f);
         }
         else
         {
-            view->unitVisibility[i] = 1.0f;
+            view->unitVisibility[unitIndex] = 1.0f;
         }
     }
     
-    for (int i = 0; i < SCENE_SYSTEM_PROPS_MAX; ++i)
+    for (int i = 0; i < hot->livePropCount; ++i)
     {
-        const Prop* prop = engine->sceneSystem.props + i;
-        if (prop->dead || prop->inactive) continue;
+        if (hot->propFlags[i] & kSceneHotInactive) continue;
         
         float visibilty = 0.0f;
         
         for (int j = 0; j < observerCount; ++j)
         {
-            const Unit* observer = engine->sceneSystem.units + observers[j];
-            
-            Vec3 vec = Vec3_Sub(prop->position, observer->position);
+            Vec3 vec = Vec3_Sub(hot->propPositions[i], observerPoints[j]);
             float distSq = Vec3_Dot(vec, vec);
-            float rSq = (observer->viewRadius * observer->viewRadius);
             
-            float power = (rSq) / (distSq * 1.8f);
+            float power = (observerRadiiSq[j]) / (distSq * 1.8f);
             visibilty += power * power;
         }
         
-        view->propVisibility[i] = MIN(visibilty, 1.0f);
+        view->propVisibility[hot->liveProps[i]] = MIN(visibilty, 1.0f);
     }
 }
 
 static void Engine_CheckEndGame(Engine* engine)
 {
+    // commands and level loads may have spawned or killed units since the last tick
+    SceneSystem_UpdateHot(&engine->sceneSystem);
+    const SceneHot* hot = &engine->sceneSystem.hot;
+    
     int localUnitCount = 0;
     int otherCount = 0;
     
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+    for (int i = 0; i < hot->liveUnitCount; ++i)
     {
-        const Unit* unit = engine->sceneSystem.units + i;
-        if (unit->dead) continue;
-        
-        if (unit->playerId == ENGINE_PLAYER_LOCAL)
+        if (hot->unitPlayerIds[i] == ENGINE_PLAYER_LOCAL)
         {
             localUnitCount++;
         }
@@ -155,7 +156,7 @@ static void Engine_EndTurn(Engine* engine)
     {
         newPlayer->ourTurn = 1;
         
-        for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+        for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
         {
             Unit* unit = engine->sceneSystem.units + i;
             
@@ -182,7 +183,7 @@ static void Engine_EndTurn(Engine* engine)
     }
     
     {
-        for (int i = 0; i < SCENE_SYSTEM_PROPS_MAX; ++i)
+        for (int i = 0; i < engine->sceneSystem.propCapacity; ++i)
         {
             Prop* prop = engine->sceneSystem.props + i;
             if (prop->dead) continue;
@@ -260,9 +261,12 @@ void Engine_Shutdown(Engine* engine)
     engine->paused = 1;
     
     SndSystem_Shutdown(&engine->soundSystem);
+    NavSystem_Shutdown(&engine->navSystem);
+    SceneSystem_Clear(&engine->sceneSystem);
     Engine_UnloadLevel(engine);
     Engine_UnloadAssets(engine);
-    SceneSystem_Clear(&engine->sceneSystem);
+    SceneSystem_Shutdown(&engine->sceneSystem);
+    FogView_Shutdown(&engine->fogView);
 
     RenderSystem_Shutdown(&engine->renderSystem, engine);
     GuiSystem_Shutdown(&engine->guiSystem);
@@ -284,6 +288,25 @@ void Engine_Resume(Engine* engine)
     engine->paused = 0;
 }
 
+/* units after the same target, such as bats swarming a scientist */
+static int Engine_CountPursuers(const Engine* engine, const Unit* target)
+{
+    int count = 0;
+    
+    SceneHandle handle = SceneSystem_UnitHandle(&engine->sceneSystem, target);
+    
+    for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
+    {
+        const Unit* unit = engine->sceneSystem.units + i;
+        if (unit->dead) continue;
+        
+        if (unit->target.index == handle.index && unit->target.generation == handle.generation)
+            ++count;
+    }
+    
+    return count;
+}
+
 void Engine_RunCommand(Engine* engine, const Command* command)
 {
     //_Engine_TransmitCommand(engine, command);
@@ -312,16 +335,15 @@ void Engine_RunCommand(Engine* engine, const Command* command)
             // find unit at index to avoid const
             Unit* unit = engine->sceneSystem.units + command->unit->index;
             
-            if (command->target != NULL)
-            {
-                unit->target = engine->sceneSystem.units + command->target->index;
-            }
-            else
-            {
-                unit->target = NULL;
-            }
+            Unit_SetTarget(unit, command->target);
+            
+            int pathFlags = kUnitPathFlagNone;
+            
+            // a flow field floods the whole mesh, it only pays off once enough units converge on one target
+            if (command->target && Engine_CountPursuers(engine, command->target) >= ENGINE_SHARED_PATH_UNITS)
+                pathFlags |= kUnitPathFlagShared;
             
-            Unit_StartPath(unit, command->position);
+            Unit_StartPath(unit, command->position, pathFlags);
             break;
         }
         case kCommandTypeAttackPrimary:
@@ -385,9 +407,98 @@ static void Engine_TickFrustum(Engine* engine)
     Frustum_UpdateTransform(&engine->renderSystem.cam, viewportWidth, viewportHeight);
 }
 
+/* units block the poly they stand on, healer eggs and mines the polys they cover,
+   so paths go around them. Units use obstacle ids matching their index, props follow the units. */
+static void Engine_TickObstacles(Engine* engine)
+{
+    NavMesh* mesh = &engine->navSystem.navMesh;
+    
+    for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
+    {
+        const Unit* unit = engine->sceneSystem.units + i;
+        
+        if (unit->dead)
+            NavMesh_ClearObstacle(mesh, i);
+        else
+            NavMesh_SetObstacle(mesh, i, unit->navPoly, unit->position, 0.0f);
+    }
+    
+    for (int i = 0; i < engine->sceneSystem.propCapacity; ++i)
+    {
+        const Prop* prop = engine->sceneSystem.props + i;
+        int id = engine->sceneSystem.unitCapacity + i;
+        
+        if (prop->dead || prop->inactive || (prop->type != kPropEggHealer && prop->type != kPropEyeMine))
+        {
+            NavMesh_ClearObstacle(mesh, id);
+            continue;
+        }
+        
+        Vec3 size = Vec3_Sub(prop->bounds.max, prop->bounds.min);
+        NavMesh_SetObstacle(mesh, id, prop->navPoly, prop->position, MAX(size.x, size.y) * 0.5f);
+    }
+}
+
+/* steers moving units around each other for this tick's step along their paths.
+   Units standing still are in the solve too, the moving units go around them. */
+static void Engine_TickAvoidance(Engine* engine)
+{
+    NavAvoidance* avoidance = &engine->navSystem.avoidance;
+    NavAvoidance_Clear(avoidance);
+    
+    int movingCount = 0;
+    
+    for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
+    {
+        Unit* unit = engine->sceneSystem.units + i;
+        if (unit->dead) continue;
+        
+        Vec2 preferredVelocity = Vec2_Zero;
+        int moving = unit->state == kUnitStateMove && Unit_PathVelocity(unit, &preferredVelocity);
+        
+        NavAvoidance_AddAgent(avoidance,
+                              Vec2_FromVec3(unit->position),
+                              moving ? unit->velocity : Vec2_Zero,
+                              preferredVelocity,
+                              unit->radius * ENGINE_AVOID_RADIUS_SCALE,
+                              moving ? unit->speed : 0.0f);
+        
+        // only moving units take the solved velocity, the rest are left out when nothing moves
+        unit->avoiding = moving;
+        movingCount += moving;
+    }
+    
+    if (movingCount == 0)
+        return;
+    
+    NavAvoidance_Solve(avoidance);
+    
+    // agents were added in unit order
+    int agent = 0;
+    
+    for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
+    {
+        Unit* unit = engine->sceneSystem.units + i;
+        if (unit->dead) continue;
+        
+        if (unit->avoiding)
+            unit->avoidVelocity = avoidance->agents[agent].newVelocity;
+        
+        ++agent;
+    }
+}
+
 static void Engine_TickUnits(Engine* engine)
 {
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+    // props only move in their own ticks, this catches any moved elsewhere
+    SceneSystem_UpdateTouches(&engine->sceneSystem);
+    
+    Engine_TickObstacles(engine);
+    Engine_TickAvoidance(engine);
+    
+    const int* touches = NULL;
+    
+    for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
     {
         Unit* unit = engine->sceneSystem.units + i;
         if (unit->dead) continue;
@@ -395,7 +506,7 @@ static void Engine_TickUnits(Engine* engine)
         // alerted for AI
         if (!unit->isAlerted)
         {
-            for (int j = 0; j < SCENE_SYSTEM_UNITS_MAX; ++j)
+            for (int j = 0; j < engine->sceneSystem.unitCapacity; ++j)
             {
                 const Unit* other = engine->sceneSystem.units + j;
                 if (other->dead || other->playerId == unit->playerId) continue;
@@ -405,10 +516,13 @@ static void Engine_TickUnits(Engine* engine)
             }
         }
     
+        if (unit->state == kUnitStatePlanPath)
+            Unit_PlanPath(unit);
+        
         if (unit->onTick)
             unit->onTick(unit);
         
-        unit->skelModel.skel.rotation = Quat_CreateAngle(unit->angle, 0.0f, 0.0f, 1.0f);
+        unit->skelModel.pose.rotation = Quat_CreateAngle(unit->angle, 0.0f, 0.0f, 1.0f);
         
         float radians = DEG_TO_RAD(unit->angle);
         unit->forward = Vec3_Create(cosf(radians), sinf(radians), 0.0f);
@@ -416,9 +530,11 @@ static void Engine_TickUnits(Engine* engine)
         // touching
         unit->actionProp = NULL;
         
-        for (int j = 0; j < SCENE_SYSTEM_PROPS_MAX; ++j)
+        int touchCount = SceneSystem_TouchCandidates(&engine->sceneSystem, unit->bounds, 0, &touches);
+        
+        for (int j = 0; j < touchCount; ++j)
         {
-            Prop* prop = engine->sceneSystem.props + j;
+            Prop* prop = engine->sceneSystem.props + touches[j];
             if (prop->dead || prop->inactive) continue;
             
             if (AABB_IntersectsAABB(unit->bounds, prop->bounds))
@@ -432,11 +548,12 @@ static void Engine_TickUnits(Engine* engine)
         }
         
         
-        // Raycast from unit loctation to determine which nav polygon the unit is on
-        Ray3 ray = Ray3_Create(Vec3_Add(unit->position, Vec3_Create(0.0f, 0.0f, 2.0f)), Vec3_Create(0.0f, 0.0f, -1.0f));
+        // Cast down from unit loctation to determine which nav polygon the unit is on.
+        // Usually this is the poly from the last tick, or one of its neighbors.
+        Vec3 castPoint = Vec3_Add(unit->position, Vec3_Create(0.0f, 0.0f, 2.0f));
         
         NavRaycastResult hitInfo;
-        if (NavSystem_Raycast(&engine->navSystem, ray, &hitInfo))
+        if (NavSystem_LocatePoint(&engine->navSystem, unit->navPoly, castPoint, &hitInfo))
         {
             unit->position.z = hitInfo.point.z;
             unit->navPoly = hitInfo.poly;
@@ -474,7 +591,7 @@ static void Engine_TickUnits(Engine* engine)
         
         if (BUILD_DEBUG)
         {
-            Hintbuffer_PackSkel(&engine->renderSystem.hintBuffer, &unit->skelModel.skel, unit->position, Vec3_Create(1.0f, 1.0f, 0.0f),  Vec3_Create(1.0f, 0.0f, 0.0f));
+            Hintbuffer_PackSkel(&engine->renderSystem.hintBuffer, &unit->skelModel.pose, unit->position, Vec3_Create(1.0f, 1.0f, 0.0f),  Vec3_Create(1.0f, 0.0f, 0.0f));
             HintBuffer_PackAABB(&engine->renderSystem.hintBuffer, unit->bounds, Vec3_Create(0.5f, 0.5f, 0.5f));
         }
     }
@@ -482,7 +599,9 @@ static void Engine_TickUnits(Engine* engine)
 
 static void Engine_TickProps(Engine* engine)
 {
-    for (int i = 0; i < SCENE_SYSTEM_PROPS_MAX; ++i)
+    const int* touches = NULL;
+    
+    for (int i = 0; i < engine->sceneSystem.propCapacity; ++i)
     {
         Prop* prop = engine->sceneSystem.props + i;
         if (prop->dead || prop->inactive) continue;
@@ -497,9 +616,14 @@ static void Engine_TickProps(Engine* engine)
         Quat_ToMatrix(prop->rotation, &rot);
         Mat4_Mult(&translate, &rot, &prop->worldMatrix);
         
-        for (int j = i + 1; j < SCENE_SYSTEM_PROPS_MAX; ++j)
+        SceneSystem_UpdateTouch(&engine->sceneSystem, prop);
+        
+        // each pair once, props after this one have not moved yet this tick
+        int touchCount = SceneSystem_TouchCandidates(&engine->sceneSystem, prop->bounds, i + 1, &touches);
+        
+        for (int j = 0; j < touchCount; ++j)
         {
-            Prop* other = engine->sceneSystem.props + j;
+            Prop* other = engine->sceneSystem.props + touches[j];
             if (other->dead || other->inactive) continue;
             
             if (AABB_IntersectsAABB(prop->bounds, other->bounds))
@@ -779,7 +903,11 @@ EngineState Engine_Tick(Engine* engine, const InputState* newState)
         engine->state = kEngineStateIdle;
     }
     
+    // units and props are done changing for the tick, for the fog view and culling
+    SceneSystem_UpdateHot(&engine->sceneSystem);
+    
     Engine_BuildFogView(engine, ENGINE_PLAYER_LOCAL, &engine->fogView);
+    NavSystem_EndTick(&engine->navSystem);
     
     return engine->state;
 }
@@ -71,6 +71,8 @@ void Engine_UnloadAssets(Engine* engine)
         }
     }
     
+    SkelPosePool_Shutdown(&engine->sceneSystem.unitPoses);
+    
     for (int i = 0; i < Asset_skelAnimCount; ++i)
     {
         const AssetEntry* entry = Asset_skelAnimManifest + i;
@@ -129,6 +131,18 @@ void Engine_LoadAssets(Engine* engine)
         }
     }
     
+    // every unit slot gets a pose big enough for any skeleton
+    int maxJoints = 0;
+    for (i = 0; i < Asset_skelModelCount; ++i)
+    {
+        const AssetEntry* entry = Asset_skelModelManifest + i;
+        
+        if (entry->path)
+            maxJoints = MAX(maxJoints, gl->skelModels[entry->identifier].skel.jointCount);
+    }
+    
+    SkelPosePool_Init(&engine->sceneSystem.unitPoses, engine->sceneSystem.unitCapacity, maxJoints);
+    
     for (i = 0; i < Asset_skelAnimCount; ++i)
     {
         const AssetEntry* entry = Asset_skelAnimManifest + i;
@@ -20,7 +20,7 @@ static void Scientist_OnTick(Unit* unit)
 {
     unit->bounds = AABB_CreateAnchored(unit->position, Vec3_Create(3.0f, 3.0f, 6.5), Vec3_Create(0.5f, 0.5f, 0.0f));
     
-    const SkelAttachPoint* point = SkelModel_AttachPointAt(&unit->skelModel, 0);
+    const SkelAttachPose* point = SkelModelInstance_AttachPointAt(&unit->skelModel, 0);
     unit->weaponProp->position = Vec3_Add(unit->position, point->modelPosition);
     unit->weaponProp->rotation = point->modelRotation;
     
@@ -62,26 +62,25 @@ static void Scientist_OnTick(Unit* unit)
                     // idle is always in primary weapon
                     
                     int weaponModel = engine->weaponTable[unit->primaryWeapon].model;
-                    StaticModel_Shutdown(&unit->weaponProp->model);
-                    StaticModel_Copy(&unit->weaponProp->model, engine->renderSystem.models + weaponModel);
+                    StaticModelInstance_Set(&unit->weaponProp->model, engine->renderSystem.models + weaponModel);
                     unit->weaponProp->model.material.diffuseMap = engine->weaponTable[unit->primaryWeapon].texture;
                 }
             }
             
-            SkelModel_Tick(&unit->skelModel);
+            SkelModelInstance_Tick(&unit->skelModel);
             break;
         }
         case kUnitStateDead:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator, engine->renderSystem.anims + dieAnim, 0, 3);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             if (frameInfo.finishedAnim) Unit_Kill(unit);
             break;
         }
         case kUnitStateHurt:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[hurtAnim], 0, 3);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             if (frameInfo.finishedAnim) unit->state = kUnitStateIdle;
             break;
         }
@@ -91,7 +90,7 @@ static void Scientist_OnTick(Unit* unit)
                 unit->state = kUnitStateIdle;
             
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[walkAnim], 0, 6);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
 
             if (frameInfo.marker != NULL)
             {
@@ -156,18 +155,17 @@ static void Scientist_OnTick(Unit* unit)
                 
                 
                 SkelAnimator_SetAnim(&unit->skelModel.animator, engine->renderSystem.anims + walkAnim, 0, 6);
-                SkelModel_Tick(&unit->skelModel);
+                SkelModelInstance_Tick(&unit->skelModel);
             }
             else
             {
                 SkelAnimator_SetAnim(&unit->skelModel.animator, engine->renderSystem.anims + weaponAnim, 0, 6);
                 
-                SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+                SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
 
                 if (frameInfo.finishedTransition && unit->weaponProp)
                 {
-                    StaticModel_Shutdown(&unit->weaponProp->model);
-                    StaticModel_Copy(&unit->weaponProp->model, engine->renderSystem.models + weapon->model);
+                    StaticModelInstance_Set(&unit->weaponProp->model, engine->renderSystem.models + weapon->model);
                     unit->weaponProp->model.material.diffuseMap = weapon->texture;
                 }
                 
@@ -189,7 +187,7 @@ static void Scientist_OnTick(Unit* unit)
                         Quat rotation = Quat_CreateLook(direction, Vec3_Create(1.0f, 0.0f, 0.0f));
                         
                         Prop* projectile = SceneSystem_SpawnPropAt(&engine->sceneSystem, weapon->projectilePropType, emitPoint, rotation, 0);
-                        projectile->owner = unit;
+                        Prop_SetOwner(projectile, unit);
                         projectile->hp = weapon->damage;
                         
                         if (rand() % weapon->critChance == 1)
@@ -202,7 +200,7 @@ static void Scientist_OnTick(Unit* unit)
                         Vec3 p = Vec3_Add(unit->weaponProp->position, Quat_MultVec3(&unit->weaponProp->rotation, weapon->projectileOffset));
                         
                         Prop* projectile = SceneSystem_SpawnPropAt(&engine->sceneSystem, weapon->projectilePropType, p, unit->weaponProp->rotation, 0);
-                        projectile->owner = unit;
+                        Prop_SetOwner(projectile, unit);
                         projectile->hp = weapon->damage;
                     }
                 }
@@ -348,9 +346,11 @@ static void Scientist_OnDamage(struct Unit* unit,
         }
     }
     
-    if (prop->owner)
+    const Unit* owner = Prop_Owner(prop);
+    
+    if (owner)
     {
-        Vec2 ownerPoint2D = Vec2_FromVec3(prop->owner->position);
+        Vec2 ownerPoint2D = Vec2_FromVec3(owner->position);
         float angleToOwner = RAD_TO_DEG(atan2f(ownerPoint2D.y - unit->position.y, ownerPoint2D.x - unit->position.x));
         unit->targetAngle = angleToOwner;
     }
@@ -385,16 +385,16 @@ static void Scientist_OnSpawn(Unit* unit, int flags)
     unit->secondaryWeapon = kWeaponAxe;
     unit->viewRadius = 50;
     
-    SkelModel_Copy(&unit->skelModel, &engine->renderSystem.skelModels[SKEL_SCIENTIST]);
+    SkelModelInstance_Set(&unit->skelModel, engine->renderSystem.skelModels + SKEL_SCIENTIST, &engine->sceneSystem.unitPoses, unit->index);
     unit->skelModel.material.diffuseMap = TEX_SCIENTIST;
     
     unit->weaponProp = SceneSystem_SpawnProp(&engine->sceneSystem, kPropWeapon);
     
     int weaponModel = engine->weaponTable[unit->primaryWeapon].model;
-    StaticModel_Copy(&unit->weaponProp->model, engine->renderSystem.models + weaponModel);
+    StaticModelInstance_Set(&unit->weaponProp->model, engine->renderSystem.models + weaponModel);
     unit->weaponProp->model.material.diffuseMap = engine->weaponTable[unit->primaryWeapon].texture;
     
-    unit->skelModel.attachPointTable[0] = Skel_FindAttachPointIndex(&unit->skelModel.skel, "attach_r_hand");
+    unit->skelModel.attachPointTable[0] = Skel_FindAttachPointIndex(&unit->skelModel.shared->skel, "attach_r_hand");
 }
 
 static void Phantom_OnSelect(Unit* unit)
@@ -466,21 +466,21 @@ static void Phantom_OnTick(Unit* unit)
                 
             }
             
-            SkelModel_Tick(&unit->skelModel);
+            SkelModelInstance_Tick(&unit->skelModel);
             break;
         }
         case kUnitStateDead:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[dieAnim], 0, 3);
             
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             if (frameInfo.finishedAnim) Unit_Kill(unit);
             break;
         }
         case kUnitStateHurt:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[hurtAnim], 0, 6);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             if (frameInfo.finishedAnim) unit->state = kUnitStateIdle;
             break;
         }
@@ -488,7 +488,7 @@ static void Phantom_OnTick(Unit* unit)
         {
             if (!Unit_FollowPath(unit)) unit->state = kUnitStateIdle;
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[walkAnim], 0, 6);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             
             if (frameInfo.marker != NULL)
             {
@@ -520,12 +520,12 @@ static void Phantom_OnTick(Unit* unit)
                 unit->angle = Deg_Normalize(unit->angle + angleDiff);
                 
                 SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[walkAnim], 0, 6);
-                SkelModel_Tick(&unit->skelModel);
+                SkelModelInstance_Tick(&unit->skelModel);
             }
             else
             {
                 SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[attackAnim], 0, 6);
-                SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+                SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
 
                 if (frameInfo.finishedAnim)
                 {
@@ -534,12 +534,12 @@ static void Phantom_OnTick(Unit* unit)
                 }
                 else if (frameInfo.marker != NULL)
                 {
-                    const SkelAttachPoint* attachPoint = SkelModel_AttachPointAt(&unit->skelModel, 0);
+                    const SkelAttachPose* attachPoint = SkelModelInstance_AttachPointAt(&unit->skelModel, 0);
                     
                     Vec3 emitPoint = Vec3_Add(attachPoint->modelPosition, unit->position);
                     
                     Prop* projectile = SceneSystem_SpawnPropAt(&engine->sceneSystem, weapon->projectilePropType, emitPoint, attachPoint->modelRotation, 0);
-                    projectile->owner = unit;
+                    Prop_SetOwner(projectile, unit);
                     projectile->hp = weapon->damage;
                 }
             }
@@ -660,7 +660,8 @@ static void Phantom_OnDamage(struct Unit* unit,
         {
             unit->isAlerted = 1;
             
-            int ownersUnitCount = engine->players[prop->owner->playerId]->unitCount;
+            const Unit* owner = Prop_Owner(prop);
+            int ownersUnitCount = owner ? engine->players[owner->playerId]->unitCount : OBSERVERS_MAX;
             int diceRoll = (rand() % 2 == 1);
             
             if (diceRoll && ownersUnitCount < OBSERVERS_MAX)
@@ -668,7 +669,7 @@ static void Phantom_OnDamage(struct Unit* unit,
                 PartSystem_EmitEffect(&engine->partSystem, kPartEffectMindControl, unit->position, Quat_Identity, 0);
                 SndSystem_PlaySound(&engine->soundSystem, SND_MIND_CONTROL);
 
-                unit->playerId = prop->owner->playerId;
+                unit->playerId = owner->playerId;
                 ++engine->players[unit->playerId]->unitCount;
             }
             else
@@ -697,9 +698,11 @@ static void Phantom_OnDamage(struct Unit* unit,
             break;
     }
     
-    if (prop && prop->owner)
+    const Unit* owner = prop ? Prop_Owner(prop) : NULL;
+    
+    if (owner)
     {
-        Vec2 ownerPoint2D = Vec2_FromVec3(prop->owner->position);
+        Vec2 ownerPoint2D = Vec2_FromVec3(owner->position);
         float angleToOwner = RAD_TO_DEG(atan2f(ownerPoint2D.y - unit->position.y, ownerPoint2D.x - unit->position.x));
         unit->targetAngle = angleToOwner;
     }
@@ -733,10 +736,10 @@ static void Phantom_OnSpawn(Unit* unit, int flags)
     
     unit->weaponProp = SceneSystem_SpawnProp(&engine->sceneSystem, kPropWeapon);
 
-    SkelModel_Copy(&unit->skelModel, &engine->renderSystem.skelModels[SKEL_PHANTOM]);
+    SkelModelInstance_Set(&unit->skelModel, engine->renderSystem.skelModels + SKEL_PHANTOM, &engine->sceneSystem.unitPoses, unit->index);
     unit->skelModel.material.diffuseMap = TEX_PHANTOM;
     
-    unit->skelModel.attachPointTable[0] = Skel_FindAttachPointIndex(&unit->skelModel.skel, "attach_hand");
+    unit->skelModel.attachPointTable[0] = Skel_FindAttachPointIndex(&unit->skelModel.shared->skel, "attach_hand");
 }
 
 static void Bat_OnSelect(Unit* unit)
@@ -808,21 +811,21 @@ static void Bat_OnTick(Unit* unit)
                 SkelAnimator_SetAnim(&unit->skelModel.animator, idleSkelAnim, startFrame, 12);
             }
             
-            SkelModel_Tick(&unit->skelModel);
+            SkelModelInstance_Tick(&unit->skelModel);
             
             break;
         }
         case kUnitStateDead:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[dieAnim], 0, 6);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             if (frameInfo.finishedAnim) Unit_Kill(unit);
             break;
         }
         case kUnitStateHurt:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[hurtAnim], 0, 3);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             if (frameInfo.finishedAnim) unit->state = kUnitStateIdle;
             break;
         }
@@ -830,7 +833,7 @@ static void Bat_OnTick(Unit* unit)
         {
             if (!Unit_FollowPath(unit)) unit->state = kUnitStateIdle;
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[walkAnim], 0, 6);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
 
             if (frameInfo.marker != NULL)
             {
@@ -863,13 +866,13 @@ static void Bat_OnTick(Unit* unit)
                 unit->angle = Deg_Normalize(unit->angle + angleDiff);
                 
                 SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[walkAnim], 0, 6);
-                SkelModel_Tick(&unit->skelModel);
+                SkelModelInstance_Tick(&unit->skelModel);
             }
             else
             {
                 
                 SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[attackAnim], 0, 6);
-                SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+                SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
 
                 if (frameInfo.finishedAnim)
                 {
@@ -879,17 +882,17 @@ static void Bat_OnTick(Unit* unit)
                 else if (frameInfo.marker != NULL)
                 {
                     // Bat uses a two handed attack, the attach point depends on the frame of animation
-                    const SkelAttachPoint* attachPoint = SkelModel_AttachPointAt(&unit->skelModel, 1);
+                    const SkelAttachPose* attachPoint = SkelModelInstance_AttachPointAt(&unit->skelModel, 1);
                     
                     if (strcmp(frameInfo.marker->name, "attack2"))
                     {
-                        attachPoint = SkelModel_AttachPointAt(&unit->skelModel, 0);
+                        attachPoint = SkelModelInstance_AttachPointAt(&unit->skelModel, 0);
                     }
                     
                     Vec3 emitPoint = Vec3_Add(attachPoint->modelPosition, unit->position);
                     
                     Prop* projectile = SceneSystem_SpawnPropAt(&engine->sceneSystem, weapon->projectilePropType, emitPoint, attachPoint->modelRotation, 0);
-                    projectile->owner = unit;
+                    Prop_SetOwner(projectile, unit);
                     projectile->hp = weapon->damage;
                 }
             }
@@ -987,7 +990,8 @@ static void Bat_OnDamage(struct Unit* unit,
         {
             unit->isAlerted = 1;
             
-            int ownersUnitCount = engine->players[prop->owner->playerId]->unitCount;
+            const Unit* owner = Prop_Owner(prop);
+            int ownersUnitCount = owner ? engine->players[owner->playerId]->unitCount : OBSERVERS_MAX;
             int diceRoll = (rand() % 3 != 1);
             
             if (diceRoll && ownersUnitCount < OBSERVERS_MAX)
@@ -995,7 +999,7 @@ static void Bat_OnDamage(struct Unit* unit,
                 PartSystem_EmitEffect(&engine->partSystem, kPartEffectMindControl, unit->position, Quat_Identity, 0);
                 SndSystem_PlaySound(&engine->soundSystem, SND_MIND_CONTROL);
                 
-                unit->playerId = prop->owner->playerId;
+                unit->playerId = owner->playerId;
                 ++engine->players[unit->playerId]->unitCount;
             }
             else
@@ -1028,9 +1032,11 @@ static void Bat_OnDamage(struct Unit* unit,
             break;
     }
     
-    if (prop && prop->owner)
+    const Unit* owner = prop ? Prop_Owner(prop) : NULL;
+    
+    if (owner)
     {
-        Vec2 ownerPoint2D = Vec2_FromVec3(prop->owner->position);
+        Vec2 ownerPoint2D = Vec2_FromVec3(owner->position);
         float angleToOwner = RAD_TO_DEG(atan2f(ownerPoint2D.y - unit->position.y, ownerPoint2D.x - unit->position.x));
         unit->targetAngle = angleToOwner;
     }
@@ -1061,11 +1067,11 @@ static void Bat_OnSpawn(Unit* unit, int flags)
     
     unit->weaponProp = SceneSystem_SpawnProp(&engine->sceneSystem, kPropWeapon);
 
-    SkelModel_Copy(&unit->skelModel, &engine->renderSystem.skelModels[SKEL_BAT]);
+    SkelModelInstance_Set(&unit->skelModel, engine->renderSystem.skelModels + SKEL_BAT, &engine->sceneSystem.unitPoses, unit->index);
     unit->skelModel.material.diffuseMap = TEX_BAT;
 
-    unit->skelModel.attachPointTable[0] = Skel_FindAttachPointIndex(&unit->skelModel.skel, "r_hand");
-    unit->skelModel.attachPointTable[1] = Skel_FindAttachPointIndex(&unit->skelModel.skel, "l_hand");
+    unit->skelModel.attachPointTable[0] = Skel_FindAttachPointIndex(&unit->skelModel.shared->skel, "r_hand");
+    unit->skelModel.attachPointTable[1] = Skel_FindAttachPointIndex(&unit->skelModel.shared->skel, "l_hand");
 }
 
 static void Vamp_OnDamage(struct Unit* unit,
@@ -1150,7 +1156,8 @@ static void Vamp_OnDamage(struct Unit* unit,
         {
             unit->isAlerted = 1;
             
-            int ownersUnitCount = engine->players[prop->owner->playerId]->unitCount;
+            const Unit* owner = Prop_Owner(prop);
+            int ownersUnitCount = owner ? engine->players[owner->playerId]->unitCount : OBSERVERS_MAX;
             int diceRoll = (rand() % 3 != 1);
 
             if (diceRoll && ownersUnitCount < OBSERVERS_MAX)
@@ -1158,7 +1165,7 @@ static void Vamp_OnDamage(struct Unit* unit,
                 PartSystem_EmitEffect(&engine->partSystem, kPartEffectMindControl, unit->position, Quat_Identity, 0);
                 SndSystem_PlaySound(&engine->soundSystem, SND_MIND_CONTROL);
                 
-                unit->playerId = prop->owner->playerId;
+                unit->playerId = owner->playerId;
                 ++engine->players[unit->playerId]->unitCount;
             }
             else
@@ -1192,9 +1199,11 @@ static void Vamp_OnDamage(struct Unit* unit,
         }
     }
     
-    if (prop && prop->owner)
+    const Unit* owner = prop ? Prop_Owner(prop) : NULL;
+    
+    if (owner)
     {
-        Vec2 ownerPoint2D = Vec2_FromVec3(prop->owner->position);
+        Vec2 ownerPoint2D = Vec2_FromVec3(owner->position);
         float angleToOwner = RAD_TO_DEG(atan2f(ownerPoint2D.y - unit->position.y, ownerPoint2D.x - unit->position.x));
         unit->targetAngle = angleToOwner;
     }
@@ -1244,21 +1253,21 @@ static void Vamp_OnTick(Unit* unit)
                 SkelAnimator_SetAnim(&unit->skelModel.animator, idleSkelAnim, startFrame, 12);
             }
             
-            SkelModel_Tick(&unit->skelModel);
+            SkelModelInstance_Tick(&unit->skelModel);
 
             break;
         }
         case kUnitStateDead:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[dieAnim], 0, 4);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             if (frameInfo.finishedAnim) Unit_Kill(unit);
             break;
         }
         case kUnitStateHurt:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[hurtAnim], 0, 3);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             if (frameInfo.finishedAnim) unit->state = kUnitStateIdle;
             break;
         }
@@ -1266,7 +1275,7 @@ static void Vamp_OnTick(Unit* unit)
         {
             if (!Unit_FollowPath(unit)) unit->state = kUnitStateIdle;
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[walkAnim], 0, 6);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             
             if (frameInfo.marker != NULL)
             {
@@ -1298,12 +1307,12 @@ static void Vamp_OnTick(Unit* unit)
                 unit->angle = Deg_Normalize(unit->angle + angleDiff);
                 
                 SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[walkAnim], 0, 6);
-                SkelModel_Tick(&unit->skelModel);
+                SkelModelInstance_Tick(&unit->skelModel);
             }
             else
             {
                 SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[attackAnim], 0, 6);
-                SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+                SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
 
                 if (frameInfo.finishedAnim)
                 {
@@ -1312,7 +1321,7 @@ static void Vamp_OnTick(Unit* unit)
                 }
                 else if (frameInfo.marker != NULL)
                 {
-                    const SkelAttachPoint* attachPoint = SkelModel_AttachPointAt(&unit->skelModel, 0);
+                    const SkelAttachPose* attachPoint = SkelModelInstance_AttachPointAt(&unit->skelModel, 0);
                     
                     Vec3 emitPoint = Vec3_Add(attachPoint->modelPosition, Quat_MultVec3(&attachPoint->modelRotation, weapon->projectileOffset));
                     emitPoint = Vec3_Add(emitPoint, unit->position);
@@ -1324,7 +1333,7 @@ static void Vamp_OnTick(Unit* unit)
                     Quat rotation = Quat_CreateLook(direction, Vec3_Create(1.0f, 0.0f, 0.0f));
                     
                     Prop* projectile = SceneSystem_SpawnPropAt(&engine->sceneSystem, weapon->projectilePropType, emitPoint, rotation, 0);
-                    projectile->owner = unit;
+                    Prop_SetOwner(projectile, unit);
                     projectile->hp = weapon->damage;
                     
                     if (rand() % weapon->critChance == 1)
@@ -1360,11 +1369,11 @@ static void Vamp_OnSpawn(Unit* unit, int flags)
     
     unit->speed = 0.2f;
         
-    SkelModel_Copy(&unit->skelModel, &engine->renderSystem.skelModels[SKEL_BAT]);
+    SkelModelInstance_Set(&unit->skelModel, engine->renderSystem.skelModels + SKEL_BAT, &engine->sceneSystem.unitPoses, unit->index);
     unit->skelModel.material.diffuseMap = TEX_VAMP;
     
-    unit->skelModel.attachPointTable[0] = Skel_FindAttachPointIndex(&unit->skelModel.skel, "r_hand");
-    unit->skelModel.attachPointTable[1] = Skel_FindAttachPointIndex(&unit->skelModel.skel, "l_hand");
+    unit->skelModel.attachPointTable[0] = Skel_FindAttachPointIndex(&unit->skelModel.shared->skel, "r_hand");
+    unit->skelModel.attachPointTable[1] = Skel_FindAttachPointIndex(&unit->skelModel.shared->skel, "l_hand");
 }
 
 static void Wolf_OnSelect(Unit* unit)
@@ -1485,7 +1494,8 @@ static void Wolf_OnDamage(struct Unit* unit,
         {
             unit->isAlerted = 1;
             
-            int ownersUnitCount = engine->players[prop->owner->playerId]->unitCount;
+            const Unit* owner = Prop_Owner(prop);
+            int ownersUnitCount = owner ? engine->players[owner->playerId]->unitCount : OBSERVERS_MAX;
             int diceRoll = (rand() % 3 == 1);
             
             if (diceRoll && ownersUnitCount < OBSERVERS_MAX)
@@ -1493,7 +1503,7 @@ static void Wolf_OnDamage(struct Unit* unit,
                 PartSystem_EmitEffect(&engine->partSystem, kPartEffectMindControl, unit->position, Quat_Identity, 0);
                 SndSystem_PlaySound(&engine->soundSystem, SND_MIND_CONTROL);
                 
-                unit->playerId = prop->owner->playerId;
+                unit->playerId = owner->playerId;
                 ++engine->players[unit->playerId]->unitCount;
             }
             else
@@ -1522,9 +1532,11 @@ static void Wolf_OnDamage(struct Unit* unit,
             break;
     }
     
-    if (prop && prop->owner)
+    const Unit* owner = prop ? Prop_Owner(prop) : NULL;
+    
+    if (owner)
     {
-        Vec2 ownerPoint2D = Vec2_FromVec3(prop->owner->position);
+        Vec2 ownerPoint2D = Vec2_FromVec3(owner->position);
         float angleToOwner = RAD_TO_DEG(atan2f(ownerPoint2D.y - unit->position.y, ownerPoint2D.x - unit->position.x));
         unit->targetAngle = angleToOwner;
     }
@@ -1567,20 +1579,20 @@ static void Wolf_OnTick(Unit* unit)
                 SkelAnimator_SetAnim(&unit->skelModel.animator, idleSkelAnim, startFrame, 12);
             }
             
-            SkelModel_Tick(&unit->skelModel);
+            SkelModelInstance_Tick(&unit->skelModel);
             break;
         }
         case kUnitStateDead:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[dieAnim], 0, 3);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             if (frameInfo.finishedAnim) Unit_Kill(unit);
             break;
         }
         case kUnitStateHurt:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[hurtAnim], 0, 3);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             if (frameInfo.finishedAnim) unit->state = kUnitStateIdle;
             break;
         }
@@ -1588,7 +1600,7 @@ static void Wolf_OnTick(Unit* unit)
         {
             if (!Unit_FollowPath(unit)) unit->state = kUnitStateIdle;
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[walkAnim], 0, 6);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             
             if (frameInfo.marker != NULL)
             {
@@ -1620,12 +1632,12 @@ static void Wolf_OnTick(Unit* unit)
                 unit->angle = Deg_Normalize(unit->angle + angleDiff);
                 
                 SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[walkAnim], 0, 6);
-                SkelModel_Tick(&unit->skelModel);
+                SkelModelInstance_Tick(&unit->skelModel);
             }
             else
             {
                 SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[attackAnim], 0, 6);
-                SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+                SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
 
                 if (frameInfo.finishedAnim)
                 {
@@ -1634,12 +1646,12 @@ static void Wolf_OnTick(Unit* unit)
                 }
                 else if (frameInfo.marker != NULL)
                 {
-                    const SkelAttachPoint* attachPoint = SkelModel_AttachPointAt(&unit->skelModel, 0);
+                    const SkelAttachPose* attachPoint = SkelModelInstance_AttachPointAt(&unit->skelModel, 0);
                     
                     Vec3 emitPoint = Vec3_Add(attachPoint->modelPosition, unit->position);
                     
                     Prop* projectile = SceneSystem_SpawnPropAt(&engine->sceneSystem, weapon->projectilePropType, emitPoint, attachPoint->modelRotation, 0);
-                    projectile->owner = unit;
+                    Prop_SetOwner(projectile, unit);
                     projectile->hp = weapon->damage;
                     
                     SndSystem_PlaySound(&unit->engine->soundSystem, (rand() % 2 == 0) ? SND_WOLF_ATTACK1 : SND_WOLF_ATTACK2);
@@ -1677,10 +1689,10 @@ static void Wolf_OnSpawn(Unit* unit, int flags)
     
     unit->speed = 0.23f;
     
-    SkelModel_Copy(&unit->skelModel, &engine->renderSystem.skelModels[SKEL_WOLF]);
+    SkelModelInstance_Set(&unit->skelModel, engine->renderSystem.skelModels + SKEL_WOLF, &engine->sceneSystem.unitPoses, unit->index);
     unit->skelModel.material.diffuseMap = TEX_WOLF;
     
-    unit->skelModel.attachPointTable[0] = Skel_FindAttachPointIndex(&unit->skelModel.skel, "attach_head");
+    unit->skelModel.attachPointTable[0] = Skel_FindAttachPointIndex(&unit->skelModel.shared->skel, "attach_head");
 }
 
 static void Boss_OnStartPath(Unit* unit)
@@ -1804,9 +1816,11 @@ static void Boss_OnDamage(struct Unit* unit,
             break;
     }
     
-    if (prop && prop->owner)
+    const Unit* owner = prop ? Prop_Owner(prop) : NULL;
+    
+    if (owner)
     {
-        Vec2 ownerPoint2D = Vec2_FromVec3(prop->owner->position);
+        Vec2 ownerPoint2D = Vec2_FromVec3(owner->position);
         float angleToOwner = RAD_TO_DEG(atan2f(ownerPoint2D.y - unit->position.y, ownerPoint2D.x - unit->position.x));
         unit->targetAngle = angleToOwner;
     }
@@ -1858,20 +1872,20 @@ static void Boss_OnTick(Unit* unit)
                 SkelAnimator_SetAnim(&unit->skelModel.animator, idleSkelAnim, startFrame, 12);
             }
             
-            SkelModel_Tick(&unit->skelModel);
+            SkelModelInstance_Tick(&unit->skelModel);
             break;
         }
         case kUnitStateDead:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[dieAnim], 0, 3);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             if (frameInfo.finishedAnim) Unit_Kill(unit);
             break;
         }
         case kUnitStateHurt:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[hurtAnim], 0, 3);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
             if (frameInfo.finishedAnim) unit->state = kUnitStateIdle;
             break;
         }
@@ -1879,13 +1893,13 @@ static void Boss_OnTick(Unit* unit)
         {
             if (!Unit_FollowPath(unit)) unit->state = kUnitStateIdle;
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[walkAnim], 0, 6);
-            SkelModel_Tick(&unit->skelModel);
+            SkelModelInstance_Tick(&unit->skelModel);
             break;
         }
         case kUnitStateTeleport:
         {
             SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[teleportAnim], 0, 6);
-            SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+            SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
 
             if (frameInfo.marker != NULL)
             {
@@ -1920,12 +1934,12 @@ static void Boss_OnTick(Unit* unit)
                 unit->angle = Deg_Normalize(unit->angle + angleDiff);
                 
                 SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[walkAnim], 0, 6);
-                SkelModel_Tick(&unit->skelModel);
+                SkelModelInstance_Tick(&unit->skelModel);
             }
             else
             {
                 SkelAnimator_SetAnim(&unit->skelModel.animator,  &engine->renderSystem.anims[attackAnim], 0, 6);
-                SkelAnimatorInfo frameInfo = SkelModel_Tick(&unit->skelModel);
+                SkelAnimatorInfo frameInfo = SkelModelInstance_Tick(&unit->skelModel);
 
                 if (frameInfo.finishedAnim)
                 {
@@ -1936,7 +1950,7 @@ static void Boss_OnTick(Unit* unit)
                 {
                     if (unit->state == kUnitStateAttackPrimary)
                     {
-                        const SkelAttachPoint* attachPoint = SkelModel_AttachPointAt(&unit->skelModel, 0);
+                        const SkelAttachPose* attachPoint = SkelModelInstance_AttachPointAt(&unit->skelModel, 0);
                         
                         Vec3 emitPoint = Vec3_Add(attachPoint->modelPosition, Quat_MultVec3(&attachPoint->modelRotation, weapon->projectileOffset));
                         emitPoint = Vec3_Add(emitPoint, unit->position);
@@ -1948,7 +1962,7 @@ static void Boss_OnTick(Unit* unit)
                         Quat rotation = Quat_CreateLook(direction, Vec3_Create(1.0f, 0.0f, 0.0f));
                         
                         Prop* projectile = SceneSystem_SpawnPropAt(&engine->sceneSystem, weapon->projectilePropType, emitPoint, rotation, 0);
-                        projectile->owner = unit;
+                        Prop_SetOwner(projectile, unit);
                         projectile->target = endPoint;
                         projectile->hp = weapon->damage;
                         
@@ -2014,10 +2028,10 @@ static void Boss_OnSpawn(Unit* unit, int flags)
     
     unit->speed = 0.24f;
     
-    SkelModel_Copy(&unit->skelModel, &engine->renderSystem.skelModels[SKEL_WITCH]);
+    SkelModelInstance_Set(&unit->skelModel, engine->renderSystem.skelModels + SKEL_WITCH, &engine->sceneSystem.unitPoses, unit->index);
     unit->skelModel.material.diffuseMap = TEX_WITCH;
 
-    unit->skelModel.attachPointTable[0] = Skel_FindAttachPointIndex(&unit->skelModel.skel, "attach_magic");
+    unit->skelModel.attachPointTable[0] = Skel_FindAttachPointIndex(&unit->skelModel.shared->skel, "attach_magic");
 }
 
 static void Skull_OnTouchUnit(Prop* prop, Unit* unit)
@@ -2041,7 +2055,7 @@ static void Skull_OnSpawn(Prop* prop, int flags)
     prop->onTick = Skull_OnTick;
     prop->onTouchUnit = Skull_OnTouchUnit;
     
-    StaticModel_Copy(&prop->model, prop->engine->renderSystem.models + MODEL_SKULL);
+    StaticModelInstance_Set(&prop->model, prop->engine->renderSystem.models + MODEL_SKULL);
     prop->model.material.diffuseMap = TEX_SKULL;
     prop->touchEnabled = 1;
 }
@@ -2058,7 +2072,7 @@ static void MindDamage_OnTouch(Prop* prop, Prop* other)
 
 static void MindDamage_OnTouchUnit(Prop* prop, Unit* unit)
 {
-    if (prop->owner == unit || unit->state == kUnitStateDead)
+    if (Prop_Owner(prop) == unit || unit->state == kUnitStateDead)
         return;
     
     SndSystem_PlaySound(&prop->engine->soundSystem, SND_SYRINGE_HIT);
@@ -2096,7 +2110,7 @@ static void MeleeDamage_OnTouch(Prop* prop, Prop* other)
 
 static void MeleeDamage_OnTouchUnit(Prop* prop, Unit* unit)
 {
-    if (prop->owner == unit || unit->state == kUnitStateDead)
+    if (Prop_Owner(prop) == unit || unit->state == kUnitStateDead)
         return;
     
     SndSystem_PlaySound(&prop->engine->soundSystem, SND_MELEE_HIT);
@@ -2137,7 +2151,7 @@ static void CannonBullet_OnTouch(Prop* prop, Prop* other)
 
 static void CannonBullet_OnTouchUnit(Prop* prop, Unit* unit)
 {
-    if (prop->owner == unit || unit->state == kUnitStateDead)
+    if (Prop_Owner(prop) == unit || unit->state == kUnitStateDead)
         return;
     
     SndSystem_PlaySound(&prop->engine->soundSystem, SND_CANNON_HIT);
@@ -2164,7 +2178,7 @@ static void CannonBullet_OnTick(Prop* prop)
     Vec3 oldPosition = prop->position;
     Vec3 newPosition = Vec3_Add(prop->position, move);
     
-    if (NavSystem_LineIntersectsSolid(&prop->engine->navSystem, oldPosition, newPosition, 10.0f))
+    if (NavSystem_LineIntersectsSolid(&prop->engine->navSystem, prop->navPoly, oldPosition, newPosition))
     {
         SndSystem_PlaySound(&prop->engine->soundSystem, SND_CANNON_HIT);
         Prop_Kill(prop);
@@ -2173,6 +2187,7 @@ static void CannonBullet_OnTick(Prop* prop)
     prop->rotation = Quat_CreateAngle(RAD_TO_DEG(atan2f(prop->forward.x, -prop->forward.y)) - 90.0f, 0.0f, 0.0f, 1.0f);
     prop->position = newPosition;
     prop->bounds = AABB_CreateCentered(newPosition, Vec3_Create(1.0f, 1.0f, 1.0f));
+    Prop_UpdateNavPoly(prop);
 }
 
 static void CannonBullet_OnSpawn(Prop* prop, int flags)
@@ -2181,7 +2196,7 @@ static void CannonBullet_OnSpawn(Prop* prop, int flags)
     prop->onTouch = CannonBullet_OnTouch;
     prop->onTouchUnit = CannonBullet_OnTouchUnit;
     
-    StaticModel_Copy(&prop->model, prop->engine->renderSystem.models + MODEL_CANNON_BULLET);
+    StaticModelInstance_Set(&prop->model, prop->engine->renderSystem.models + MODEL_CANNON_BULLET);
     prop->model.material.diffuseMap = TEX_CANNON_BULLET;
     prop->model.material.flags = kMaterialFlagUnlit;
     
@@ -2206,7 +2221,7 @@ static void MgBullet_OnTouch(Prop* prop, Prop* other)
 
 static void MgBullet_OnTouchUnit(Prop* prop, Unit* unit)
 {
-    if (prop->owner == unit || unit->state == kUnitStateDead)
+    if (Prop_Owner(prop) == unit || unit->state == kUnitStateDead)
         return;
     
     SndSystem_PlaySound(&prop->engine->soundSystem, SND_MG_BULLET_HIT);
@@ -2227,11 +2242,12 @@ static void MgBullet_OnTick(Prop* prop)
     Vec3 oldPosition = prop->position;
     Vec3 newPosition = Vec3_Add(prop->position, move);
     
-    if (NavSystem_LineIntersectsSolid(&prop->engine->navSystem, oldPosition, newPosition, 10.0f))
+    if (NavSystem_LineIntersectsSolid(&prop->engine->navSystem, prop->navPoly, oldPosition, newPosition))
         Prop_Kill(prop);
     
     prop->position = newPosition;
     prop->bounds = AABB_CreateCentered(newPosition, Vec3_Create(1.0f, 1.0f, 1.0f));
+    Prop_UpdateNavPoly(prop);
 }
 
 static void MgBullet_OnSpawn(Prop* prop, int flags)
@@ -2240,7 +2256,7 @@ static void MgBullet_OnSpawn(Prop* prop, int flags)
     prop->onTouch = MgBullet_OnTouch;
     prop->onTouchUnit = MgBullet_OnTouchUnit;
     
-    StaticModel_Copy(&prop->model, prop->engine->renderSystem.models + MODEL_MG_BULLET);
+    StaticModelInstance_Set(&prop->model, prop->engine->renderSystem.models + MODEL_MG_BULLET);
     prop->model.material.diffuseMap = TEX_MG_BULLET;
     prop->model.material.flags = kMaterialFlagUnlit;
     
@@ -2263,7 +2279,7 @@ static void RevolverBullet_OnTouch(Prop* prop, Prop* other)
 
 static void RevolverBullet_OnTouchUnit(Prop* prop, Unit* unit)
 {
-    if (prop->owner == unit || unit->state == kUnitStateDead)
+    if (Prop_Owner(prop) == unit || unit->state == kUnitStateDead)
         return;
     
     SndSystem_PlaySound(&prop->engine->soundSystem, SND_MG_BULLET_HIT);
@@ -2281,11 +2297,12 @@ static void RevolverBullet_OnTick(Prop* prop)
     Vec3 oldPosition = prop->position;
     Vec3 newPosition = Vec3_Add(prop->position, move);
     
-    if (NavSystem_LineIntersectsSolid(&prop->engine->navSystem, oldPosition, newPosition, 10.0f))
+    if (NavSystem_LineIntersectsSolid(&prop->engine->navSystem, prop->navPoly, oldPosition, newPosition))
         Prop_Kill(prop);
     
     prop->position = newPosition;
     prop->bounds = AABB_CreateCentered(newPosition, Vec3_Create(1.0f, 1.0f, 1.0f));
+    Prop_UpdateNavPoly(prop);
 }
 
 static void RevolverBullet_OnSpawn(Prop* prop, int flags)
@@ -2294,7 +2311,7 @@ static void RevolverBullet_OnSpawn(Prop* prop, int flags)
     prop->onTouch = RevolverBullet_OnTouch;
     prop->onTouchUnit = RevolverBullet_OnTouchUnit;
     
-    StaticModel_Copy(&prop->model, prop->engine->renderSystem.models + MODEL_MG_BULLET);
+    StaticModelInstance_Set(&prop->model, prop->engine->renderSystem.models + MODEL_MG_BULLET);
     prop->model.material.diffuseMap = TEX_MG_BULLET;
     prop->model.material.flags = kMaterialFlagUnlit;
     
@@ -2317,7 +2334,7 @@ static void VampBall_OnTouch(Prop* prop, Prop* other)
 
 static void VampBall_OnTouchUnit(Prop* prop, Unit* unit)
 {
-    if (prop->owner == unit || unit->state == kUnitStateDead)
+    if (Prop_Owner(prop) == unit || unit->state == kUnitStateDead)
         return;
     
     SndSystem_PlaySound(&prop->engine->soundSystem, SND_MAGIC_HIT);
@@ -2335,11 +2352,12 @@ static void VampBall_OnTick(Prop* prop)
     Vec3 oldPosition = prop->position;
     Vec3 newPosition = Vec3_Add(prop->position, move);
     
-    if (NavSystem_LineIntersectsSolid(&prop->engine->navSystem, oldPosition, newPosition, 10.0f))
+    if (NavSystem_LineIntersectsSolid(&prop->engine->navSystem, prop->navPoly, oldPosition, newPosition))
         Prop_Kill(prop);
     
     prop->position = newPosition;
     prop->bounds = AABB_CreateCentered(newPosition, Vec3_Create(1.0f, 1.0f, 1.0f));
+    Prop_UpdateNavPoly(prop);
     
     int partEmitterIndex = prop->data[0];
     
@@ -2356,7 +2374,7 @@ static void VampBall_OnSpawn(Prop* prop, int flags)
     prop->onTouch = VampBall_OnTouch;
     prop->onTouchUnit = VampBall_OnTouchUnit;
     
-    StaticModel_Copy(&prop->model, prop->engine->renderSystem.models + MODEL_MAGIC_BALL);
+    StaticModelInstance_Set(&prop->model, prop->engine->renderSystem.models + MODEL_MAGIC_BALL);
     prop->model.material.diffuseMap = TEX_VAMP_BALL;
     prop->model.material.flags = kMaterialFlagUnlit;
 
@@ -2388,7 +2406,7 @@ static void MagicBall_OnTouch(Prop* prop, Prop* other)
 
 static void MagicBall_OnTouchUnit(Prop* prop, Unit* unit)
 {
-    if (prop->owner == unit || unit->state == kUnitStateDead)
+    if (Prop_Owner(prop) == unit || unit->state == kUnitStateDead)
         return;
     
     SndSystem_PlaySound(&prop->engine->soundSystem, SND_MAGIC_HIT);
@@ -2406,11 +2424,12 @@ static void MagicBall_OnTick(Prop* prop)
     Vec3 oldPosition = prop->position;
     Vec3 newPosition = Vec3_Add(prop->position, move);
     
-    if (NavSystem_LineIntersectsSolid(&prop->engine->navSystem, oldPosition, newPosition, 10.0f))
+    if (NavSystem_LineIntersectsSolid(&prop->engine->navSystem, prop->navPoly, oldPosition, newPosition))
         Prop_Kill(prop);
 
     prop->position = newPosition;
     prop->bounds = AABB_CreateCentered(newPosition, Vec3_Create(1.0f, 1.0f, 1.0f));
+    Prop_UpdateNavPoly(prop);
 
     int partEmitterIndex = prop->data[0];
     
@@ -2427,7 +2446,7 @@ static void MagicBall_OnSpawn(Prop* prop, int flags)
     prop->onTouch = MagicBall_OnTouch;
     prop->onTouchUnit = MagicBall_OnTouchUnit;
     
-    StaticModel_Copy(&prop->model, prop->engine->renderSystem.models + MODEL_MAGIC_BALL);
+    StaticModelInstance_Set(&prop->model, prop->engine->renderSystem.models + MODEL_MAGIC_BALL);
     prop->model.material.diffuseMap = TEX_MAGIC_BALL;
     prop->model.material.flags = kMaterialFlagUnlit;
     
@@ -2545,7 +2564,7 @@ static void UnitSpawn_OnTick(Prop* prop)
     if (unitSpawnIndex != -1 && unitSpawnIndex >= engine->players[playerId]->unitSpawnInfoCount)
     {
         // invalid count;
-        prop->dead = 1;
+        SceneSystem_ReleaseProp(&prop->engine->sceneSystem, prop);
         return;
     }
     
@@ -2639,7 +2658,7 @@ static void ItemPickup_OnVar(Prop* prop, const char* key, const char* val)
         
         assert(model != -1);
         assert(texture != -1);
-        StaticModel_Copy(&prop->model, prop->engine->renderSystem.models + model);
+        StaticModelInstance_Set(&prop->model, prop->engine->renderSystem.models + model);
         prop->model.material.diffuseMap = texture;
         
         prop->data[0] = model;
@@ -2672,7 +2691,7 @@ static void ItemPickup_OnAction(Prop* prop, Unit* unit)
     }
     
     SndSystem_PlaySound(&prop->engine->soundSystem, SND_WEAPON_PICKUP);
-    prop->dead = 1;
+    SceneSystem_ReleaseProp(&prop->engine->sceneSystem, prop);
 }
 
 static void ItemPickup_OnSpawn(Prop* prop, int flags)
@@ -2729,7 +2748,7 @@ static void WeaponPickup_OnVar(Prop* prop, const char* key, const char* val)
         
         assert(model != -1);
         assert(texture != -1);
-        StaticModel_Copy(&prop->model, prop->engine->renderSystem.models + model);
+        StaticModelInstance_Set(&prop->model, prop->engine->renderSystem.models + model);
         prop->model.material.diffuseMap = texture;
     }
 }
@@ -2753,7 +2772,7 @@ static void WeaponPickup_OnAction(Prop* prop, Unit* unit)
         Player_Select(player, unit);
         
         SndSystem_PlaySound(&prop->engine->soundSystem, SND_WEAPON_PICKUP);
-        prop->dead = 1;
+        SceneSystem_ReleaseProp(&prop->engine->sceneSystem, prop);
     }
 }
 
@@ -2863,8 +2882,7 @@ static void EggHealer_OnDamage(struct Prop* prop, struct Prop* other, int damage
         prop->onTouch = NULL;
         prop->onDamage = NULL;
         
-        StaticModel_Shutdown(&prop->model);
-        StaticModel_Copy(&prop->model, prop->engine->renderSystem.models + MODEL_EGG_HEALER_DEAD);
+        StaticModelInstance_Set(&prop->model, prop->engine->renderSystem.models + MODEL_EGG_HEALER_DEAD);
         prop->model.material.diffuseMap = TEX_EGG_HEALER_DEAD;
     }
 }
@@ -2878,7 +2896,7 @@ static void EggHealer_OnEvent(Prop* prop, Prop* sender, EventType event, int dat
             if (data != prop->playerId)
                 break;
             
-            for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+            for (int i = 0; i < prop->engine->sceneSystem.unitCapacity; ++i)
             {
                 Unit* unit = prop->engine->sceneSystem.units + i;
                 if (unit->dead || unit->state == kUnitStateDead) continue;
@@ -2917,7 +2935,7 @@ static void EggHealer_OnSpawn(Prop* prop, int flags)
     prop->onEvent = EggHealer_OnEvent;
     prop->onDamage = EggHealer_OnDamage;
     
-    StaticModel_Copy(&prop->model, prop->engine->renderSystem.models + MODEL_EGG_HEALER);
+    StaticModelInstance_Set(&prop->model, prop->engine->renderSystem.models + MODEL_EGG_HEALER);
     prop->model.material.diffuseMap = TEX_EGG_HEALER;
     
     prop->playerId = ENGINE_PLAYER_AI;
@@ -2994,7 +3012,7 @@ static void EyeMine_OnTick(Prop* prop)
 
     if (isTriggered) return;
     
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+    for (int i = 0; i < prop->engine->sceneSystem.unitCapacity; ++i)
     {
         const Unit* unit = prop->engine->sceneSystem.units + i;
         if (unit->dead) continue;
@@ -3011,8 +3029,7 @@ static void EyeMine_OnTick(Prop* prop)
             if (prop->timer == -1)
                 prop->timer = rand() % 7 + 1;
             
-            StaticModel_Shutdown(&prop->model);
-            StaticModel_Copy(&prop->model, prop->engine->renderSystem.models + MODEL_EYE_MINE_OPEN);
+            StaticModelInstance_Set(&prop->model, prop->engine->renderSystem.models + MODEL_EYE_MINE_OPEN);
             prop->model.material.diffuseMap = TEX_EYE_MINE;
             break;
         }
@@ -3058,7 +3075,7 @@ static void EyeMine_OnSpawn(Prop* prop, int flags)
     prop->onTick = EyeMine_OnTick;
     prop->onVar = EyeMine_OnVar;
     
-    StaticModel_Copy(&prop->model, prop->engine->renderSystem.models + MODEL_EYE_MINE_CLOSED);
+    StaticModelInstance_Set(&prop->model, prop->engine->renderSystem.models + MODEL_EYE_MINE_CLOSED);
     prop->model.material.diffuseMap = TEX_EYE_MINE;
     
     prop->touchEnabled = 1;
@@ -3069,6 +3086,13 @@ static void EyeMine_OnSpawn(Prop* prop, int flags)
     int isTriggered = 0;
     prop->data[0] = isTriggered;
     
+    Ray3 ray = Ray3_Create(Vec3_Offset(prop->position, 0.0f, 0.0f, 5.0f), Vec3_Create(0.0f, 0.0f, -1.0f));
+    
+    // paths go around the mine, see Engine_TickObstacles
+    NavRaycastResult result;
+    if (NavSystem_Raycast(&prop->engine->navSystem, ray, &result))
+        prop->navPoly = result.poly;
+    
     prop->bounds = AABB_CreateCentered(Vec3_Offset(prop->position, 0.0f, 0.0f, 1.0f) , Vec3_Create(3.5f, 3.5f, 2.0f));
 }
 
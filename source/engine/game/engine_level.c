@@ -17,6 +17,7 @@ void Engine_LevelLoadPath(Engine* engine, const char* path)
         DATA_SKULLS,
         DATA_LIGHT,
         DATA_VERSION,
+        DATA_CAPACITY,
     };
     
     char fullPath[MAX_OS_PATH];
@@ -25,6 +26,12 @@ void Engine_LevelLoadPath(Engine* engine, const char* path)
     SceneSystem_Clear(&engine->sceneSystem);
     engine->sceneSystem.chunkCount = 0;
     
+    if (!SceneSystem_Reserve(&engine->sceneSystem, SCENE_SYSTEM_UNITS_DEFAULT, SCENE_SYSTEM_PROPS_DEFAULT))
+    {
+        printf("Failed to reserve the scene for level: %s\n", fullPath);
+        return;
+    }
+    
     Prop* lastProp = NULL;
     char buff[LINE_BUFFER_MAX];
     
@@ -87,6 +94,10 @@ void Engine_LevelLoadPath(Engine* engine, const char* path)
         {
             dataType = DATA_VERSION;
         }
+        else if (strcmp(token, "capacity") == 0)
+        {
+            dataType = DATA_CAPACITY;
+        }
         else
         {
             printf("%s\n", token);
@@ -294,6 +305,23 @@ void Engine_LevelLoadPath(Engine* engine, const char* path)
                 assert(atoi(token) == 2);
                 break;
             }
+            case DATA_CAPACITY:
+            {
+                // units and props, before any are spawned
+                int unitCapacity = SCENE_SYSTEM_UNITS_DEFAULT;
+                int propCapacity = SCENE_SYSTEM_PROPS_DEFAULT;
+                sscanf(token, "%i %i", &unitCapacity, &propCapacity);
+                
+                if (!SceneSystem_Reserve(&engine->sceneSystem, unitCapacity, propCapacity))
+                {
+                    printf("capacity must come before props and fit in memory: %s\n", token);
+                    
+                    // out of memory leaves the scene empty, load the rest at the default size
+                    SceneSystem_Reserve(&engine->sceneSystem, SCENE_SYSTEM_UNITS_DEFAULT, SCENE_SYSTEM_PROPS_DEFAULT);
+                }
+                
+                break;
+            }
             default:
                 assert(0);
                 break;
@@ -302,6 +330,8 @@ void Engine_LevelLoadPath(Engine* engine, const char* path)
     }
 
     fclose(file);
+    
+    SceneSystem_IndexIdentifiers(&engine->sceneSystem);
 }
 
 
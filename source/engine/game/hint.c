@@ -134,28 +134,26 @@ void HintBuffer_PackAABB(HintBuffer* buffer,
 
 
 void Hintbuffer_PackSkel(HintBuffer* buffer,
-                         const Skel* skel,
+                         const SkelPose* pose,
                          const Vec3 position,
                          const Vec3 boneColor,
                          const Vec3 upColor)
 {
     /*
     int i;
-    for (i = 0; i < skel->jointCount; ++i)
+    for (i = 0; i < pose->skel->jointCount; ++i)
     {
-        const SkelJoint* joint = skel->joints + i;
+        Vec3 up = Vec3_Scale(Quat_MultVec3(&pose->rotations[i], Vec3_Create(0.0f, 0.0f, 1.0f)), 0.5f);
         
-        Vec3 up = Vec3_Scale(Quat_MultVec3(&joint->rotation, Vec3_Create(0.0f, 0.0f, 1.0f)), 0.5f);
-        
-        buffer->verts[buffer->vertCount].pos = Vec3_Add(position, joint->modelHead);
+        buffer->verts[buffer->vertCount].pos = Vec3_Add(position, pose->modelHeads[i]);
         buffer->verts[buffer->vertCount].color = boneColor;
         ++buffer->vertCount;
         
-        buffer->verts[buffer->vertCount].pos = Vec3_Add(position, joint->modelTail);
+        buffer->verts[buffer->vertCount].pos = Vec3_Add(position, pose->modelTails[i]);
         buffer->verts[buffer->vertCount].color = boneColor;
         ++buffer->vertCount;
         
-        buffer->verts[buffer->vertCount].pos = Vec3_Add(position, Vec3_Add(joint->modelTail, up));
+        buffer->verts[buffer->vertCount].pos = Vec3_Add(position, Vec3_Add(pose->modelTails[i], up));
         buffer->verts[buffer->vertCount].color = upColor;
         ++buffer->vertCount;
         
@@ -169,9 +167,9 @@ void Hintbuffer_PackSkel(HintBuffer* buffer,
      */
     
     int i;
-    for (i = 0; i < skel->attachPointCount; ++i)
+    for (i = 0; i < pose->skel->attachPointCount; ++i)
     {
-        const SkelAttachPoint* point = skel->attachPoints + i;
+        const SkelAttachPose* point = pose->attachPoints + i;
         
         Vec3 up = Vec3_Scale(Quat_MultVec3(&point->modelRotation, Vec3_Create(0.0f, 1.0f, 0.0f)), 0.5f);
         
@@ -195,6 +193,9 @@ void HintBuffer_PackPath(HintBuffer* buffer,
                          const NavPath* path,
                          const Vec3 color)
 {
+    if (path->nodeCount < 1)
+        return;
+    
     buffer->verts[buffer->vertCount].pos = path->nodes[0].point;
     buffer->verts[buffer->vertCount].color = color;
     ++buffer->vertCount;
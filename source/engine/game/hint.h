@@ -53,7 +53,7 @@ extern void HintBuffer_PackAABB(HintBuffer* buffer,
 
 
 extern void Hintbuffer_PackSkel(HintBuffer* buffer,
-                                const Skel* skel,
+                                const SkelPose* pose,
                                 const Vec3 position,
                                 const Vec3 boneColor,
                                 const Vec3 upColor);
@@ -88,9 +88,9 @@ static void Human_CenterOnNextUnit(Player* controller)
         startIndex = 0;
     }
 
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+    for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
     {
-        int index = (startIndex + i) % SCENE_SYSTEM_UNITS_MAX;
+        int index = (startIndex + i) % engine->sceneSystem.unitCapacity;
         
         const Unit* unit = engine->sceneSystem.units + index;
         if (!unit->dead && unit->playerId == controller->playerId)
@@ -155,7 +155,7 @@ static void Human_OnGuiEvent(GuiSystem* system, const GuiEvent* event, void* del
                 {
                     int unitsDone = 1;
                     
-                    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+                    for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
                     {
                         const Unit* unit = engine->sceneSystem.units + i;
                         if (unit->dead) { continue; }
@@ -193,7 +193,8 @@ static void Human_OnGuiEvent(GuiSystem* system, const GuiEvent* event, void* del
             }
             case LAYER_DESELECT:
             {
-                if (controller->selection->state == kUnitStateMove)
+                if (controller->selection->state == kUnitStateMove ||
+                    controller->selection->state == kUnitStatePlanPath)
                 {
                     controller->state = kHumanStateIdle;
                     controller->selection->state = kUnitStateIdle;
@@ -339,7 +340,7 @@ static void Human_OnGuiTick(GuiSystem* system, void* delegate)
         attackPrimaryBtn->hidden = engine->state == kEngineStateCommand;
         attackSecondaryBtn->hidden = engine->state == kEngineStateCommand;
         
-        deselectBtn->hidden = engine->state == kEngineStateCommand && controller->selection->state != kUnitStateMove;
+        deselectBtn->hidden = engine->state == kEngineStateCommand && controller->selection->state != kUnitStateMove && controller->selection->state != kUnitStatePlanPath;
         
         if (unit->actionCounter < 1 || unit->primaryWeapon == -1)
         {
@@ -672,7 +673,7 @@ static void Human_OnTap(Player* controller, const PlayerEvent* event)
         Unit* target = NULL;
         float closestDistSq = 0.0f;
 
-        for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+        for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
         {
             Unit* unit = engine->sceneSystem.units + i;
             if (unit->dead) continue;
@@ -730,7 +731,7 @@ static void Human_OnTap(Player* controller, const PlayerEvent* event)
         float closestDistSq = 0.0f;
         
         // see if we clicked on a unit
-        for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+        for (int i = 0; i < engine->sceneSystem.unitCapacity; ++i)
         {
             Unit* unit = engine->sceneSystem.units + i;
             if (unit->dead) continue;
@@ -57,11 +57,11 @@ void Player_Event(Player* controller, const PlayerEvent* event)
         controller->onEvent(controller, event);
 }
 
-int Player_GetResultUnitInfos(Player* controller, UnitInfo* buffer)
+int Player_GetResultUnitInfos(Player* controller, UnitInfo* buffer, int capacity)
 {
     int count = 0;
     
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+    for (int i = 0; i < controller->engine->sceneSystem.unitCapacity && count < capacity; ++i)
     {
         const Unit* unit = controller->engine->sceneSystem.units + i;
         if (unit->dead || unit->playerId != controller->playerId ||unit->state == kUnitStateDead) { continue; }
@@ -75,7 +75,7 @@ int Player_GetResultUnitInfos(Player* controller, UnitInfo* buffer)
     }
     
     // find enemies which were killed
-    for (int i = 0; i < controller->unitSpawnInfoCount; ++i)
+    for (int i = 0; i < controller->unitSpawnInfoCount && count < capacity; ++i)
     {
         const UnitInfo* spawnInfo = controller->unitSpawnInfo + i;
         
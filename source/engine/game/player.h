@@ -84,6 +84,7 @@ extern void Player_ClearSelection(Player* controller);
 
 extern void Player_Event(Player* controller, const PlayerEvent* event);
 
-extern int Player_GetResultUnitInfos(Player* controller, UnitInfo* buffer);
+/* fills buffer with up to capacity infos. Room for unitCapacity + unitSpawnInfoCount holds them all */
+extern int Player_GetResultUnitInfos(Player* controller, UnitInfo* buffer, int capacity);
 
 #endif /* controller_h */
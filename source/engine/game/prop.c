@@ -13,7 +13,7 @@ int Prop_Init(Prop* prop, struct Engine* engine, int index)
     prop->touchEnabled = 0;
     
     prop->hp = 0;
-    prop->owner = NULL;
+    prop->owner = SceneHandle_None;
     
     prop->position = Vec3_Zero;
     prop->forward = Vec3_Zero;
@@ -22,7 +22,7 @@ int Prop_Init(Prop* prop, struct Engine* engine, int index)
     prop->rotation = Quat_Identity;
     prop->spawnRotation = Vec3_Zero;
     
-    prop->model.loaded = 0;
+    StaticModelInstance_Init(&prop->model);
     prop->navPoly = NULL;
     
     prop->visible = 1;
@@ -46,7 +46,10 @@ int Prop_Init(Prop* prop, struct Engine* engine, int index)
         prop->data[i] = -1;
     
     for (int i = 0; i < PROP_EVENTS_MAX; ++i)
+    {
         prop->events[i].event = kEventNone;
+        prop->events[i].targetProp = SceneHandle_None;
+    }
     
     return 1;
 }
@@ -64,7 +67,7 @@ void Prop_InputEvent(Prop* target, Prop* sender, EventType event, int data)
         switch (event)
         {
             case kEventDie:
-                target->dead = 1;
+                SceneSystem_ReleaseProp(&target->engine->sceneSystem, target);
                 break;
             case kEventActivate:
                 target->inactive = 0;
@@ -92,10 +95,10 @@ void Prop_OutputEvent(Prop* target, Prop* sender, EventType event, int data)
     {
         if (target->events[i].event == event)
         {
-            Prop* found = SceneSystem_FindProp(&target->engine->sceneSystem, target->events[i].target);
+            Prop* found = SceneSystem_PropFromHandle(&target->engine->sceneSystem, target->events[i].targetProp);
             
             // endless loop sending events to ourselves
-            if (found && !(found == target && event == target->events[i].action))
+            if (found && !found->dead && !(found == target && event == target->events[i].action))
             {
                 Prop_InputEvent(found, target, target->events[i].action, target->events[i].data);
             }
@@ -109,6 +112,30 @@ void Prop_Kill(Prop* prop)
     Prop_InputEvent(prop, NULL, kEventDie, 0);
 }
 
+struct Unit* Prop_Owner(const Prop* prop)
+{
+    return SceneSystem_UnitFromHandle(&prop->engine->sceneSystem, prop->owner);
+}
+
+void Prop_SetOwner(Prop* prop, const struct Unit* owner)
+{
+    prop->owner = SceneSystem_UnitHandle(&prop->engine->sceneSystem, owner);
+}
+
+void Prop_UpdateNavPoly(Prop* prop)
+{
+    NavRaycastResult hitInfo;
+    
+    if (NavSystem_LocatePoint(&prop->engine->navSystem, prop->navPoly, prop->position, &hitInfo))
+    {
+        prop->navPoly = hitInfo.poly;
+    }
+    else
+    {
+        prop->navPoly = NULL;
+    }
+}
+
 void Prop_Damage(Prop* prop,
                  Prop* other,
                  int damage,
@@ -6,6 +6,7 @@
 #include "static_model.h"
 #include "geo_math.h"
 #include "nav_mesh.h"
+#include "scene_handle.h"
 
 typedef enum
 {
@@ -65,6 +66,8 @@ typedef struct
     
     /* tag of entity to find */
     char target[PROP_IDENTIFIER_MAX];
+    // found from target once the level loads, see SceneSystem_IndexIdentifiers
+    SceneHandle targetProp;
     
     // the event we want to trigger in the target 
     EventType action;
@@ -79,11 +82,14 @@ typedef struct Prop
     struct Engine* engine;
 
     int index;
+    // bumped each time a prop spawns into this slot, see SceneHandle
+    unsigned int generation;
     PropType type;
     
-    struct Unit* owner;
+    // the unit that fired or placed this, read with Prop_Owner
+    SceneHandle owner;
     
-    NavPoly* navPoly;
+    const NavPoly* navPoly;
     char identifier[PROP_IDENTIFIER_MAX];
     
     int dead;
@@ -91,7 +97,7 @@ typedef struct Prop
     int touchEnabled;
 
     int visible;
-    StaticModel model;
+    StaticModelInstance model;
     
     int hp;
     
@@ -141,6 +147,13 @@ extern void Prop_OutputEvent(Prop* target, Prop* sender, EventType event, int da
 
 extern void Prop_Kill(Prop* prop);
 
+/* NULL if there is no owner, or its slot has been spawned into again */
+extern struct Unit* Prop_Owner(const Prop* prop);
+extern void Prop_SetOwner(Prop* prop, const struct Unit* owner);
+
+/* find the nav poly under the prop, starting from the last one */
+extern void Prop_UpdateNavPoly(Prop* prop);
+
 extern void Prop_Damage(Prop* prop,
                         Prop* other,
                         int damage,
@@ -0,0 +1,17 @@
+
+#ifndef SCENE_HANDLE_H
+#define SCENE_HANDLE_H
+
+/* Refers to a unit or prop slot in the scene without holding a pointer to it.
+ Each slot's generation goes up when something spawns into it,
+ so a handle to a unit that died stops resolving once its slot is reused. */
+
+typedef struct
+{
+    int index;
+    unsigned int generation;
+} SceneHandle;
+
+static const SceneHandle SceneHandle_None = {-1, 0};
+
+#endif
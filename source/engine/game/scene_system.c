@@ -2,6 +2,10 @@
 #include "scene_system.h"
 #include "platform.h"
 #include "engine.h"
+#include <stdint.h>
+
+// far past any level, keeps cell coordinates in range
+#define SCENE_TOUCH_COORD_MAX 1000000.0f
 
 static void Chunk_Init(Chunk* chunk)
 {
@@ -9,6 +13,128 @@ static void Chunk_Init(Chunk* chunk)
     chunk->texture = -1;
 }
 
+static void SceneFree_Fill(SceneFreeList* list, int count)
+{
+    // ascending order is already a heap
+    for (int i = 0; i < count; ++i)
+        list->slots[i] = i;
+    
+    list->count = count;
+}
+
+static void SceneFree_Push(SceneFreeList* list, int slot)
+{
+    int i = list->count;
+    ++list->count;
+    
+    while (i > 0)
+    {
+        int parent = (i - 1) / 2;
+        
+        if (list->slots[parent] <= slot)
+            break;
+        
+        list->slots[i] = list->slots[parent];
+        i = parent;
+    }
+    
+    list->slots[i] = slot;
+}
+
+static int SceneFree_Pop(SceneFreeList* list)
+{
+    if (list->count == 0)
+        return -1;
+    
+    int slot = list->slots[0];
+    
+    --list->count;
+    int last = list->slots[list->count];
+    int i = 0;
+    
+    while (1)
+    {
+        int child = i * 2 + 1;
+        
+        if (child >= list->count)
+            break;
+        
+        if (child + 1 < list->count && list->slots[child + 1] < list->slots[child])
+            ++child;
+        
+        if (last <= list->slots[child])
+            break;
+        
+        list->slots[i] = list->slots[child];
+        i = child;
+    }
+    
+    if (list->count > 0)
+        list->slots[i] = last;
+    
+    return slot;
+}
+
+static void SceneTouch_Reset(SceneTouchGrid* grid, int propCapacity)
+{
+    memset(grid->buckets, 0, sizeof(unsigned int) * SCENE_TOUCH_BUCKETS * grid->words);
+    memset(grid->large, 0, sizeof(unsigned int) * grid->words);
+    memset(grid->propCells, 0, sizeof(int[4]) * propCapacity);
+    memset(grid->propPlacements, 0, propCapacity);
+}
+
+static void SceneIdentifiers_Reset(SceneIdentifierIndex* index)
+{
+    for (int i = 0; i < index->bucketCount; ++i)
+        index->buckets[i] = -1;
+}
+
+static void SceneSystem_FreeArrays(SceneSystem* world)
+{
+    SceneTouchGrid* grid = &world->touchGrid;
+    SceneHot* hot = &world->hot;
+    SceneIdentifierIndex* identifiers = &world->identifiers;
+    
+    free(world->units);
+    free(world->props);
+    free(world->freeUnits.slots);
+    free(world->freeProps.slots);
+    
+    free(grid->buckets);
+    free(grid->large);
+    free(grid->propCells);
+    free(grid->propPlacements);
+    free(grid->mask);
+    free(grid->candidates);
+    
+    free(hot->liveUnits);
+    free(hot->unitPositions);
+    free(hot->unitBounds);
+    free(hot->unitPlayerIds);
+    free(hot->unitViewRadii);
+    free(hot->unitFlags);
+    
+    free(hot->liveProps);
+    free(hot->propPositions);
+    free(hot->propBounds);
+    free(hot->propPlayerIds);
+    free(hot->propFlags);
+    
+    free(identifiers->buckets);
+    free(identifiers->next);
+    
+    world->units = NULL;
+    world->unitCapacity = 0;
+    world->props = NULL;
+    world->propCapacity = 0;
+    
+    memset(&world->freeUnits, 0, sizeof(SceneFreeList));
+    memset(&world->freeProps, 0, sizeof(SceneFreeList));
+    memset(grid, 0, sizeof(SceneTouchGrid));
+    memset(hot, 0, sizeof(SceneHot));
+    memset(identifiers, 0, sizeof(SceneIdentifierIndex));
+}
+
 void SceneSystem_Init(SceneSystem* world, struct Engine* engine, const SpawnTable* handler)
 {
     world->engine = engine;
@@ -18,16 +144,124 @@ void SceneSystem_Init(SceneSystem* world, struct Engine* engine, const SpawnTabl
     for (int i = 0; i < SCENE_SYSTEM_CHUNKS_MAX; ++i)
         Chunk_Init(world->chunks + i);
     
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
-        Unit_Init(world->units + i, engine, i);
+    world->units = NULL;
+    world->unitCapacity = 0;
+    world->props = NULL;
+    world->propCapacity = 0;
+    
+    memset(&world->freeUnits, 0, sizeof(SceneFreeList));
+    memset(&world->freeProps, 0, sizeof(SceneFreeList));
+    memset(&world->touchGrid, 0, sizeof(SceneTouchGrid));
+    memset(&world->hot, 0, sizeof(SceneHot));
+    memset(&world->identifiers, 0, sizeof(SceneIdentifierIndex));
     
-    for (int i = 0; i < SCENE_SYSTEM_PROPS_MAX; ++i)
-        Prop_Init(world->props + i, engine, i);
+    SceneSystem_Reserve(world, SCENE_SYSTEM_UNITS_DEFAULT, SCENE_SYSTEM_PROPS_DEFAULT);
     
     world->skullCount = 3;
     world->handler = handler;
 }
 
+void SceneSystem_Shutdown(SceneSystem* world)
+{
+    SceneSystem_Clear(world);
+    SceneSystem_FreeArrays(world);
+}
+
+int SceneSystem_Reserve(SceneSystem* world, int unitCapacity, int propCapacity)
+{
+    // something is still alive
+    if (world->freeUnits.count != world->unitCapacity || world->freeProps.count != world->propCapacity)
+        return 0;
+    
+    unitCapacity = CLAMP(unitCapacity, 1, SCENE_SYSTEM_UNITS_LIMIT);
+    propCapacity = CLAMP(propCapacity, 1, SCENE_SYSTEM_PROPS_LIMIT);
+    
+    if (unitCapacity == world->unitCapacity && propCapacity == world->propCapacity)
+        return 1;
+    
+    SceneSystem_FreeArrays(world);
+    
+    world->units = calloc(unitCapacity, sizeof(Unit));
+    world->props = calloc(propCapacity, sizeof(Prop));
+    world->freeUnits.slots = malloc(sizeof(int) * unitCapacity);
+    world->freeProps.slots = malloc(sizeof(int) * propCapacity);
+    
+    SceneTouchGrid* grid = &world->touchGrid;
+    grid->words = (propCapacity + 31) / 32;
+    grid->buckets = calloc(SCENE_TOUCH_BUCKETS * grid->words, sizeof(unsigned int));
+    grid->large = calloc(grid->words, sizeof(unsigned int));
+    grid->propCells = calloc(propCapacity, sizeof(int[4]));
+    grid->propPlacements = calloc(propCapacity, sizeof(char));
+    grid->mask = malloc(sizeof(unsigned int) * grid->words);
+    grid->candidates = malloc(sizeof(int) * propCapacity);
+    
+    SceneHot* hot = &world->hot;
+    hot->liveUnits = malloc(sizeof(int) * unitCapacity);
+    hot->unitPositions = malloc(sizeof(Vec3) * unitCapacity);
+    hot->unitBounds = malloc(sizeof(AABB) * unitCapacity);
+    hot->unitPlayerIds = malloc(sizeof(int) * unitCapacity);
+    hot->unitViewRadii = malloc(sizeof(int) * unitCapacity);
+    hot->unitFlags = malloc(sizeof(unsigned char) * unitCapacity);
+    
+    hot->liveProps = malloc(sizeof(int) * propCapacity);
+    hot->propPositions = malloc(sizeof(Vec3) * propCapacity);
+    hot->propBounds = malloc(sizeof(AABB) * propCapacity);
+    hot->propPlayerIds = malloc(sizeof(int) * propCapacity);
+    hot->propFlags = malloc(sizeof(unsigned char) * propCapacity);
+    
+    // at least twice the props so chains stay short
+    SceneIdentifierIndex* identifiers = &world->identifiers;
+    identifiers->bucketCount = 1;
+    
+    while (identifiers->bucketCount < propCapacity * 2)
+        identifiers->bucketCount *= 2;
+    
+    identifiers->buckets = malloc(sizeof(int) * identifiers->bucketCount);
+    identifiers->next = malloc(sizeof(int) * propCapacity);
+    
+    if (!world->units || !world->props || !world->freeUnits.slots || !world->freeProps.slots ||
+        !grid->buckets || !grid->large || !grid->propCells || !grid->propPlacements || !grid->mask || !grid->candidates ||
+        !hot->liveUnits || !hot->unitPositions || !hot->unitBounds || !hot->unitPlayerIds || !hot->unitViewRadii || !hot->unitFlags ||
+        !hot->liveProps || !hot->propPositions || !hot->propBounds || !hot->propPlayerIds || !hot->propFlags ||
+        !identifiers->buckets || !identifiers->next)
+    {
+        // leaves an empty scene that spawns nothing
+        SceneSystem_FreeArrays(world);
+        return 0;
+    }
+    
+    world->unitCapacity = unitCapacity;
+    world->propCapacity = propCapacity;
+    
+    for (int i = 0; i < unitCapacity; ++i)
+        Unit_Init(world->units + i, world->engine, i);
+    
+    for (int i = 0; i < propCapacity; ++i)
+        Prop_Init(world->props + i, world->engine, i);
+    
+    SceneFree_Fill(&world->freeUnits, unitCapacity);
+    SceneFree_Fill(&world->freeProps, propCapacity);
+    SceneIdentifiers_Reset(identifiers);
+    
+    // poses are sized once assets are loaded, resize them if they are
+    int jointsPerPose = world->unitPoses.jointsPerPose;
+    
+    if (jointsPerPose > 0)
+    {
+        SkelPosePool_Shutdown(&world->unitPoses);
+        
+        if (!SkelPosePool_Init(&world->unitPoses, unitCapacity, jointsPerPose))
+        {
+            // no poses, but the next reserve sizes them again
+            world->unitPoses.jointsPerPose = jointsPerPose;
+            SceneSystem_FreeArrays(world);
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
 
 Unit* SceneSystem_SpawnUnitAt(SceneSystem* world, UnitType type, Vec3 point, float angle, int flags)
 {
@@ -49,31 +283,29 @@ Unit* SceneSystem_SpawnUnitAt(SceneSystem* world, UnitType type, Vec3 point, flo
         if (j->type == -1) { return NULL; }
     }
     
-    /* find an empty slot for entities */
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
-    {
-        Unit* unit = world->units + i;
-        
-        if (unit->dead)
-        {
-            Unit_Init(unit, world->engine, i);
-            unit->dead = 0;
-            unit->type = type;
-            
-            unit->onSpawn = j->onSpawn;
-            
-            unit->position = point;
-            unit->angle = angle;
-            unit->targetAngle = unit->angle;
-            
-            if (unit->onSpawn)
-                unit->onSpawn(unit, flags);
-            
-            return unit;
-        }
-    }
+    int slot = SceneFree_Pop(&world->freeUnits);
     
-    return NULL;
+    if (slot == -1)
+        return NULL;
+    
+    Unit* unit = world->units + slot;
+    
+    SkelModelInstance_Clear(&unit->skelModel);
+    Unit_Init(unit, world->engine, slot);
+    ++unit->generation;
+    unit->dead = 0;
+    unit->type = type;
+    
+    unit->onSpawn = j->onSpawn;
+    
+    unit->position = point;
+    unit->angle = angle;
+    unit->targetAngle = unit->angle;
+    
+    if (unit->onSpawn)
+        unit->onSpawn(unit, flags);
+    
+    return unit;
 }
 
 Unit* SceneSystem_SpawnUnit(SceneSystem* world, UnitType type)
@@ -83,7 +315,7 @@ Unit* SceneSystem_SpawnUnit(SceneSystem* world, UnitType type)
 
 Unit* SceneSystem_FindUnitType(SceneSystem* world, UnitType type, int playerId)
 {
-    for (int j = 0; j < SCENE_SYSTEM_UNITS_MAX; ++j)
+    for (int j = 0; j < world->unitCapacity; ++j)
     {
         const Unit* unit = world->units + j;
         
@@ -132,34 +364,33 @@ Prop* SceneSystem_SpawnPropDetail(SceneSystem* world,
             return NULL;
     }
     
-    // find an empty slot for entities
-    for (int i = 0; i < SCENE_SYSTEM_PROPS_MAX; ++i)
-    {
-        Prop* prop = world->props + i;
-        
-        if (prop->dead)
-        {
-            Prop_Init(prop, world->engine, i);
-            prop->dead = 0;
-            prop->type = type;
-            
-            prop->onSpawn = j->onSpawn;
-            
-            prop->position = position;
-            prop->rotation = rotation;
-            prop->bounds = bounds;
-            prop->spawnRotation = spawnEuler;
-            
-            if (prop->onSpawn)
-                prop->onSpawn(prop, flags);
-            
-            Prop_OutputEvent(prop, NULL, kEventSpawn, 0);
-            
-            return prop;
-        }
-    }
+    int slot = SceneFree_Pop(&world->freeProps);
     
-    return NULL;
+    if (slot == -1)
+        return NULL;
+    
+    Prop* prop = world->props + slot;
+    
+    StaticModelInstance_Clear(&prop->model);
+    Prop_Init(prop, world->engine, slot);
+    ++prop->generation;
+    prop->dead = 0;
+    prop->type = type;
+    
+    prop->onSpawn = j->onSpawn;
+    
+    prop->position = position;
+    prop->rotation = rotation;
+    prop->bounds = bounds;
+    prop->spawnRotation = spawnEuler;
+    
+    if (prop->onSpawn)
+        prop->onSpawn(prop, flags);
+    
+    Prop_OutputEvent(prop, NULL, kEventSpawn, 0);
+    SceneSystem_UpdateTouch(world, prop);
+    
+    return prop;
 }
 
 Prop* SceneSystem_SpawnProp(SceneSystem* world, PropType type)
@@ -167,9 +398,32 @@ Prop* SceneSystem_SpawnProp(SceneSystem* world, PropType type)
     return SceneSystem_SpawnPropAt(world, type, Vec3_Zero, Quat_Identity, 0);
 }
 
+// FNV-1a
+static uint32_t SceneIdentifiers_Hash(const char* identifier)
+{
+    uint32_t hash = 2166136261u;
+    
+    for (const char* c = identifier; *c != '\0'; ++c)
+    {
+        hash ^= (unsigned char)*c;
+        hash *= 16777619u;
+    }
+    
+    return hash;
+}
+
 Prop* SceneSystem_FindProp(SceneSystem* world, const char* identifier)
 {
-    for (int j = 0; j < SCENE_SYSTEM_PROPS_MAX; ++j)
+    const SceneIdentifierIndex* index = &world->identifiers;
+    
+    // empty after a failed SceneSystem_Reserve
+    if (index->bucketCount == 0)
+        return NULL;
+    
+    int bucket = (int)(SceneIdentifiers_Hash(identifier) & (index->bucketCount - 1));
+    
+    // slots reused since the level loaded have no identifier, so they never match
+    for (int j = index->buckets[bucket]; j != -1; j = index->next[j])
     {
         if (world->props[j].dead) continue;
         
@@ -180,15 +434,310 @@ Prop* SceneSystem_FindProp(SceneSystem* world, const char* identifier)
     return NULL;
 }
 
+void SceneSystem_IndexIdentifiers(SceneSystem* world)
+{
+    SceneIdentifierIndex* index = &world->identifiers;
+    SceneIdentifiers_Reset(index);
+    
+    // last to first, so each bucket ends up in index order
+    for (int i = world->propCapacity - 1; i >= 0; --i)
+    {
+        const Prop* prop = world->props + i;
+        if (prop->dead || prop->identifier[0] == '\0') continue;
+        
+        int bucket = (int)(SceneIdentifiers_Hash(prop->identifier) & (index->bucketCount - 1));
+        index->next[i] = index->buckets[bucket];
+        index->buckets[bucket] = i;
+    }
+    
+    for (int i = 0; i < world->propCapacity; ++i)
+    {
+        Prop* prop = world->props + i;
+        if (prop->dead) continue;
+        
+        for (int j = 0; j < PROP_EVENTS_MAX; ++j)
+        {
+            PropEventTrigger* trigger = prop->events + j;
+            if (trigger->event == kEventNone) continue;
+            
+            trigger->targetProp = SceneSystem_PropHandle(world, SceneSystem_FindProp(world, trigger->target));
+        }
+    }
+}
+
+void SceneSystem_ReleaseUnit(SceneSystem* world, Unit* unit)
+{
+    if (unit->dead)
+        return;
+    
+    unit->dead = 1;
+    SceneFree_Push(&world->freeUnits, unit->index);
+}
+
+void SceneSystem_ReleaseProp(SceneSystem* world, Prop* prop)
+{
+    if (prop->dead)
+        return;
+    
+    prop->dead = 1;
+    SceneFree_Push(&world->freeProps, prop->index);
+}
+
+SceneHandle SceneSystem_UnitHandle(const SceneSystem* world, const Unit* unit)
+{
+    // units of another scene have no handle in this one
+    if (!unit || unit->index < 0 || unit->index >= world->unitCapacity || unit != world->units + unit->index)
+        return SceneHandle_None;
+    
+    SceneHandle handle;
+    handle.index = unit->index;
+    handle.generation = unit->generation;
+    return handle;
+}
+
+SceneHandle SceneSystem_PropHandle(const SceneSystem* world, const Prop* prop)
+{
+    if (!prop || prop->index < 0 || prop->index >= world->propCapacity || prop != world->props + prop->index)
+        return SceneHandle_None;
+    
+    SceneHandle handle;
+    handle.index = prop->index;
+    handle.generation = prop->generation;
+    return handle;
+}
+
+Unit* SceneSystem_UnitFromHandle(SceneSystem* world, SceneHandle handle)
+{
+    if (handle.index < 0 || handle.index >= world->unitCapacity)
+        return NULL;
+    
+    Unit* unit = world->units + handle.index;
+    return (unit->generation == handle.generation) ? unit : NULL;
+}
+
+Prop* SceneSystem_PropFromHandle(SceneSystem* world, SceneHandle handle)
+{
+    if (handle.index < 0 || handle.index >= world->propCapacity)
+        return NULL;
+    
+    Prop* prop = world->props + handle.index;
+    return (prop->generation == handle.generation) ? prop : NULL;
+}
+
 void SceneSystem_Clear(SceneSystem* world)
 {
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+    for (int i = 0; i < world->unitCapacity; ++i)
+    {
         world->units[i].dead = 1;
+        NavPath_Shutdown(&world->units[i].path);
+        SkelModelInstance_Clear(&world->units[i].skelModel);
+    }
     
-    for (int i = 0; i < SCENE_SYSTEM_PROPS_MAX; ++i)
+    for (int i = 0; i < world->propCapacity; ++i)
+    {
         world->props[i].dead = 1;
+        StaticModelInstance_Clear(&world->props[i].model);
+    }
+    
+    SceneFree_Fill(&world->freeUnits, world->unitCapacity);
+    SceneFree_Fill(&world->freeProps, world->propCapacity);
 
+    SceneTouch_Reset(&world->touchGrid, world->propCapacity);
+    SceneIdentifiers_Reset(&world->identifiers);
+    world->hot.liveUnitCount = 0;
+    world->hot.livePropCount = 0;
     world->chunkCount = 0;
 }
 
+static int SceneTouch_Bucket(int x, int y)
+{
+    uint32_t hash = ((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u);
+    return (int)(hash & (SCENE_TOUCH_BUCKETS - 1));
+}
+
+static void SceneTouch_CellRange(AABB bounds, int* outCells)
+{
+    outCells[0] = (int)floorf(CLAMP(bounds.min.x, -SCENE_TOUCH_COORD_MAX, SCENE_TOUCH_COORD_MAX) / SCENE_TOUCH_CELL_SIZE);
+    outCells[1] = (int)floorf(CLAMP(bounds.min.y, -SCENE_TOUCH_COORD_MAX, SCENE_TOUCH_COORD_MAX) / SCENE_TOUCH_CELL_SIZE);
+    outCells[2] = (int)floorf(CLAMP(bounds.max.x, -SCENE_TOUCH_COORD_MAX, SCENE_TOUCH_COORD_MAX) / SCENE_TOUCH_CELL_SIZE);
+    outCells[3] = (int)floorf(CLAMP(bounds.max.y, -SCENE_TOUCH_COORD_MAX, SCENE_TOUCH_COORD_MAX) / SCENE_TOUCH_CELL_SIZE);
+}
+
+// stops counting past max
+static int SceneTouch_CellCount(const int* cells, int max)
+{
+    int width = cells[2] - cells[0] + 1;
+    int height = cells[3] - cells[1] + 1;
+    
+    if (width > max || height > max) return max + 1;
+    return width * height;
+}
+
+static void SceneTouch_SetBits(SceneTouchGrid* grid, int propIndex, int set)
+{
+    unsigned int bit = 1u << (propIndex % 32);
+    int word = propIndex / 32;
+    const int* cells = grid->propCells[propIndex];
+    int words = grid->words;
+    
+    switch (grid->propPlacements[propIndex])
+    {
+        case kSceneTouchCells:
+            for (int y = cells[1]; y <= cells[3]; ++y)
+            {
+                for (int x = cells[0]; x <= cells[2]; ++x)
+                {
+                    unsigned int* mask = grid->buckets + SceneTouch_Bucket(x, y) * words;
+                    
+                    if (set)
+                        mask[word] |= bit;
+                    else
+                        mask[word] &= ~bit;
+                }
+            }
+            break;
+        case kSceneTouchLarge:
+            if (set)
+                grid->large[word] |= bit;
+            else
+                grid->large[word] &= ~bit;
+            break;
+        default:
+            break;
+    }
+}
+
+void SceneSystem_UpdateTouch(SceneSystem* world, const Prop* prop)
+{
+    SceneTouchGrid* grid = &world->touchGrid;
+    int propIndex = prop->index;
+    
+    int cells[4] = { 0, 0, -1, -1 };
+    char placement = kSceneTouchNone;
+    
+    if (!prop->dead)
+    {
+        SceneTouch_CellRange(prop->bounds, cells);
+        
+        if (SceneTouch_CellCount(cells, SCENE_TOUCH_CELLS_MAX) > SCENE_TOUCH_CELLS_MAX)
+            placement = kSceneTouchLarge;
+        else
+            placement = kSceneTouchCells;
+    }
+    
+    if (placement == grid->propPlacements[propIndex])
+    {
+        if (placement != kSceneTouchCells || memcmp(cells, grid->propCells[propIndex], sizeof(cells)) == 0)
+            return;
+    }
+    
+    SceneTouch_SetBits(grid, propIndex, 0);
+    memcpy(grid->propCells[propIndex], cells, sizeof(cells));
+    grid->propPlacements[propIndex] = placement;
+    SceneTouch_SetBits(grid, propIndex, 1);
+}
+
+void SceneSystem_UpdateTouches(SceneSystem* world)
+{
+    for (int i = 0; i < world->propCapacity; ++i)
+        SceneSystem_UpdateTouch(world, world->props + i);
+}
+
+int SceneSystem_TouchCandidates(SceneSystem* world, AABB bounds, int firstProp, const int** outProps)
+{
+    SceneTouchGrid* grid = &world->touchGrid;
+    int words = grid->words;
+    
+    unsigned int* mask = grid->mask;
+    memcpy(mask, grid->large, sizeof(unsigned int) * words);
+    
+    int cells[4];
+    SceneTouch_CellRange(bounds, cells);
+    
+    if (SceneTouch_CellCount(cells, SCENE_TOUCH_BUCKETS) > SCENE_TOUCH_BUCKETS)
+    {
+        // reading every bucket costs more than testing every prop
+        memset(mask, 0xFF, sizeof(unsigned int) * words);
+    }
+    else
+    {
+        for (int y = cells[1]; y <= cells[3]; ++y)
+        {
+            for (int x = cells[0]; x <= cells[2]; ++x)
+            {
+                const unsigned int* bucket = grid->buckets + SceneTouch_Bucket(x, y) * words;
+                
+                for (int w = firstProp / 32; w < words; ++w)
+                    mask[w] |= bucket[w];
+            }
+        }
+    }
+    
+    int count = 0;
+    
+    for (int w = firstProp / 32; w < words; ++w)
+    {
+        unsigned int bits = mask[w];
+        
+        if (w == firstProp / 32)
+            bits &= ~0u << (firstProp % 32);
+        
+        for (int b = 0; bits != 0; ++b, bits >>= 1)
+        {
+            int i = w * 32 + b;
+            
+            if ((bits & 1) && i < world->propCapacity)
+                grid->candidates[count++] = i;
+        }
+    }
+    
+    *outProps = grid->candidates;
+    return count;
+}
+
+void SceneSystem_UpdateHot(SceneSystem* world)
+{
+    SceneHot* hot = &world->hot;
+    
+    int count = 0;
+    for (int i = 0; i < world->unitCapacity; ++i)
+    {
+        const Unit* unit = world->units + i;
+        if (unit->dead) continue;
+        
+        hot->liveUnits[count] = i;
+        hot->unitPositions[count] = unit->position;
+        hot->unitBounds[count] = unit->bounds;
+        hot->unitPlayerIds[count] = unit->playerId;
+        hot->unitViewRadii[count] = unit->viewRadius;
+        hot->unitFlags[count] = (unit->state == kUnitStateDead) ? kSceneHotDying : kSceneHotNone;
+        ++count;
+    }
+    
+    hot->liveUnitCount = count;
+    
+    count = 0;
+    for (int i = 0; i < world->propCapacity; ++i)
+    {
+        const Prop* prop = world->props + i;
+        if (prop->dead) continue;
+        
+        unsigned char flags = kSceneHotNone;
+        
+        if (prop->inactive)
+            flags |= kSceneHotInactive;
+        
+        if (!prop->visible || !prop->model.shared)
+            flags |= kSceneHotHidden;
+        
+        hot->liveProps[count] = i;
+        hot->propPositions[count] = prop->position;
+        hot->propBounds[count] = prop->bounds;
+        hot->propPlayerIds[count] = prop->playerId;
+        hot->propFlags[count] = flags;
+        ++count;
+    }
+    
+    hot->livePropCount = count;
+}
 
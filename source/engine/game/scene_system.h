@@ -7,8 +7,11 @@
 #include "unit.h"
 #include "prop.h"
 
-#define SCENE_SYSTEM_PROPS_MAX 96
-#define SCENE_SYSTEM_UNITS_MAX 48
+// capacity of levels that don't set their own, see SceneSystem_Reserve
+#define SCENE_SYSTEM_PROPS_DEFAULT 96
+#define SCENE_SYSTEM_UNITS_DEFAULT 48
+#define SCENE_SYSTEM_PROPS_LIMIT 4096
+#define SCENE_SYSTEM_UNITS_LIMIT 1024
 #define SCENE_SYSTEM_CHUNKS_MAX 12
 #define SCENE_SYSTEM_LIGHT_MAX 64
 
@@ -47,6 +50,109 @@ typedef struct
     AABB bounds;
 } Chunk;
 
+// about the size of a unit, most props are in one to four cells
+#define SCENE_TOUCH_CELL_SIZE 8.0f
+#define SCENE_TOUCH_BUCKETS 256
+// props covering more cells than this, like acid pools, are in every query instead
+#define SCENE_TOUCH_CELLS_MAX 16
+
+typedef enum
+{
+    kSceneTouchNone = 0,
+    kSceneTouchCells,
+    kSceneTouchLarge,
+} SceneTouchPlacement;
+
+/*
+ Broadphase for props touching props and units.
+ The ground is split into cells hashed into buckets, and each bucket has a bit
+ for every prop overlapping one of its cells. Candidates are read out of the bits
+ in prop index order, the same order touches have always been sent in.
+ A prop's bits only change when its bounds move into different cells.
+ */
+
+typedef struct
+{
+    // words of prop bits in each mask, enough for the prop capacity
+    int words;
+    
+    // SCENE_TOUCH_BUCKETS masks, one after another
+    unsigned int* buckets;
+    unsigned int* large;
+    
+    // min x, min y, max x and max y of the cells each prop is in
+    int (*propCells)[4];
+    char* propPlacements;
+    
+    // filled by SceneSystem_TouchCandidates
+    unsigned int* mask;
+    int* candidates;
+} SceneTouchGrid;
+
+typedef enum
+{
+    kSceneHotNone = 0,
+    // units
+    kSceneHotDying = 1 << 0,
+    // props
+    kSceneHotInactive = 1 << 1,
+    kSceneHotHidden = 1 << 2,
+} SceneHotFlags;
+
+/*
+ Copies of the unit and prop fields read by loops over the whole scene,
+ such as the fog view and culling, packed so they don't stride across whole entities.
+ Entry i of each array is for the live unit or prop liveUnits[i] or liveProps[i].
+ The units and props are still the real data, this is a snapshot
+ from the last SceneSystem_UpdateHot.
+ */
+
+typedef struct
+{
+    // indices of units and props that are not dead, in index order
+    int* liveUnits;
+    int liveUnitCount;
+    
+    int* liveProps;
+    int livePropCount;
+    
+    // each sized to the unit or prop capacity
+    Vec3* unitPositions;
+    AABB* unitBounds;
+    int* unitPlayerIds;
+    int* unitViewRadii;
+    unsigned char* unitFlags;
+    
+    Vec3* propPositions;
+    AABB* propBounds;
+    int* propPlayerIds;
+    unsigned char* propFlags;
+} SceneHot;
+
+/* Level identifiers hashed to the props that have them, built once a level has loaded.
+ Each bucket chains props in index order, so the first match is the same prop
+ a scan over every prop would find. */
+
+typedef struct
+{
+    // power of two, first prop in each bucket or -1
+    int* buckets;
+    int bucketCount;
+    
+    // by prop index, the next prop in the same bucket or -1
+    int* next;
+} SceneIdentifierIndex;
+
+/* Free slots as a binary min heap.
+ Spawns take the lowest free index, the same slot the old scan for a dead one found,
+ so units and props still tick in the same order. */
+
+typedef struct
+{
+    int* slots;
+    int count;
+} SceneFreeList;
+
 struct Engine;
 
 typedef struct
@@ -61,14 +167,33 @@ typedef struct
     Light lights[SCENE_SYSTEM_LIGHT_MAX];
     int lightCount;
         
-    Unit units[SCENE_SYSTEM_UNITS_MAX];
-    Prop props[SCENE_SYSTEM_PROPS_MAX];
+    Unit* units;
+    int unitCapacity;
+    
+    Prop* props;
+    int propCapacity;
+    
+    SceneFreeList freeUnits;
+    SceneFreeList freeProps;
+    
+    // joints for each unit's skeleton pose, one slot per unit, sized when assets load
+    SkelPosePool unitPoses;
+    
+    SceneTouchGrid touchGrid;
+    SceneHot hot;
+    SceneIdentifierIndex identifiers;
         
     const SpawnTable* handler;
     
 } SceneSystem;
 
 extern void SceneSystem_Init(SceneSystem* sceneSystem, struct Engine* engine, const SpawnTable* handler);
+extern void SceneSystem_Shutdown(SceneSystem* world);
+
+/* sizes the units and props for a level, up to SCENE_SYSTEM_UNITS_LIMIT and SCENE_SYSTEM_PROPS_LIMIT.
+   The scene must be empty, as after SceneSystem_Clear, returns 0 if it is not.
+   Also returns 0 if out of memory, leaving a scene with no room for anything. */
+extern int SceneSystem_Reserve(SceneSystem* world, int unitCapacity, int propCapacity);
 
 /* units */
 extern Unit* SceneSystem_SpawnUnit(SceneSystem* world, UnitType type);
@@ -77,6 +202,9 @@ extern Unit* SceneSystem_FindUnitType(SceneSystem* world, UnitType type, int pla
 extern void SceneSystem_Select(SceneSystem* world, int entityId);
 extern void SceneSystem_ClearSelection(SceneSystem* world);
 
+/* marks the unit dead and frees its slot for the next spawn, does nothing if it is already dead */
+extern void SceneSystem_ReleaseUnit(SceneSystem* world, Unit* unit);
+
 /* props */
 extern Prop* SceneSystem_SpawnProp(SceneSystem* world, PropType type);
 extern Prop* SceneSystem_SpawnPropAt(SceneSystem* world,
@@ -93,8 +221,38 @@ extern Prop* SceneSystem_SpawnPropDetail(SceneSystem* world,
                                          Vec3 spawnEuler,
                                          int flags);
 
+/* live prop with the level identifier, only props placed by the level have one */
 extern Prop* SceneSystem_FindProp(SceneSystem* world, const char* identifier);
 
+/* hashes the identifiers of props placed by the level, and points each prop's
+   event triggers at their targets so firing them does no lookups.
+   The level loader calls this once every prop is in. */
+extern void SceneSystem_IndexIdentifiers(SceneSystem* world);
+
+/* marks the prop dead and frees its slot, without sending kEventDie like Prop_Kill */
+extern void SceneSystem_ReleaseProp(SceneSystem* world, Prop* prop);
+
+/* handles, SceneHandle_None for NULL or an entity of another scene */
+extern SceneHandle SceneSystem_UnitHandle(const SceneSystem* world, const Unit* unit);
+extern SceneHandle SceneSystem_PropHandle(const SceneSystem* world, const Prop* prop);
+/* NULL once the slot has been spawned into again, a unit that died since is still returned */
+extern Unit* SceneSystem_UnitFromHandle(SceneSystem* world, SceneHandle handle);
+extern Prop* SceneSystem_PropFromHandle(SceneSystem* world, SceneHandle handle);
+
+/* moves the prop to its bounds in the touch grid, or takes it out if it is dead.
+   Spawning and ticking a prop does this, call it after moving a prop anywhere else. */
+extern void SceneSystem_UpdateTouch(SceneSystem* world, const Prop* prop);
+extern void SceneSystem_UpdateTouches(SceneSystem* world);
+
+/* props that may overlap bounds, from firstProp on, in index order.
+   outProps points into the grid and is good until the next call. Their bounds still need testing. */
+extern int SceneSystem_TouchCandidates(SceneSystem* world, AABB bounds, int firstProp, const int** outProps);
+
+/* copies the units and props into world->hot.
+   The engine does this after units and props tick, call it before reading hot
+   if units or props may have changed since. */
+extern void SceneSystem_UpdateHot(SceneSystem* world);
+
 extern void SceneSystem_Clear(SceneSystem* world);
 
 
@@ -9,7 +9,7 @@ void Unit_Init(Unit* unit, struct Engine* engine, int index)
     unit->crewIndex = -1;
     unit->engine = engine;
         
-    unit->target = NULL;
+    unit->target = SceneHandle_None;
     
     unit->hp = 100;
     
@@ -38,12 +38,17 @@ void Unit_Init(Unit* unit, struct Engine* engine, int index)
     unit->secondaryWeapon = -1;
     
     unit->weaponProp = NULL;
+    SkelModelInstance_Init(&unit->skelModel);
     unit->actionProp = NULL;
     
     unit->angle = 0.0;
     unit->targetAngle = 0.0;
     unit->navPoly = NULL;
     
+    unit->velocity = Vec2_Zero;
+    unit->avoidVelocity = Vec2_Zero;
+    unit->avoiding = 0;
+    
     unit->dead = 1;
     
     unit->user1 = -1;
@@ -57,7 +62,9 @@ void Unit_Init(Unit* unit, struct Engine* engine, int index)
 
 void Unit_Kill(Unit* unit)
 {
-    unit->dead = 1;
+    SceneSystem_ReleaseUnit(&unit->engine->sceneSystem, unit);
+    NavSystem_CancelPlan(&unit->engine->navSystem, &unit->path);
+    NavPath_Shutdown(&unit->path);
     
     if (unit->onKill)
         unit->onKill(unit);
@@ -66,34 +73,75 @@ void Unit_Kill(Unit* unit)
         Prop_Kill(unit->weaponProp);
 }
 
-int Unit_StartPath(Unit* unit, Vec3 destination)
+int Unit_StartPath(Unit* unit, Vec3 destination, int pathFlags)
 {
     Ray3 targetRay = Ray3_Create(Vec3_Add(destination, Vec3_Create(0.0f, 0.0f, 1.0f)), Vec3_Create(0.0f, 0.0f, -1.0f));
         
     const NavPoly* start = unit->navPoly;
     
     if (!start) return 0;
-
+    
+    NavSystem* navSystem = &unit->engine->navSystem;
+    
     NavRaycastResult hitInfo;
-    if (!NavSystem_Raycast(&unit->engine->navSystem, targetRay, &hitInfo))
+    if (!NavSystem_Raycast(navSystem, targetRay, &hitInfo))
         return 0;
     
-    NavSystem_FindPath(&unit->engine->navSystem,
-                       2.0f,
-                       unit->position,
-                       destination,
-                       unit->navPoly,
-                       hitInfo.poly,
-                       &unit->path);
-    
-    unit->state = kUnitStateMove;
     unit->pathIndex = 1;
+    unit->velocity = Vec2_Zero;
+    
+    if (pathFlags & kUnitPathFlagShared)
+    {
+        // no planning, a path being planned for this unit is stale
+        NavSystem_CancelPlan(navSystem, &unit->path);
+        
+        if (!NavSystem_FindFlowPath(navSystem, 2.0f, unit->position, destination, unit->navPoly, hitInfo.poly, &unit->path))
+            NavPath_Clear(&unit->path);
+        
+        unit->state = kUnitStateMove;
+        unit->onStartPath(unit);
+        return 1;
+    }
+    
+    NavSolveStatus status = NavSystem_BeginPlan(navSystem,
+                                                2.0f,
+                                                unit->position,
+                                                destination,
+                                                unit->navPoly,
+                                                hitInfo.poly,
+                                                NULL,
+                                                &unit->path);
+    
+    if (status == kNavSolveRunning)
+    {
+        unit->state = kUnitStatePlanPath;
+        return 1;
+    }
     
+    unit->state = kUnitStateMove;
     unit->onStartPath(unit);
     
     return 1;
 }
 
+void Unit_PlanPath(Unit* unit)
+{
+    NavSystem* navSystem = &unit->engine->navSystem;
+    
+    // another path was started since
+    if (navSystem->planner.outPath != &unit->path)
+    {
+        unit->state = kUnitStateIdle;
+        return;
+    }
+    
+    if (NavSystem_StepPlan(navSystem, NAV_PLAN_EXPANSIONS_PER_TICK) == kNavSolveRunning)
+        return;
+    
+    unit->state = kUnitStateMove;
+    unit->onStartPath(unit);
+}
+
 void Unit_Damage(Unit* unit,
                  Prop* other,
                  int damage,
@@ -103,18 +151,53 @@ void Unit_Damage(Unit* unit,
         unit->onDamage(unit, other, damage, damageType);
 }
 
-int Unit_FollowPath(Unit* unit)
+// a unit this close to a path node steps onto it
+#define UNIT_CLOSE_ENOUGH_DIST 0.15f
+
+int Unit_PathVelocity(const Unit* unit, Vec2* outVelocity)
 {
-    if (unit->moveCounter <= 0.0f)
+    if (unit->moveCounter <= 0.0f || unit->pathIndex >= unit->path.nodeCount)
+        return 0;
+    
+    Vec3 dir = Vec3_Sub(unit->path.nodes[unit->pathIndex].point, unit->position);
+    
+    if (Vec2_LengthSq(Vec2_FromVec3(dir)) > UNIT_CLOSE_ENOUGH_DIST * UNIT_CLOSE_ENOUGH_DIST)
+        *outVelocity = Vec2_Scale(Vec2_FromVec3(Vec3_Norm(dir)), unit->speed);
+    else
+        *outVelocity = Vec2_Zero;
+    
+    return 1;
+}
+
+/* steering around other units must not walk off the edge of the mesh */
+static int Unit_StepOnMesh(const Unit* unit, Vec2 step)
+{
+    if (!unit->navPoly)
+        return 0;
+    
+    Vec3 castPoint = Vec3_Add(unit->position, Vec3_Create(step.x, step.y, 2.0f));
+    
+    NavRaycastResult hitInfo;
+    return NavSystem_LocatePoint(&unit->engine->navSystem, unit->navPoly, castPoint, &hitInfo);
+}
+
+static int Unit_StepPath(Unit* unit)
+{
+    int avoiding = unit->avoiding;
+    unit->avoiding = 0;
+    
+    if (unit->moveCounter <= 0.0f || unit->pathIndex >= unit->path.nodeCount)
     {
         return 0;
     }
     
-    if (unit->target)
+    const Unit* target = Unit_Target(unit);
+    
+    if (target)
     {
-        float minDist = unit->radius + unit->target->radius;
+        float minDist = unit->radius + target->radius;
         
-        if (Vec3_DistSq(unit->position, unit->target->position) <= minDist * minDist)
+        if (Vec3_DistSq(unit->position, target->position) <= minDist * minDist)
             return 0;
     }
     
@@ -122,9 +205,7 @@ int Unit_FollowPath(Unit* unit)
     Vec3 dest = unit->path.nodes[unit->pathIndex].point;
     Vec3 dir = Vec3_Sub(dest, unit->position);
     
-    const float closeEnoughDist = 0.15f;
-    
-    if (Vec2_LengthSq(Vec2_FromVec3(dir)) > closeEnoughDist * closeEnoughDist)
+    if (Vec2_LengthSq(Vec2_FromVec3(dir)) > UNIT_CLOSE_ENOUGH_DIST * UNIT_CLOSE_ENOUGH_DIST)
     {
         unit->targetAngle = RAD_TO_DEG(atan2(dir.y, dir.x));
         
@@ -138,10 +219,15 @@ int Unit_FollowPath(Unit* unit)
             unit->angle = Deg_Normalize(unit->angle + CLAMP(angleDiff, -UNIT_ANGLE_SPEED, UNIT_ANGLE_SPEED));
         }
         
-        dir = Vec3_Norm(dir);
-        float z = unit->position.z;
-        unit->position = Vec3_Add(unit->position, Vec3_Scale(dir, unit->speed));
-        unit->position.z = z;
+        Vec2 step = Vec2_FromVec3(Vec3_Scale(Vec3_Norm(dir), unit->speed));
+        
+        if (avoiding && Unit_StepOnMesh(unit, unit->avoidVelocity))
+            step = unit->avoidVelocity;
+        
+        unit->position = Vec3_Add(unit->position, Vec3_FromVec2(step));
+        unit->velocity = step;
+        
+        // a unit held up by others still spends its move, so the turn always ends
         unit->moveCounter -= unit->speed;
     }
     else
@@ -161,11 +247,23 @@ int Unit_FollowPath(Unit* unit)
     return 1;
 }
 
+int Unit_FollowPath(Unit* unit)
+{
+    if (Unit_StepPath(unit))
+        return 1;
+    
+    // the move is over, idle units don't hold on to path memory
+    NavPath_Shutdown(&unit->path);
+    return 0;
+}
+
 void Unit_CancelMove(Unit* unit)
 {
-    unit->target = NULL;
+    unit->target = SceneHandle_None;
     unit->pathIndex = 0;
     unit->state = kUnitStateIdle;
+    NavSystem_CancelPlan(&unit->engine->navSystem, &unit->path);
+    NavPath_Shutdown(&unit->path);
 }
 
 void Unit_SetName(Unit* unit, const char* name)
@@ -173,6 +271,16 @@ void Unit_SetName(Unit* unit, const char* name)
     strncpy(unit->name, name, UNIT_NAME_MAX);
 }
 
+Unit* Unit_Target(const Unit* unit)
+{
+    return SceneSystem_UnitFromHandle(&unit->engine->sceneSystem, unit->target);
+}
+
+void Unit_SetTarget(Unit* unit, const Unit* target)
+{
+    unit->target = SceneSystem_UnitHandle(&unit->engine->sceneSystem, target);
+}
+
 int Unit_CanSee(const Unit* unit, const Unit* other, float range)
 {
     Vec3 direction = Vec3_Sub(other->position, unit->position);
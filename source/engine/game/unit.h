@@ -6,6 +6,7 @@
 #include "nav.h"
 #include "skel_model.h"
 #include "prop.h"
+#include "scene_handle.h"
 
 typedef enum
 {
@@ -18,8 +19,15 @@ typedef enum
     kUnitStateTeleport,     // for witch/boss
     kUnitStateDead,
     kUnitStateHurt,
+    kUnitStatePlanPath,     // waiting for the nav system to find a path
 } UnitState;
 
+typedef enum
+{
+    kUnitPathFlagNone = 0,
+    kUnitPathFlagShared = 1 << 0,   // read from a flow field shared by units heading to the same place
+} UnitPathFlag;
+
 struct Engine;
 
 typedef struct Unit
@@ -27,6 +35,8 @@ typedef struct Unit
     struct Engine* engine;
     
     int index;
+    // bumped each time a unit spawns into this slot, see SceneHandle
+    unsigned int generation;
     char name[UNIT_NAME_MAX];
     UnitType type;
     int dead;
@@ -45,12 +55,19 @@ typedef struct Unit
     float targetAngle;
     AABB bounds;
         
-    struct Unit* target;
+    // the unit being moved toward, read with Unit_Target
+    SceneHandle target;
     const NavPoly* navPoly;
     
     NavPath path;
     int pathIndex;
     
+    // how far the unit moved last tick
+    Vec2 velocity;
+    // from the avoidance solve this tick, used by the next step along the path
+    Vec2 avoidVelocity;
+    int avoiding;
+    
     int doneForTurn;
     int actionCounter;
     
@@ -63,7 +80,7 @@ typedef struct Unit
     int viewRadius;
     int viewAngle;
     
-    SkelModel skelModel;
+    SkelModelInstance skelModel;
     
     Prop* weaponProp;
     Prop* actionProp;
@@ -102,8 +119,12 @@ typedef struct Unit
 extern void Unit_Init(Unit* unit, struct Engine* engine, int index);
 extern void Unit_Kill(Unit* unit);
 
-extern int Unit_StartPath(Unit* unit, Vec3 dest);
+extern int Unit_StartPath(Unit* unit, Vec3 dest, int pathFlags);
 extern int Unit_FollowPath(Unit* unit);
+/* the velocity this tick's step along the path would take, returns 0 if the unit is not following one */
+extern int Unit_PathVelocity(const Unit* unit, Vec2* outVelocity);
+/* spends this tick's budget on the path, and starts moving once it is found */
+extern void Unit_PlanPath(Unit* unit);
 
 extern void Unit_Damage(Unit* unit,
                         Prop* other,
@@ -112,6 +133,10 @@ extern void Unit_Damage(Unit* unit,
 
 extern void Unit_SetName(Unit* unit, const char* name);
 
+/* NULL if there is no target, or its slot has been spawned into again */
+extern Unit* Unit_Target(const Unit* unit);
+extern void Unit_SetTarget(Unit* unit, const Unit* target);
+
 
 extern int Unit_CanSee(const Unit* unit, const Unit* other, float range);
 
@@ -1,6 +1,7 @@
 
 #include "nav.h"
 #include <stdlib.h>
+#include <limits.h>
 #include "stretchy_buffer.h"
 #include "platform.h"
 #include <assert.h>
@@ -23,30 +24,45 @@
  - http://digestingduck.blogspot.com/
  */
 
-static float TriArea(const Vec3* a, const Vec3* b, const Vec3* c)
+void NavPath_Init(NavPath* path)
 {
-    float ax = b->x - a->x;
-    float ay = b->y - a->y;
-    float bx = c->x - a->x;
-    float by = c->y - a->y;
-    return bx * ay - ax * by;
+    path->nodeCount = 0;
+    path->nodeCapacity = 0;
+    path->nodes = NULL;
 }
 
-static int VecEqual(const Vec3* a, const Vec3* b)
+void NavPath_Shutdown(NavPath* path)
 {
-    static const float eq = 0.001f*0.001f;
-    return ((a->x - b->x) * (a->x - b->x) + (a->y - b->y) * (a->y - b->y)) < eq;
+    if (path->nodes)
+        free(path->nodes);
+    
+    NavPath_Init(path);
 }
 
-void NavPath_Init(NavPath* path)
+int NavPath_Reserve(NavPath* path, int nodeCount)
 {
-    path->nodeCount = 0;
-    memset(path->nodes, 0x0, sizeof(path->nodes));
+    if (nodeCount <= path->nodeCapacity)
+        return 1;
+    
+    int capacity = MAX(path->nodeCapacity * 2, 16);
+    
+    while (capacity < nodeCount)
+        capacity *= 2;
+    
+    NavPathNode* nodes = realloc(path->nodes, sizeof(NavPathNode) * capacity);
+    
+    if (!nodes)
+        return 0;
+    
+    path->nodes = nodes;
+    path->nodeCapacity = capacity;
+    return 1;
 }
 
 void NavPath_AddNode(NavPath* path, Vec3 position, int edgeIndex, int polyIndex)
 {
-    assert(path->nodeCount + 1 < PATH_MAX_NODES);
+    if (!NavPath_Reserve(path, path->nodeCount + 1))
+        return;
     
     NavPathNode newNode;
     newNode.point = position;
@@ -72,6 +88,9 @@ void NavPath_Clear(NavPath* path)
 void NavPath_Reverse(const NavPath* inPath, NavPath* outPath)
 {
     if (!inPath || !outPath) return;
+    
+    if (!NavPath_Reserve(outPath, inPath->nodeCount))
+        return;
 
     outPath->nodeCount = inPath->nodeCount;
     
@@ -79,6 +98,19 @@ void NavPath_Reverse(const NavPath* inPath, NavPath* outPath)
         outPath->nodes[inPath->nodeCount - (i + 1)] = inPath->nodes[i];
 }
 
+int NavPath_Copy(const NavPath* inPath, NavPath* outPath)
+{
+    if (!NavPath_Reserve(outPath, inPath->nodeCount))
+    {
+        NavPath_Clear(outPath);
+        return 0;
+    }
+    
+    outPath->nodeCount = inPath->nodeCount;
+    memcpy(outPath->nodes, inPath->nodes, sizeof(NavPathNode) * inPath->nodeCount);
+    return 1;
+}
+
 Vec3 NavPath_PointAt(NavPath* path, float distance)
 {
     if (path->nodeCount < 1) return Vec3_Zero;
@@ -107,10 +139,45 @@ Vec3 NavPath_PointAt(NavPath* path, float distance)
 }
 
 
+// every area at cost 1, one per NAV_AREA_COUNT
+static const NavQueryFilter g_navDefaultFilter = {
+    { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+      1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f },
+    ~0u,
+    0,
+};
+
+void NavQueryFilter_Init(NavQueryFilter* filter)
+{
+    *filter = g_navDefaultFilter;
+}
+
+void NavQueryFilter_SetArea(NavQueryFilter* filter, NavArea area, float cost, int include)
+{
+    assert(area >= 0 && area < NAV_AREA_COUNT);
+    
+    filter->areaCosts[area] = cost;
+    
+    if (include)
+        filter->includeAreas |= 1u << area;
+    else
+        filter->includeAreas &= ~(1u << area);
+}
+
 int NavSolver_Init(NavSolver* nav)
 {
     nav->pool = NULL;
-    nav->closed = NULL;
+    nav->state = NULL;
+    nav->heap = NULL;
+    nav->heapCount = 0;
+    
+    nav->filter = &g_navDefaultFilter;
+    nav->status = kNavSolveFailed;
+    nav->startPoly = NULL;
+    nav->endPoly = NULL;
+    nav->refining = 0;
+    nav->expansions = 0;
+    nav->blockedReached = 0;
     
     return 1;
 }
@@ -120,305 +187,764 @@ void NavSolver_Shutdown(NavSolver* nav)
     if (nav->pool)
         stb_sb_free(nav->pool);
     
-    if (nav->closed)
-        stb_sb_free(nav->closed);
+    if (nav->state)
+        stb_sb_free(nav->state);
+    
+    if (nav->heap)
+        stb_sb_free(nav->heap);
     
     nav->pool = NULL;
-    nav->closed = NULL;
+    nav->state = NULL;
+    nav->heap = NULL;
+    nav->heapCount = 0;
 }
 
 void NavSolver_Prepare(NavSolver* nav,
                        const NavMesh* mesh)
 {
-    stb_sb_free(nav->pool);
-    stb_sb_free(nav->closed);
+    NavSolver_Shutdown(nav);
     
-    nav->pool = NULL;
-    nav->closed = NULL;
+    int nodeCount = mesh->polyCount;
+    
+    if (mesh->regions.regionCount > 0)
+        nodeCount += mesh->regions.exitCount + 1;
     
-    stb_sb_add(nav->pool, mesh->polyCount);
-    stb_sb_add(nav->closed, mesh->polyCount);
+    // the open list can never hold more than one entry per node
+    stb_sb_add(nav->pool, nodeCount);
+    stb_sb_add(nav->state, nodeCount);
+    stb_sb_add(nav->heap, nodeCount);
 }
 
+/*
+ The open list is an indexed binary heap.
+ Each search node remembers its slot in the heap,
+ so a cost decrease can sift it up without searching the list.
+ */
 
-/* A* path finding */
-int NavSolver_Solve(NavSolver* nav,
-                    const NavMesh* mesh,
-                    Vec3 startPoint,
-                    Vec3 endPoint,
-                    const NavPoly* startPoly,
-                    const NavPoly* endPoly,
-                    NavPath* outPath)
+static void NavSolver_HeapSet(NavSolver* nav, int slot, int node)
 {
-    if (!nav || !mesh || !startPoly || !endPoly || mesh->polyCount < 1)
-        return 0;
-    
-    NavPath_Clear(outPath);
+    nav->heap[slot] = node;
+    nav->pool[node].heapIndex = slot;
+}
+
+static void NavSolver_HeapUp(NavSolver* nav, int slot)
+{
+    int node = nav->heap[slot];
+    float total = nav->pool[node].total;
     
-    if (startPoly == endPoly)
+    while (slot > 0)
     {
-        // we are already on the same poly, so the path is solved
-        NavPath_AddNode(outPath, startPoint, -1, startPoly->index);
-        NavPath_AddNode(outPath, endPoint, -1, startPoly->index);
-        return 1;
+        int parent = (slot - 1) / 2;
+        
+        if (nav->pool[nav->heap[parent]].total <= total)
+            break;
+        
+        NavSolver_HeapSet(nav, slot, nav->heap[parent]);
+        slot = parent;
     }
     
-    // reset count to 0
-    stb__sbn(nav->pool) = 0;
-    memset(nav->closed, 0, sizeof(char) * stb__sbn(nav->closed));
-    
-    assert(stb__sbn(nav->closed) == mesh->polyCount);
-    
-    struct NavSearchNode* first = stb_sb_add(nav->pool, 1);
-    first->next = -1;
-    first->parent = -1;
-    first->polyIndex = startPoly->index;
-    first->edgeIndex = -1;
-    first->cost = 0.0f;
+    NavSolver_HeapSet(nav, slot, node);
+}
 
-    nav->head = 0;
+static void NavSolver_HeapDown(NavSolver* nav, int slot)
+{
+    int node = nav->heap[slot];
+    float total = nav->pool[node].total;
     
-    while (nav->head != -1)
+    while (1)
     {
-        // pull the first (lowest cost) node from the list
-        struct NavSearchNode* currentNode = nav->pool + nav->head;
+        int child = slot * 2 + 1;
         
-        Vec3 currentPoint = startPoint;
-        if (currentNode->edgeIndex != -1)
+        if (child >= nav->heapCount)
+            break;
+        
+        if (child + 1 < nav->heapCount &&
+            nav->pool[nav->heap[child + 1]].total < nav->pool[nav->heap[child]].total)
         {
-            const NavEdge* edge = mesh->edges + currentNode->edgeIndex;
-            currentPoint = Vec3_Lerp(mesh->vertices[edge->vertices[0]], mesh->vertices[edge->vertices[1]], 0.5f);
+            ++child;
         }
         
-        // move from open list to closed
-        nav->head = currentNode->next;
-        currentNode->next = -1;
-        nav->closed[currentNode->polyIndex] = 1;
+        if (total <= nav->pool[nav->heap[child]].total)
+            break;
+        
+        NavSolver_HeapSet(nav, slot, nav->heap[child]);
+        slot = child;
+    }
+    
+    NavSolver_HeapSet(nav, slot, node);
+}
+
+static void NavSolver_HeapPush(NavSolver* nav, int node)
+{
+    assert(nav->heapCount < stb_sb_count(nav->heap));
+    
+    int slot = nav->heapCount;
+    ++nav->heapCount;
+    
+    NavSolver_HeapSet(nav, slot, node);
+    NavSolver_HeapUp(nav, slot);
+}
+
+static int NavSolver_HeapPop(NavSolver* nav)
+{
+    assert(nav->heapCount > 0);
+    
+    int node = nav->heap[0];
+    nav->pool[node].heapIndex = -1;
+    
+    --nav->heapCount;
+    
+    if (nav->heapCount > 0)
+    {
+        NavSolver_HeapSet(nav, 0, nav->heap[nav->heapCount]);
+        NavSolver_HeapDown(nav, 0);
+    }
+    
+    return node;
+}
+
+/* true if node has not been reached, or cost is a cheaper route to it */
+static int NavSolver_Improves(const NavSolver* nav, int node, float cost)
+{
+    char state = nav->state[node];
+    return state == kNavNodeNew || (state == kNavNodeOpen && cost < nav->pool[node].cost);
+}
 
+/* opens a node, or updates it if already open. Check NavSolver_Improves first */
+static void NavSolver_Open(NavSolver* nav, int node, int parent, int edgeIndex, float cost, float heuristic)
+{
+    struct NavSearchNode* searchNode = nav->pool + node;
+    searchNode->edgeIndex = edgeIndex;
+    searchNode->parent = parent;
+    searchNode->cost = cost;
+    searchNode->total = cost + heuristic;
+    
+    if (nav->state[node] == kNavNodeOpen)
+    {
+        // decrease key
+        NavSolver_HeapUp(nav, searchNode->heapIndex);
+    }
+    else
+    {
+        nav->state[node] = kNavNodeOpen;
+        NavSolver_HeapPush(nav, node);
+    }
+}
+
+/* records the cheapest way a flood found into a blocked node, without opening it */
+static void NavSolver_Border(NavSolver* nav, int node, int parent, int edgeIndex, float cost)
+{
+    struct NavSearchNode* searchNode = nav->pool + node;
+    
+    if (nav->state[node] == kNavNodeBorder && searchNode->cost <= cost)
+        return;
+    
+    searchNode->edgeIndex = edgeIndex;
+    searchNode->parent = parent;
+    searchNode->cost = cost;
+    searchNode->total = cost;
+    searchNode->heapIndex = -1;
+    nav->state[node] = kNavNodeBorder;
+}
+
+/* pulls the lowest cost node from the open list and closes it */
+static int NavSolver_Close(NavSolver* nav)
+{
+    int node = NavSolver_HeapPop(nav);
+    nav->state[node] = kNavNodeClosed;
+    return node;
+}
+
+static Vec3 NavSolver_NodePoint(const NavSolver* nav, const NavMesh* mesh, int polyIndex, Vec3 startPoint)
+{
+    const struct NavSearchNode* node = nav->pool + polyIndex;
+    
+    if (node->edgeIndex == -1)
+        return startPoint;
+    
+    return mesh->links.midpoints[node->edgeIndex];
+}
+
+void NavSolver_CloseAll(NavSolver* nav, const NavMesh* mesh)
+{
+    memset(nav->state, kNavNodeClosed, sizeof(char) * mesh->polyCount);
+}
+
+void NavSolver_Allow(NavSolver* nav, const int* polys, int polyCount)
+{
+    for (int i = 0; i < polyCount; ++i)
+        nav->state[polys[i]] = kNavNodeNew;
+}
+
+/* opens startPoly once node states are set up.
+   Polys under obstacles are blocked so they are never passed through, but the unit may be standing
+   on the start poly, and endPoly is where it was asked to go, so both stay open. */
+static void NavSolver_BeginSearch(NavSolver* nav, const NavMesh* mesh, const NavPoly* startPoly, const NavPoly* endPoly)
+{
+    const NavObstacles* obstacles = &mesh->obstacles;
+    
+    for (int i = 0; i < obstacles->blockedCount; ++i)
+        nav->state[obstacles->blockedPolys[i]] = kNavNodeBlocked;
+    
+    nav->state[startPoly->index] = kNavNodeNew;
+    
+    if (endPoly)
+        nav->state[endPoly->index] = kNavNodeNew;
+    
+    nav->heapCount = 0;
+    NavSolver_Open(nav, startPoly->index, -1, -1, 0.0f, 0.0f);
+}
+
+/* closes up to maxExpansions nodes, not entering polys that cost more than maxCost to reach.
+   Done once endPoly is closed, failed once the open list runs out. */
+static NavSolveStatus NavSolver_Expand(NavSolver* nav,
+                                       const NavMesh* mesh,
+                                       Vec3 startPoint,
+                                       Vec3 endPoint,
+                                       const NavPoly* endPoly,
+                                       float maxCost,
+                                       int maxExpansions)
+{
+    // a flood has no target to guide it
+    float weight = endPoly ? NAV_HEURISTIC_WEIGHT : 0.0f;
+    
+    const NavQueryFilter* filter = nav->filter;
+    unsigned int excludedAreas = ~filter->includeAreas;
+    
+    // only the links are read, the polys and edges are left alone unless edges are filtered
+    const NavLinks* links = &mesh->links;
+    
+    for (int n = 0; n < maxExpansions; ++n)
+    {
+        if (nav->heapCount == 0)
+            return kNavSolveFailed;
+        
+        int current = NavSolver_Close(nav);
+        const struct NavSearchNode* currentNode = nav->pool + current;
+        
+        ++nav->expansions;
+        
         // we found the target
-        if (currentNode->polyIndex == endPoly->index)
+        if (endPoly && current == endPoly->index)
+            return kNavSolveDone;
+        
+        Vec3 currentPoint = NavSolver_NodePoint(nav, mesh, current, startPoint);
+        
+        // the way to each edge is across this poly
+        float areaCost = filter->areaCosts[links->areas[current]];
+        
+        // traverse neighbor connections
+        for (int e = links->edgeStarts[current]; e < links->edgeStarts[current + 1]; ++e)
         {
-            // current node is currently an edge of the destination poly
+            int neighborIndex = links->neighbors[e];
             
-            // construct a path in reverse from end to start
-            NavPath temp;
-            NavPath_Init(&temp);
+            if (neighborIndex == -1)
+                continue;
             
-            // end point (into the middle of the poly)
-            NavPath_AddNode(&temp, endPoint, -1, endPoly->index);
+            char state = nav->state[neighborIndex];
             
-            // middle points
-            const struct NavSearchNode* i = currentNode;
+            if (state == kNavNodeClosed)
+                continue; // this node has already been evaluated
             
-            while (i != NULL && i->polyIndex != startPoly->index)
+            // a search never enters blocked polys, a flood reports what it costs to step onto them
+            if (state >= kNavNodeBlocked && endPoly)
             {
-                assert(i->edgeIndex != -1);
-                const NavEdge* edge = mesh->edges + i->edgeIndex;
-                Vec3 p = Vec3_Lerp(mesh->vertices[edge->vertices[0]], mesh->vertices[edge->vertices[1]], 0.5f);
-                NavPath_AddNode(&temp, p, i->edgeIndex, i->polyIndex);
-
-                assert(i->parent != -1);
-                i = nav->pool + i->parent;
+                ++nav->blockedReached;
+                continue;
             }
             
-            // start point
-            NavPath_AddNode(&temp, startPoint, -1, startPoly->index);
-            NavPath_Reverse(&temp, outPath);
-            return 1;
-        }
-        
-        // traverse neighbor connections
-        const NavPoly* currentPoly = mesh->polys + currentNode->polyIndex;
-        
-        for (int i = 0; i < currentPoly->edgeCount; ++i)
-        {
-            const NavEdge* edge = mesh->edges + currentPoly->edgeStart + i;
-            
-            if (edge->neighborIndex == -1)
+            if ((excludedAreas >> links->areas[neighborIndex]) & 1)
                 continue;
             
-            const NavPoly* neighbor = mesh->polys + edge->neighborIndex;
+            if (filter->excludeFlags && (mesh->edges[e].flags & filter->excludeFlags))
+                continue;
             
-            if (nav->closed[neighbor->index] == 1)
-                continue; // this node has already been evaluated
+            Vec3 edgeCenter = links->midpoints[e];
+            float cost = currentNode->cost + Vec3_Dist(edgeCenter, currentPoint) * areaCost * links->costs[e];
             
-            // find the node if it is already in the open list
-            struct NavSearchNode* toInsert = NULL;
+            if (cost > maxCost)
+                continue;
             
-            if (nav->head != -1)
+            if (state >= kNavNodeBlocked)
             {
-                struct NavSearchNode* node = nav->pool + nav->head;
-                struct NavSearchNode* previous = NULL;
-                
-                while (node)
-                {
-                    if (node->polyIndex == neighbor->index)
-                    {
-                        toInsert = node;
-                        
-                        if (previous)
-                        {
-                            previous->next = toInsert->next;
-                        }
-                        else
-                        {
-                            nav->head = toInsert->next;
-                        }
-                        break;
-                    }
-                    
-                    previous = node;
-                    
-                    if (node->next != -1)
-                    {
-                        node = nav->pool + node->next;
-                    }
-                    else
-                    {
-                        node = NULL;
-                    }
-                }
+                ++nav->blockedReached;
+                NavSolver_Border(nav, neighborIndex, current, e, cost);
+                continue;
             }
-
-            // if we didn't find a slot, allocate from the pool
-            if (!toInsert)
-                toInsert = stb_sb_add(nav->pool, 1);
             
-            Vec3 edgeCenter = Vec3_Lerp(mesh->vertices[edge->vertices[0]], mesh->vertices[edge->vertices[1]], 0.5f);
+            // already open with a cheaper route
+            if (!NavSolver_Improves(nav, neighborIndex, cost))
+                continue;
             
-            float heuristic = Vec3_Dist(edgeCenter, endPoint) * 1.5f;
-            toInsert->cost = currentNode->cost + Vec3_Dist(edgeCenter, currentPoint) + heuristic;
+            float heuristic = Vec3_Dist(edgeCenter, endPoint) * weight;
+            NavSolver_Open(nav, neighborIndex, current, e, cost, heuristic);
+        }
+    }
+    
+    return kNavSolveRunning;
+}
 
-            toInsert->polyIndex = neighbor->index;
-            toInsert->edgeIndex = currentPoly->edgeStart + i;
-            toInsert->parent = (int)(currentNode - nav->pool);
-            toInsert->next = -1;
+/* follows the parents back from a closed endPoly */
+static int NavSolver_BuildPath(const NavSolver* nav,
+                               const NavMesh* mesh,
+                               Vec3 startPoint,
+                               Vec3 endPoint,
+                               const NavPoly* startPoly,
+                               const NavPoly* endPoly,
+                               NavPath* outPath)
+{
+    // count the corridor back to the start, then fill it in place
+    int nodeCount = 2;
+    
+    for (int i = endPoly->index; i != startPoly->index; i = nav->pool[i].parent)
+    {
+        assert(nav->pool[i].parent != -1);
+        ++nodeCount;
+    }
+    
+    if (!NavPath_Reserve(outPath, nodeCount))
+        return 0;
+    
+    NavPathNode* nodes = outPath->nodes;
+    outPath->nodeCount = nodeCount;
+    
+    // start point and end point (into the middle of the poly)
+    nodes[0].point = startPoint;
+    nodes[0].edgeIndex = -1;
+    nodes[0].polyIndex = startPoly->index;
+    
+    nodes[nodeCount - 1].point = endPoint;
+    nodes[nodeCount - 1].edgeIndex = -1;
+    nodes[nodeCount - 1].polyIndex = endPoly->index;
+    
+    // middle points, the edge each poly was entered through
+    int k = nodeCount - 2;
+    
+    for (int i = endPoly->index; i != startPoly->index; i = nav->pool[i].parent, --k)
+    {
+        nodes[k].point = NavSolver_NodePoint(nav, mesh, i, startPoint);
+        nodes[k].edgeIndex = nav->pool[i].edgeIndex;
+        nodes[k].polyIndex = i;
+    }
+    
+    return 1;
+}
 
-            int toInsertIndex = (int)(toInsert - nav->pool);
+/* search, not entering polys that cost more than maxCost to reach */
+static int NavSolver_SearchWithin(NavSolver* nav,
+                                  const NavMesh* mesh,
+                                  Vec3 startPoint,
+                                  Vec3 endPoint,
+                                  const NavPoly* startPoly,
+                                  const NavPoly* endPoly,
+                                  float maxCost,
+                                  NavPath* outPath)
+{
+    NavSolver_BeginSearch(nav, mesh, startPoly, endPoly);
+    
+    if (NavSolver_Expand(nav, mesh, startPoint, endPoint, endPoly, maxCost, INT_MAX) != kNavSolveDone)
+        return 0;
+    
+    return NavSolver_BuildPath(nav, mesh, startPoint, endPoint, startPoly, endPoly, outPath);
+}
 
-            // sorted insertion
-            if (nav->head == -1)
-            {
-                nav->head = toInsertIndex;
-            }
-            else
-            {
-                struct NavSearchNode* node = nav->pool + nav->head;
-                struct NavSearchNode* previous = NULL;
-                
-                int inserted = 0;
-                
-                while (node)
-                {
-                    if (toInsert->cost < node->cost)
-                    {
-                        toInsert->next = (int)(node - nav->pool);
-                        
-                        if (previous)
-                        {
-                            previous->next = toInsertIndex;
-                        }
-                        else
-                        {
-                            nav->head = toInsertIndex;
-                        }
-                        inserted = 1;
-                        break;
-                    }
-                    
-                    previous = node;
-                    
-                    if (node->next != -1)
-                    {
-                        node = nav->pool + node->next;
-                    }
-                    else
-                    {
-                        node = NULL;
-                    }
-                }
-                
-                if (!inserted)
-                {
-                    assert(previous);
-                    previous->next = toInsertIndex;
-                }
-            }
+int NavSolver_Search(NavSolver* nav,
+                     const NavMesh* mesh,
+                     Vec3 startPoint,
+                     Vec3 endPoint,
+                     const NavPoly* startPoly,
+                     const NavPoly* endPoly,
+                     NavPath* outPath)
+{
+    nav->filter = &g_navDefaultFilter;
+    return NavSolver_SearchWithin(nav, mesh, startPoint, endPoint, startPoly, endPoly, INFINITY, outPath);
+}
+
+int NavSolver_Flood(NavSolver* nav,
+                    const NavMesh* mesh,
+                    const NavPoly* startPoly,
+                    Vec3 startPoint,
+                    float maxCost,
+                    const NavQueryFilter* filter,
+                    float* outCosts)
+{
+    if (!nav || !mesh)
+        return 0;
+    
+    memset(nav->state, kNavNodeNew, sizeof(char) * mesh->polyCount);
+    nav->expansions = 0;
+    nav->blockedReached = 0;
+    nav->filter = filter ? filter : &g_navDefaultFilter;
+    
+    // without a start poly nothing is reachable
+    if (startPoly)
+        NavSolver_SearchWithin(nav, mesh, startPoint, startPoint, startPoly, NULL, maxCost, NULL);
+    
+    int reached = 0;
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        if (nav->state[i] == kNavNodeClosed || nav->state[i] == kNavNodeBorder)
+        {
+            outCosts[i] = nav->pool[i].cost;
+            ++reached;
+        }
+        else
+        {
+            outCosts[i] = INFINITY;
         }
     }
+    
+    return reached;
+}
 
-    return 0;
+float NavSolver_FloodCost(const NavSolver* nav,
+                          const NavMesh* mesh,
+                          Vec3 startPoint,
+                          int polyIndex,
+                          Vec3 point)
+{
+    if (nav->state[polyIndex] != kNavNodeClosed && nav->state[polyIndex] != kNavNodeBorder)
+        return INFINITY;
+    
+    return nav->pool[polyIndex].cost + Vec3_Dist(NavSolver_NodePoint(nav, mesh, polyIndex, startPoint), point);
+}
+
+static void NavSolver_AllowRegion(NavSolver* nav, const NavRegions* regions, int regionIndex)
+{
+    const NavRegion* region = regions->regions + regionIndex;
+    NavSolver_Allow(nav, regions->regionPolys + region->polyStart, region->polyCount);
+}
+
+/*
+ Hierarchical A*, over region exits then polys.
+ Exit nodes follow the poly nodes in the pool, and the goal node follows the exits.
+ Leaving through an exit crosses to its twin in the next region,
+ then any exit of that region is reachable for its precomputed cost.
+ Afterward only polys in the regions along the route are open to search.
+ */
+static int NavSolver_PlanRegions(NavSolver* nav,
+                                 const NavMesh* mesh,
+                                 Vec3 startPoint,
+                                 Vec3 endPoint,
+                                 const NavPoly* startPoly,
+                                 const NavPoly* endPoly)
+{
+    const NavRegions* regions = &mesh->regions;
+    
+    int startRegionIndex = regions->polyRegions[startPoly->index];
+    int endRegionIndex = regions->polyRegions[endPoly->index];
+    
+    const NavRegion* startRegion = regions->regions + startRegionIndex;
+    
+    int exitBase = mesh->polyCount;
+    int goal = exitBase + regions->exitCount;
+    
+    // the start and end points are joined to the exits of their regions by straight line costs,
+    // regions are connected so every exit is reachable, and refining finds the real route
+    memset(nav->state + exitBase, kNavNodeNew, sizeof(char) * (regions->exitCount + 1));
+    nav->heapCount = 0;
+    
+    for (int i = startRegion->exitStart; i < startRegion->exitStart + startRegion->exitCount; ++i)
+    {
+        const NavRegionExit* exit = regions->exits + i;
+        float cost = Vec3_Dist(startPoint, exit->point);
+        
+        NavSolver_Open(nav, exitBase + i, -1, -1, cost, Vec3_Dist(exit->point, endPoint) * NAV_HEURISTIC_WEIGHT);
+    }
+    
+    while (nav->heapCount > 0)
+    {
+        int current = NavSolver_Close(nav);
+        
+        if (current == goal)
+            break;
+        
+        const NavRegionExit* exit = regions->exits + (current - exitBase);
+        
+        if (exit->twin == -1)
+            continue;
+        
+        int regionIndex = exit->neighbor;
+        const NavRegion* region = regions->regions + regionIndex;
+        float cost = nav->pool[current].cost;
+        
+        if (regionIndex == endRegionIndex)
+        {
+            float goalCost = cost + Vec3_Dist(exit->point, endPoint);
+            
+            if (NavSolver_Improves(nav, goal, goalCost))
+                NavSolver_Open(nav, goal, current, -1, goalCost, 0.0f);
+        }
+        
+        int from = exit->twin - region->exitStart;
+        const float* costs = regions->costs + region->costStart + from * region->exitCount;
+        
+        for (int i = 0; i < region->exitCount; ++i)
+        {
+            if (i == from || costs[i] == INFINITY)
+                continue;
+            
+            int next = exitBase + region->exitStart + i;
+            float nextCost = cost + costs[i];
+            
+            if (!NavSolver_Improves(nav, next, nextCost))
+                continue;
+            
+            float heuristic = Vec3_Dist(regions->exits[next - exitBase].point, endPoint) * NAV_HEURISTIC_WEIGHT;
+            NavSolver_Open(nav, next, current, -1, nextCost, heuristic);
+        }
+    }
+    
+    if (nav->state[goal] != kNavNodeClosed)
+        return 0;
+    
+    // refine, only searching polys in the regions along the route
+    NavSolver_CloseAll(nav, mesh);
+    
+    for (int i = nav->pool[goal].parent; i != -1; i = nav->pool[i].parent)
+    {
+        const NavRegionExit* exit = regions->exits + (i - exitBase);
+        NavSolver_AllowRegion(nav, regions, exit->region);
+        NavSolver_AllowRegion(nav, regions, exit->neighbor);
+    }
+    
+    return 1;
+}
+
+NavSolveStatus NavSolver_Begin(NavSolver* nav,
+                               const NavMesh* mesh,
+                               Vec3 startPoint,
+                               Vec3 endPoint,
+                               const NavPoly* startPoly,
+                               const NavPoly* endPoly,
+                               const NavQueryFilter* filter)
+{
+    nav->filter = filter ? filter : &g_navDefaultFilter;
+    nav->status = kNavSolveFailed;
+    nav->startPoly = startPoly;
+    nav->endPoly = endPoly;
+    nav->startPoint = startPoint;
+    nav->endPoint = endPoint;
+    nav->refining = 0;
+    nav->expansions = 0;
+    nav->blockedReached = 0;
+    
+    if (!mesh || !startPoly || !endPoly || mesh->polyCount < 1)
+        return nav->status;
+    
+    if (startPoly == endPoly)
+    {
+        // we are already on the same poly, so the path is solved
+        nav->status = kNavSolveDone;
+        return nav->status;
+    }
+    
+    assert(stb_sb_count(nav->state) >= mesh->polyCount);
+    
+    if (mesh->regions.regionCount > 0 && !filter &&
+        mesh->regions.polyRegions[startPoly->index] != mesh->regions.polyRegions[endPoly->index])
+    {
+        if (!NavSolver_PlanRegions(nav, mesh, startPoint, endPoint, startPoly, endPoly))
+            return nav->status;
+        
+        nav->refining = 1;
+    }
+    else
+    {
+        // node contents are only valid once their state leaves kNavNodeNew
+        memset(nav->state, kNavNodeNew, sizeof(char) * mesh->polyCount);
+    }
+    
+    NavSolver_BeginSearch(nav, mesh, startPoly, endPoly);
+    nav->status = kNavSolveRunning;
+    return nav->status;
+}
+
+NavSolveStatus NavSolver_Step(NavSolver* nav,
+                              const NavMesh* mesh,
+                              int maxExpansions)
+{
+    if (nav->status != kNavSolveRunning)
+        return nav->status;
+    
+    nav->status = NavSolver_Expand(nav, mesh, nav->startPoint, nav->endPoint, nav->endPoly, INFINITY, maxExpansions);
+    
+    if (nav->status == kNavSolveFailed && nav->refining)
+    {
+        // the corridor should always connect, but search everything rather than fail
+        nav->refining = 0;
+        memset(nav->state, kNavNodeNew, sizeof(char) * mesh->polyCount);
+        
+        NavSolver_BeginSearch(nav, mesh, nav->startPoly, nav->endPoly);
+        nav->status = kNavSolveRunning;
+    }
+    
+    return nav->status;
+}
+
+int NavSolver_Result(const NavSolver* nav,
+                     const NavMesh* mesh,
+                     NavPath* outPath)
+{
+    NavPath_Clear(outPath);
+    
+    if (nav->status != kNavSolveDone)
+        return 0;
+    
+    if (nav->startPoly == nav->endPoly)
+    {
+        NavPath_AddNode(outPath, nav->startPoint, -1, nav->startPoly->index);
+        NavPath_AddNode(outPath, nav->endPoint, -1, nav->startPoly->index);
+        return 1;
+    }
+    
+    return NavSolver_BuildPath(nav, mesh, nav->startPoint, nav->endPoint, nav->startPoly, nav->endPoly, outPath);
+}
+
+/* A* path finding */
+int NavSolver_Solve(NavSolver* nav,
+                    const NavMesh* mesh,
+                    Vec3 startPoint,
+                    Vec3 endPoint,
+                    const NavPoly* startPoly,
+                    const NavPoly* endPoly,
+                    const NavQueryFilter* filter,
+                    NavPath* outPath)
+{
+    if (!nav)
+        return 0;
+    
+    NavSolver_Begin(nav, mesh, startPoint, endPoint, startPoly, endPoly, filter);
+    
+    while (NavSolver_Step(nav, mesh, INT_MAX) == kNavSolveRunning)
+        continue;
+    
+    return NavSolver_Result(nav, mesh, outPath);
 }
 
 
 /* http://digestingduck.blogspot.com/2010/03/simple-stupid-funnel-algorithm.html */
 /* http://www.koffeebird.com/2014/05/towards-modified-simple-stupid-funnel.html */
 
+// paths up to this long keep their portals on the stack
+#define NAV_SMOOTH_STACK_NODES 256
+
+/* twice the signed area of the triangle between portal points a, b and c in XY */
+static inline float NavFunnel_Area(const float* x, const float* y, int a, int b, int c)
+{
+    return (x[c] - x[a]) * (y[b] - y[a]) - (x[b] - x[a]) * (y[c] - y[a]);
+}
+
+static inline int NavFunnel_Equal(const float* x, const float* y, int a, int b)
+{
+    static const float eq = 0.001f*0.001f;
+    return ((x[a] - x[b]) * (x[a] - x[b]) + (y[a] - y[b]) * (y[a] - y[b])) < eq;
+}
+
 void NavSolver_SmoothPath(const NavMesh* mesh, NavPath* path, float radius)
 {
     // nothing to smooth if there is one point in the path
     if (path->nodeCount <= 1)
         return;
     
-    Vec3 portals[path->nodeCount * 2];
-    int pk = 0;
+    assert(mesh->edgeDirs);
+    
+    int portalCount = path->nodeCount;
+    
+    /* each coordinate is its own array, so offsetting the portals is a straight loop the compiler vectorizes.
+       Portal i has its left point at 2 * i and its right point at 2 * i + 1,
+       and the funnel refers to points by that index */
+    float stackPortals[NAV_SMOOTH_STACK_NODES * 9];
+    float* portals = stackPortals;
+    
+    if (portalCount > NAV_SMOOTH_STACK_NODES)
+    {
+        portals = malloc(sizeof(float) * portalCount * 9);
+        
+        if (!portals)
+            return;
+    }
+    
+    float* restrict pointX = portals;
+    float* restrict pointY = pointX + portalCount * 2;
+    float* restrict pointZ = pointY + portalCount * 2;
+    float* restrict dirX = pointZ + portalCount * 2;
+    float* restrict dirY = dirX + portalCount;
+    float* restrict dirZ = dirY + portalCount;
     
     Vec3 start = path->nodes[0].point;
     Vec3 end = path->nodes[path->nodeCount - 1].point;
     
-    // starting point (no edge width)
-    portals[pk] = start;
-    portals[pk+1] = start;
-    pk += 2;
+    // starting and ending points (no edge width)
+    int last = portalCount - 1;
+    
+    pointX[0] = pointX[1] = start.x;
+    pointY[0] = pointY[1] = start.y;
+    pointZ[0] = pointZ[1] = start.z;
+    dirX[0] = dirY[0] = dirZ[0] = 0.0f;
     
-    for (int i = 1; i < path->nodeCount - 1; ++i)
+    pointX[last * 2] = pointX[last * 2 + 1] = end.x;
+    pointY[last * 2] = pointY[last * 2 + 1] = end.y;
+    pointZ[last * 2] = pointZ[last * 2 + 1] = end.z;
+    dirX[last] = dirY[last] = dirZ[last] = 0.0f;
+    
+    // gather the edge each node crossed
+    for (int i = 1; i < last; ++i)
     {
-        // line edge intersection to find the correct edge
-        const NavEdge* edge = mesh->edges + path->nodes[i].edgeIndex;
+        int edgeIndex = path->nodes[i].edgeIndex;
+        const NavEdge* edge = mesh->edges + edgeIndex;
         
         Vec3 a = mesh->vertices[edge->vertices[0]];
         Vec3 b = mesh->vertices[edge->vertices[1]];
-
-        Vec3 edgeVec = Vec3_Norm(Vec3_Sub(a, b));
+        Vec3 edgeVec = mesh->edgeDirs[edgeIndex];
         
-        portals[pk] = Vec3_Add(b, Vec3_Scale(edgeVec, radius));
-        portals[pk+1] = Vec3_Sub(a, Vec3_Scale(edgeVec, radius));
-        
-        pk += 2;
+        pointX[i * 2] = b.x;
+        pointY[i * 2] = b.y;
+        pointZ[i * 2] = b.z;
+        pointX[i * 2 + 1] = a.x;
+        pointY[i * 2 + 1] = a.y;
+        pointZ[i * 2 + 1] = a.z;
+        dirX[i] = edgeVec.x;
+        dirY[i] = edgeVec.y;
+        dirZ[i] = edgeVec.z;
     }
     
-    // ending point (no edge width)
-    portals[pk] = end;
-    portals[pk + 1] = end;
-    pk+=2;
+    // pull both sides in from the edge ends by radius
+    for (int i = 0; i < portalCount; ++i)
+    {
+        pointX[i * 2] += dirX[i] * radius;
+        pointY[i * 2] += dirY[i] * radius;
+        pointZ[i * 2] += dirZ[i] * radius;
+        pointX[i * 2 + 1] -= dirX[i] * radius;
+        pointY[i * 2 + 1] -= dirY[i] * radius;
+        pointZ[i * 2 + 1] -= dirZ[i] * radius;
+    }
     
     int npts = 0;
-    Vec3 portalApex, portalLeft, portalRight;
+    int portalApex = 0, portalLeft = 0, portalRight = 1;
     int apexIndex = 0, leftIndex = 0, rightIndex = 0;
     
-    portalApex = portals[0];
-    portalLeft = portals[0];
-    portalRight = portals[1];
-    
     path->nodes[npts].point = start;
     ++npts;
     
-    for (int i = 1; i <= path->nodeCount && npts < pk; ++i)
+    // each apex is a distinct portal, so the smoothed path fits in the nodes we have
+    for (int i = 1; i < path->nodeCount && npts < path->nodeCount - 1; ++i)
     {
-        Vec3* left = portals + i * 2;
-        Vec3* right = portals + i * 2 + 1;
+        int left = i * 2;
+        int right = i * 2 + 1;
         
-        if (TriArea(&portalApex, &portalRight, right) <= 0.0f)
+        if (NavFunnel_Area(pointX, pointY, portalApex, portalRight, right) <= 0.0f)
         {
-            if (VecEqual(&portalApex, &portalRight) ||
-                TriArea(&portalApex, &portalLeft, right) > 0.0f)
+            if (NavFunnel_Equal(pointX, pointY, portalApex, portalRight) ||
+                NavFunnel_Area(pointX, pointY, portalApex, portalLeft, right) > 0.0f)
             {
-                portalRight = *right;
+                portalRight = right;
                 rightIndex = i;
             }
             else
             {
-                path->nodes[npts].point = portalLeft;
+                path->nodes[npts].point = Vec3_Create(pointX[portalLeft], pointY[portalLeft], pointZ[portalLeft]);
                 ++npts;
                 
                 portalApex = portalLeft;
@@ -433,17 +959,17 @@ void NavSolver_SmoothPath(const NavMesh* mesh, NavPath* path, float radius)
                 continue;
             }
         }
-        if (TriArea(&portalApex, &portalLeft, left) >= 0.0f)
+        if (NavFunnel_Area(pointX, pointY, portalApex, portalLeft, left) >= 0.0f)
         {
-            if (VecEqual(&portalApex, &portalLeft) ||
-                TriArea(&portalApex, &portalRight, left) < 0.0f)
+            if (NavFunnel_Equal(pointX, pointY, portalApex, portalLeft) ||
+                NavFunnel_Area(pointX, pointY, portalApex, portalRight, left) < 0.0f)
             {
-                portalLeft = *left;
+                portalLeft = left;
                 leftIndex = i;
             }
             else
             {
-                path->nodes[npts].point = portalRight;
+                path->nodes[npts].point = Vec3_Create(pointX[portalRight], pointY[portalRight], pointZ[portalRight]);
                 ++npts;
                 
                 portalApex = portalRight;
@@ -463,6 +989,9 @@ void NavSolver_SmoothPath(const NavMesh* mesh, NavPath* path, float radius)
     ++npts;
     
     path->nodeCount = npts;
+    
+    if (portals != stackPortals)
+        free(portals);
 }
 
 
@@ -4,22 +4,31 @@
 
 #include "nav_mesh.h"
 
-#define PATH_MAX_NODES 128
+// scale on the straight line distance to the target, trades path quality for fewer visited nodes
+#define NAV_HEURISTIC_WEIGHT 1.5f
 
 typedef struct
 {
-    short polyIndex;
-    short edgeIndex;
+    int polyIndex;
+    int edgeIndex;
     Vec3 point;
 } NavPathNode;
 
+/* nodes are heap allocated and grow as needed,
+   so paths have no length limit and empty paths cost nothing */
 typedef struct
 {
     int nodeCount;
-    NavPathNode nodes[PATH_MAX_NODES];
+    int nodeCapacity;
+    NavPathNode* nodes;
 } NavPath;
 
 extern void NavPath_Init(NavPath* path);
+/* frees the nodes, the path can be used again afterwards */
+extern void NavPath_Shutdown(NavPath* path);
+
+/* makes room for nodeCount nodes, returns 0 if out of memory */
+extern int NavPath_Reserve(NavPath* path, int nodeCount);
 
 extern void NavPath_AddNode(NavPath* path, Vec3 position, int edgeIndex, int polyIndex);
 extern NavPathNode* NavPath_NodeAtIndex(NavPath* path, int index);
@@ -27,27 +36,95 @@ extern NavPathNode* NavPath_NodeAtIndex(NavPath* path, int index);
 extern void NavPath_Clear(NavPath* path);
 /* in and out cannot be the same path */
 extern void NavPath_Reverse(const NavPath* inPath, NavPath* outPath);
+/* returns 0 and clears outPath if out of memory */
+extern int NavPath_Copy(const NavPath* inPath, NavPath* outPath);
 
 extern Vec3 NavPath_PointAt(NavPath* path, float distance);
 
 
+/*
+ What a search may cross, and how much it costs.
+ The way across a poly costs its length, scaled by the area cost of the poly
+ and the cost of the edge it leaves through.
+ A NULL filter is the same as one from NavQueryFilter_Init.
+ */
+
+typedef struct
+{
+    // scale on the path cost across polys of each area
+    float areaCosts[NAV_AREA_COUNT];
+    // bit i is set if polys of area i may be entered
+    unsigned int includeAreas;
+    // edges with any of these flags are not crossed
+    unsigned int excludeFlags;
+} NavQueryFilter;
+
+/* every area at cost 1, and every edge open */
+extern void NavQueryFilter_Init(NavQueryFilter* filter);
+
+extern void NavQueryFilter_SetArea(NavQueryFilter* filter, NavArea area, float cost, int include);
+
 struct NavSearchNode
 {
-    short polyIndex;
-    short edgeIndex;
+    // edge the node was entered through, -1 for the start node
+    int edgeIndex;
+    
+    // path cost from the start point
     float cost;
+    // cost plus heuristic, used to order the open list
+    float total;
     
-    // since the pool address is not stable, we need to use indicies
-    int next;
+    // index of the node this one was reached from
     int parent;
+    // position in the open list heap, -1 if not open
+    int heapIndex;
 };
 
+typedef enum
+{
+    kNavNodeNew = 0,
+    kNavNodeOpen,
+    kNavNodeClosed,
+    // under an obstacle, never entered (see NavObstacles)
+    kNavNodeBlocked,
+    // blocked, but next to polys a flood closed. Has the cost to enter it, and is never expanded
+    kNavNodeBorder,
+} NavNodeState;
+
+typedef enum
+{
+    kNavSolveFailed = 0,
+    kNavSolveDone,
+    kNavSolveRunning,
+} NavSolveStatus;
+
 typedef struct
 {
-    int head;
+    // one search node per poly, indexed by poly index.
+    // Meshes with regions add a node per region exit and a goal node after the polys.
     struct NavSearchNode* pool;
-    char* closed;
+    char* state;
     
+    // open list, binary min heap of node indicies ordered by total cost
+    int* heap;
+    int heapCount;
+    
+    // the search started by NavSolver_Begin, never NULL
+    const NavQueryFilter* filter;
+    
+    NavSolveStatus status;
+    const NavPoly* startPoly;
+    const NavPoly* endPoly;
+    Vec3 startPoint;
+    Vec3 endPoint;
+    
+    // searching the corridor found over regions, a full search follows if it fails
+    int refining;
+    // nodes closed since NavSolver_Begin or NavSolver_Flood
+    int expansions;
+    // blocked polys run into since then. A search that met none
+    // found the same path it would have with no obstacles at all
+    int blockedReached;
 } NavSolver;
 
 extern int NavSolver_Init(NavSolver* nav);
@@ -59,6 +136,10 @@ extern void NavSolver_Prepare(NavSolver* nav,
 /*
  pure mathematical - portal to portal path finding.
  A connectivity solution is found. Results are not smoothed,
+ When the mesh has regions and the path crosses between them,
+ the route is found over region exits first and polys are only searched
+ inside the regions along it. Region costs are for the default filter,
+ so searches with a filter always search polys.
  */
 
 extern int NavSolver_Solve(NavSolver* nav,
@@ -67,8 +148,78 @@ extern int NavSolver_Solve(NavSolver* nav,
                            Vec3 endPoint,
                            const NavPoly* startPoly,
                            const NavPoly* endPoly,
+                           const NavQueryFilter* filter,
                            NavPath* outPath);
 
+/*
+ The same search, spread across calls so it can be given a budget each tick.
+ Begin prepares the search, and planning over regions happens all at once.
+ Step closes up to maxExpansions nodes and returns kNavSolveRunning until the search ends.
+ Result fills outPath once the status is kNavSolveDone.
+ The solver must not be used for anything else until the search ends,
+ and the filter must stay valid until then.
+ */
+
+extern NavSolveStatus NavSolver_Begin(NavSolver* nav,
+                                      const NavMesh* mesh,
+                                      Vec3 startPoint,
+                                      Vec3 endPoint,
+                                      const NavPoly* startPoly,
+                                      const NavPoly* endPoly,
+                                      const NavQueryFilter* filter);
+
+extern NavSolveStatus NavSolver_Step(NavSolver* nav,
+                                     const NavMesh* mesh,
+                                     int maxExpansions);
+
+extern int NavSolver_Result(const NavSolver* nav,
+                            const NavMesh* mesh,
+                            NavPath* outPath);
+
+/*
+ Dijkstra from startPoint, for move range and reachability queries.
+ Fills outCosts (one per poly) with the path cost to enter each poly,
+ INFINITY if it cannot be reached within maxCost. Returns how many polys were reached.
+ Polys under obstacles are not crossed, but those next to reached polys
+ get the cost of stepping onto them, so a unit standing on one is still in reach.
+ */
+
+extern int NavSolver_Flood(NavSolver* nav,
+                           const NavMesh* mesh,
+                           const NavPoly* startPoly,
+                           Vec3 startPoint,
+                           float maxCost,
+                           const NavQueryFilter* filter,
+                           float* outCosts);
+
+/*
+ Lower level searches, used to build regions.
+ Search does not reset node state, so polys closed beforehand are never entered.
+ Without an endPoly it floods every poly it can reach and returns 0.
+ */
+
+extern void NavSolver_CloseAll(NavSolver* nav, const NavMesh* mesh);
+extern void NavSolver_Allow(NavSolver* nav, const int* polys, int polyCount);
+
+extern int NavSolver_Search(NavSolver* nav,
+                            const NavMesh* mesh,
+                            Vec3 startPoint,
+                            Vec3 endPoint,
+                            const NavPoly* startPoly,
+                            const NavPoly* endPoly,
+                            NavPath* outPath);
+
+/* path cost from the flood start to a point on a poly, INFINITY if the flood did not reach it */
+extern float NavSolver_FloodCost(const NavSolver* nav,
+                                 const NavMesh* mesh,
+                                 Vec3 startPoint,
+                                 int polyIndex,
+                                 Vec3 point);
+
+/* groups polys into regions so long paths are solved over exits first (see nav_region.h).
+   Call NavSolver_Prepare again afterward. */
+extern int NavMesh_BuildRegions(NavMesh* mesh);
+
 /* create a nice smoothed version of the solved path */
 extern void NavSolver_SmoothPath(const NavMesh* mesh,
                                  NavPath* path,
@@ -0,0 +1,458 @@
+
+#include "nav_avoid.h"
+#include "stretchy_buffer.h"
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#define NAV_AVOID_EPSILON 0.00001f
+
+// most an agent's preferred velocity is turned, in radians, see NavAvoidance_Nudge
+#define NAV_AVOID_NUDGE 0.02f
+
+/* a half plane of allowed velocities, left of the direction through point */
+typedef struct
+{
+    Vec2 point;
+    Vec2 direction;
+} NavAvoidLine;
+
+static inline float Vec2_Det(Vec2 a, Vec2 b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+void NavAvoidance_Init(NavAvoidance* avoidance, float timeHorizon)
+{
+    avoidance->agents = NULL;
+    avoidance->bucketAgents = NULL;
+    avoidance->timeHorizon = timeHorizon;
+    avoidance->cellSize = 1.0f;
+    avoidance->neighborsTested = 0;
+}
+
+void NavAvoidance_Shutdown(NavAvoidance* avoidance)
+{
+    stb_sb_free(avoidance->agents);
+    stb_sb_free(avoidance->bucketAgents);
+
+    avoidance->agents = NULL;
+    avoidance->bucketAgents = NULL;
+}
+
+void NavAvoidance_Clear(NavAvoidance* avoidance)
+{
+    if (avoidance->agents)
+        stb__sbn(avoidance->agents) = 0;
+}
+
+int NavAvoidance_AddAgent(NavAvoidance* avoidance,
+                          Vec2 position,
+                          Vec2 velocity,
+                          Vec2 preferredVelocity,
+                          float radius,
+                          float maxSpeed)
+{
+    NavAgent agent;
+    agent.position = position;
+    agent.velocity = velocity;
+    agent.preferredVelocity = preferredVelocity;
+    agent.radius = radius;
+    agent.maxSpeed = maxSpeed;
+    agent.newVelocity = Vec2_Zero;
+
+    stb_sb_push(avoidance->agents, agent);
+    return stb_sb_count(avoidance->agents) - 1;
+}
+
+static int NavAvoidance_Bucket(int x, int y)
+{
+    uint32_t hash = ((uint32_t)x * 73856093u) ^ ((uint32_t)y * 19349663u);
+    return hash & (NAV_AVOID_BUCKET_COUNT - 1);
+}
+
+static void NavAvoidance_Cell(const NavAvoidance* avoidance, Vec2 position, int* x, int* y)
+{
+    *x = (int)floorf(position.x / avoidance->cellSize);
+    *y = (int)floorf(position.y / avoidance->cellSize);
+}
+
+/* counting sort of the agents into their buckets */
+static void NavAvoidance_BuildHash(NavAvoidance* avoidance, int agentCount)
+{
+    while (stb_sb_count(avoidance->bucketAgents) < agentCount)
+        stb_sb_push(avoidance->bucketAgents, -1);
+
+    memset(avoidance->bucketStart, 0, sizeof(avoidance->bucketStart));
+
+    for (int i = 0; i < agentCount; ++i)
+    {
+        int x, y;
+        NavAvoidance_Cell(avoidance, avoidance->agents[i].position, &x, &y);
+        ++avoidance->bucketStart[NavAvoidance_Bucket(x, y) + 1];
+    }
+
+    for (int i = 0; i < NAV_AVOID_BUCKET_COUNT; ++i)
+        avoidance->bucketStart[i + 1] += avoidance->bucketStart[i];
+    
+    int fill[NAV_AVOID_BUCKET_COUNT];
+    memcpy(fill, avoidance->bucketStart, sizeof(fill));
+    
+    // agents stay in index order within a bucket
+    for (int i = 0; i < agentCount; ++i)
+    {
+        int x, y;
+        NavAvoidance_Cell(avoidance, avoidance->agents[i].position, &x, &y);
+        avoidance->bucketAgents[fill[NavAvoidance_Bucket(x, y)]++] = i;
+    }
+}
+
+/* the closest agents within range, nearest first */
+static int NavAvoidance_FindNeighbors(NavAvoidance* avoidance,
+                                      int agentIndex,
+                                      float range,
+                                      int* neighbors)
+{
+    const NavAgent* agent = avoidance->agents + agentIndex;
+
+    float neighborDistSq[NAV_AVOID_NEIGHBORS_MAX];
+    int neighborCount = 0;
+
+    // different cells can hash to the same bucket, don't visit one twice
+    int visited[9];
+    int visitedCount = 0;
+
+    int cellX, cellY;
+    NavAvoidance_Cell(avoidance, agent->position, &cellX, &cellY);
+
+    for (int y = cellY - 1; y <= cellY + 1; ++y)
+    {
+        for (int x = cellX - 1; x <= cellX + 1; ++x)
+        {
+            int bucket = NavAvoidance_Bucket(x, y);
+            int seen = 0;
+
+            for (int i = 0; i < visitedCount; ++i)
+                seen |= visited[i] == bucket;
+
+            if (seen)
+                continue;
+
+            visited[visitedCount++] = bucket;
+
+            for (int i = avoidance->bucketStart[bucket]; i < avoidance->bucketStart[bucket + 1]; ++i)
+            {
+                int otherIndex = avoidance->bucketAgents[i];
+                if (otherIndex == agentIndex) continue;
+
+                ++avoidance->neighborsTested;
+
+                float distSq = Vec2_LengthSq(Vec2_Sub(avoidance->agents[otherIndex].position, agent->position));
+
+                if (distSq >= range * range)
+                    continue;
+
+                if (neighborCount == NAV_AVOID_NEIGHBORS_MAX && distSq >= neighborDistSq[neighborCount - 1])
+                    continue;
+
+                // insertion into the sorted list, dropping the furthest when full
+                int j = MIN(neighborCount, NAV_AVOID_NEIGHBORS_MAX - 1);
+
+                while (j > 0 && neighborDistSq[j - 1] > distSq)
+                {
+                    neighbors[j] = neighbors[j - 1];
+                    neighborDistSq[j] = neighborDistSq[j - 1];
+                    --j;
+                }
+
+                neighbors[j] = otherIndex;
+                neighborDistSq[j] = distSq;
+                neighborCount = MIN(neighborCount + 1, NAV_AVOID_NEIGHBORS_MAX);
+            }
+        }
+    }
+
+    return neighborCount;
+}
+
+/* the half plane of velocities that avoid other within the time horizon */
+static NavAvoidLine NavAvoidance_Line(const NavAvoidance* avoidance, const NavAgent* agent, const NavAgent* other)
+{
+    float invTimeHorizon = 1.0f / avoidance->timeHorizon;
+
+    Vec2 relativePosition = Vec2_Sub(other->position, agent->position);
+    Vec2 relativeVelocity = Vec2_Sub(agent->velocity, other->velocity);
+    float distSq = Vec2_LengthSq(relativePosition);
+    float combinedRadius = agent->radius + other->radius;
+    float combinedRadiusSq = combinedRadius * combinedRadius;
+
+    NavAvoidLine line;
+    Vec2 u;
+
+    if (distSq > combinedRadiusSq)
+    {
+        // vector from the cutoff center to the relative velocity
+        Vec2 w = Vec2_Sub(relativeVelocity, Vec2_Scale(relativePosition, invTimeHorizon));
+        float wLengthSq = Vec2_LengthSq(w);
+        float dot = Vec2_Dot(w, relativePosition);
+
+        if (dot < 0.0f && dot * dot > combinedRadiusSq * wLengthSq)
+        {
+            // closest to the cutoff circle
+            float wLength = sqrtf(wLengthSq);
+            Vec2 unitW = Vec2_Scale(w, 1.0f / wLength);
+
+            line.direction = Vec2_Create(unitW.y, -unitW.x);
+            u = Vec2_Scale(unitW, combinedRadius * invTimeHorizon - wLength);
+        }
+        else
+        {
+            // closest to one of the legs of the cone
+            float leg = sqrtf(distSq - combinedRadiusSq);
+
+            if (Vec2_Det(relativePosition, w) > 0.0f)
+            {
+                line.direction = Vec2_Scale(Vec2_Create(relativePosition.x * leg - relativePosition.y * combinedRadius,
+                                                        relativePosition.x * combinedRadius + relativePosition.y * leg), 1.0f / distSq);
+            }
+            else
+            {
+                line.direction = Vec2_Scale(Vec2_Create(relativePosition.x * leg + relativePosition.y * combinedRadius,
+                                                        -relativePosition.x * combinedRadius + relativePosition.y * leg), -1.0f / distSq);
+            }
+
+            u = Vec2_Sub(Vec2_Scale(line.direction, Vec2_Dot(relativeVelocity, line.direction)), relativeVelocity);
+        }
+    }
+    else
+    {
+        // already overlapping, get apart within the next tick
+        Vec2 w = Vec2_Sub(relativeVelocity, relativePosition);
+        float wLength = Vec2_Length(w);
+
+        // exactly on top of each other, pick a side by index order
+        Vec2 unitW = wLength > NAV_AVOID_EPSILON ? Vec2_Scale(w, 1.0f / wLength) : Vec2_Create(agent < other ? -1.0f : 1.0f, 0.0f);
+
+        line.direction = Vec2_Create(unitW.y, -unitW.x);
+        u = Vec2_Scale(unitW, combinedRadius - wLength);
+    }
+
+    // share the avoiding evenly, unless the other is standing still
+    float share = other->maxSpeed > 0.0f ? 0.5f : 1.0f;
+    line.point = Vec2_Add(agent->velocity, Vec2_Scale(u, share));
+    return line;
+}
+
+/* the best velocity on line lineIndex that satisfies the lines before it */
+static int NavAvoidance_Program1(const NavAvoidLine* lines,
+                                 int lineIndex,
+                                 float radius,
+                                 Vec2 optVelocity,
+                                 int directionOpt,
+                                 Vec2* result)
+{
+    const NavAvoidLine* line = lines + lineIndex;
+
+    float dot = Vec2_Dot(line->point, line->direction);
+    float discriminant = dot * dot + radius * radius - Vec2_LengthSq(line->point);
+
+    // the max speed circle misses the line
+    if (discriminant < 0.0f)
+        return 0;
+
+    float sqrtDiscriminant = sqrtf(discriminant);
+    float tLeft = -dot - sqrtDiscriminant;
+    float tRight = -dot + sqrtDiscriminant;
+
+    for (int i = 0; i < lineIndex; ++i)
+    {
+        float denominator = Vec2_Det(line->direction, lines[i].direction);
+        float numerator = Vec2_Det(lines[i].direction, Vec2_Sub(line->point, lines[i].point));
+
+        if (fabsf(denominator) <= NAV_AVOID_EPSILON)
+        {
+            // parallel, either all of this line is allowed or none of it
+            if (numerator < 0.0f)
+                return 0;
+
+            continue;
+        }
+
+        float t = numerator / denominator;
+
+        if (denominator >= 0.0f)
+            tRight = MIN(tRight, t);
+        else
+            tLeft = MAX(tLeft, t);
+
+        if (tLeft > tRight)
+            return 0;
+    }
+
+    if (directionOpt)
+    {
+        float t = Vec2_Dot(optVelocity, line->direction) > 0.0f ? tRight : tLeft;
+        *result = Vec2_Add(line->point, Vec2_Scale(line->direction, t));
+    }
+    else
+    {
+        float t = CLAMP(Vec2_Dot(line->direction, Vec2_Sub(optVelocity, line->point)), tLeft, tRight);
+        *result = Vec2_Add(line->point, Vec2_Scale(line->direction, t));
+    }
+
+    return 1;
+}
+
+/* the velocity closest to optVelocity within every line,
+   returns lineCount, or the first line that could not be met */
+static int NavAvoidance_Program2(const NavAvoidLine* lines,
+                                 int lineCount,
+                                 float radius,
+                                 Vec2 optVelocity,
+                                 int directionOpt,
+                                 Vec2* result)
+{
+    if (directionOpt)
+        *result = Vec2_Scale(optVelocity, radius);
+    else if (Vec2_LengthSq(optVelocity) > radius * radius)
+        *result = Vec2_Scale(Vec2_Norm(optVelocity), radius);
+    else
+        *result = optVelocity;
+
+    for (int i = 0; i < lineCount; ++i)
+    {
+        if (Vec2_Det(lines[i].direction, Vec2_Sub(lines[i].point, *result)) > 0.0f)
+        {
+            Vec2 previous = *result;
+
+            if (!NavAvoidance_Program1(lines, i, radius, optVelocity, directionOpt, result))
+            {
+                *result = previous;
+                return i;
+            }
+        }
+    }
+
+    return lineCount;
+}
+
+/* no velocity meets every line, find the one that breaks them the least */
+static void NavAvoidance_Program3(const NavAvoidLine* lines,
+                                  int lineCount,
+                                  int beginLine,
+                                  float radius,
+                                  Vec2* result)
+{
+    NavAvoidLine projected[NAV_AVOID_NEIGHBORS_MAX];
+    float distance = 0.0f;
+
+    for (int i = beginLine; i < lineCount; ++i)
+    {
+        if (Vec2_Det(lines[i].direction, Vec2_Sub(lines[i].point, *result)) <= distance)
+            continue;
+
+        int projectedCount = 0;
+
+        for (int j = 0; j < i; ++j)
+        {
+            NavAvoidLine line;
+            float determinant = Vec2_Det(lines[i].direction, lines[j].direction);
+
+            if (fabsf(determinant) <= NAV_AVOID_EPSILON)
+            {
+                // parallel and pointing the same way
+                if (Vec2_Dot(lines[i].direction, lines[j].direction) > 0.0f)
+                    continue;
+
+                line.point = Vec2_Scale(Vec2_Add(lines[i].point, lines[j].point), 0.5f);
+            }
+            else
+            {
+                float t = Vec2_Det(lines[j].direction, Vec2_Sub(lines[i].point, lines[j].point)) / determinant;
+                line.point = Vec2_Add(lines[i].point, Vec2_Scale(lines[i].direction, t));
+            }
+
+            Vec2 direction = Vec2_Sub(lines[j].direction, lines[i].direction);
+
+            if (Vec2_LengthSq(direction) <= NAV_AVOID_EPSILON * NAV_AVOID_EPSILON)
+                continue;
+
+            line.direction = Vec2_Norm(direction);
+            projected[projectedCount++] = line;
+        }
+
+        Vec2 previous = *result;
+        Vec2 optDirection = Vec2_Create(-lines[i].direction.y, lines[i].direction.x);
+
+        if (NavAvoidance_Program2(projected, projectedCount, radius, optDirection, 1, result) < projectedCount)
+        {
+            // only rounding errors can get here, keep the last result
+            *result = previous;
+        }
+
+        distance = Vec2_Det(lines[i].direction, Vec2_Sub(lines[i].point, *result));
+    }
+}
+
+/* agents in a perfectly even crowd, such as two walking straight at each other,
+   can all give way the same amount and stop. Turning each a little, by a fixed amount for its index,
+   breaks the tie and keeps solves repeatable. */
+static Vec2 NavAvoidance_Nudge(Vec2 velocity, int agentIndex)
+{
+    uint32_t hash = (uint32_t)agentIndex * 2654435761u;
+    float angle = NAV_AVOID_NUDGE * ((hash >> 16) / 32767.5f - 1.0f);
+    
+    float c = cosf(angle);
+    float s = sinf(angle);
+    return Vec2_Create(velocity.x * c - velocity.y * s, velocity.x * s + velocity.y * c);
+}
+
+void NavAvoidance_Solve(NavAvoidance* avoidance)
+{
+    int agentCount = stb_sb_count(avoidance->agents);
+    avoidance->neighborsTested = 0;
+
+    if (agentCount < 1)
+        return;
+
+    // agents further apart than this cannot meet within the time horizon
+    float maxRadius = 0.0f;
+    float maxSpeed = 0.0f;
+
+    for (int i = 0; i < agentCount; ++i)
+    {
+        maxRadius = MAX(maxRadius, avoidance->agents[i].radius);
+        maxSpeed = MAX(maxSpeed, avoidance->agents[i].maxSpeed);
+    }
+
+    float range = maxRadius * 2.0f + maxSpeed * 2.0f * avoidance->timeHorizon;
+    avoidance->cellSize = MAX(range, NAV_AVOID_EPSILON);
+
+    NavAvoidance_BuildHash(avoidance, agentCount);
+
+    for (int i = 0; i < agentCount; ++i)
+    {
+        NavAgent* agent = avoidance->agents + i;
+
+        if (agent->maxSpeed <= 0.0f)
+        {
+            agent->newVelocity = Vec2_Zero;
+            continue;
+        }
+
+        int neighbors[NAV_AVOID_NEIGHBORS_MAX];
+        int neighborCount = NavAvoidance_FindNeighbors(avoidance, i, range, neighbors);
+
+        NavAvoidLine lines[NAV_AVOID_NEIGHBORS_MAX];
+
+        for (int j = 0; j < neighborCount; ++j)
+            lines[j] = NavAvoidance_Line(avoidance, agent, avoidance->agents + neighbors[j]);
+
+        // alone it goes exactly where it wants
+        Vec2 preferredVelocity = neighborCount > 0 ? NavAvoidance_Nudge(agent->preferredVelocity, i) : agent->preferredVelocity;
+        int failedLine = NavAvoidance_Program2(lines, neighborCount, agent->maxSpeed, preferredVelocity, 0, &agent->newVelocity);
+
+        if (failedLine < neighborCount)
+            NavAvoidance_Program3(lines, neighborCount, failedLine, agent->maxSpeed, &agent->newVelocity);
+    }
+}
@@ -0,0 +1,73 @@
+
+#ifndef NAV_AVOID_H
+#define NAV_AVOID_H
+
+#include "vec_math.h"
+
+// closest neighbors each agent avoids, the rest are ignored
+#define NAV_AVOID_NEIGHBORS_MAX 8
+
+// power of 2, cells of the spatial hash share buckets past this
+#define NAV_AVOID_BUCKET_COUNT 256
+
+/*
+ Local collision avoidance between moving agents (ORCA, optimal reciprocal collision avoidance).
+ Each agent wants to move at its preferred velocity, usually toward the next node of its path.
+ Every close neighbor rules out the half plane of velocities that would hit it within the time horizon,
+ and the agent takes the allowed velocity nearest to the one it wanted.
+
+ Agents are put in a spatial hash, so each only looks at the few agents near it,
+ and a solve is linear in the number of agents.
+ Velocities are in distance per tick, and times are in ticks.
+ */
+
+typedef struct
+{
+    Vec2 position;
+    // the velocity it moved at last, others expect it to keep going this way
+    Vec2 velocity;
+    Vec2 preferredVelocity;
+
+    float radius;
+    // 0 for an agent standing still, others move fully out of its way
+    float maxSpeed;
+
+    // set by NavAvoidance_Solve
+    Vec2 newVelocity;
+} NavAgent;
+
+typedef struct
+{
+    // stretchy buffer
+    NavAgent* agents;
+
+    // how far ahead in ticks to avoid collisions
+    float timeHorizon;
+
+    float cellSize;
+    // agents in bucket i are bucketAgents[bucketStart[i]] through bucketAgents[bucketStart[i + 1] - 1]
+    int bucketStart[NAV_AVOID_BUCKET_COUNT + 1];
+    int* bucketAgents;
+
+    // neighbors looked at by the last solve, for profiling
+    int neighborsTested;
+} NavAvoidance;
+
+extern void NavAvoidance_Init(NavAvoidance* avoidance, float timeHorizon);
+extern void NavAvoidance_Shutdown(NavAvoidance* avoidance);
+
+/* removes every agent, call before adding this tick's agents */
+extern void NavAvoidance_Clear(NavAvoidance* avoidance);
+
+/* returns the index of the agent, its new velocity is read back after a solve */
+extern int NavAvoidance_AddAgent(NavAvoidance* avoidance,
+                                 Vec2 position,
+                                 Vec2 velocity,
+                                 Vec2 preferredVelocity,
+                                 float radius,
+                                 float maxSpeed);
+
+/* finds a new velocity for every agent */
+extern void NavAvoidance_Solve(NavAvoidance* avoidance);
+
+#endif
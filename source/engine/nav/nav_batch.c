@@ -0,0 +1,197 @@
+
+#include "nav_batch.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <assert.h>
+
+/* the same steps as a single path request, see Unit_StartPath */
+static void NavBatch_SolveRequest(const NavMesh* mesh, NavSolver* solver, NavPathRequest* request)
+{
+    Ray3 targetRay = Ray3_Create(Vec3_Offset(request->endPoint, 0.0f, 0.0f, 1.0f), Vec3_Create(0.0f, 0.0f, -1.0f));
+    
+    float t;
+    request->endPoly = NavMesh_Raycast(mesh, targetRay, &t);
+    request->result = 0;
+    
+    if (!request->startPoly || !request->endPoly)
+    {
+        NavPath_Clear(request->outPath);
+        return;
+    }
+    
+    request->result = NavSolver_Solve(solver,
+                                      mesh,
+                                      request->startPoint,
+                                      request->endPoint,
+                                      request->startPoly,
+                                      request->endPoly,
+                                      request->filter,
+                                      request->outPath);
+    
+    if (request->result)
+        NavSolver_SmoothPath(mesh, request->outPath, request->radius);
+}
+
+/* claims requests until there are none left */
+static void NavBatch_Work(NavBatch* batch, NavSolver* solver)
+{
+    while (1)
+    {
+        int i = __sync_fetch_and_add(&batch->nextRequest, 1);
+        
+        if (i >= batch->requestCount)
+            break;
+        
+        NavBatch_SolveRequest(batch->mesh, solver, batch->requests + i);
+    }
+}
+
+static void* NavBatch_WorkerMain(void* arg)
+{
+    struct NavBatchWorker* worker = arg;
+    NavBatch* batch = worker->batch;
+    
+    int lastBatchId = 0;
+    
+    pthread_mutex_lock(&batch->lock);
+    
+    while (1)
+    {
+        while (!batch->quit && batch->batchId == lastBatchId)
+            pthread_cond_wait(&batch->wake, &batch->lock);
+        
+        if (batch->quit)
+            break;
+        
+        lastBatchId = batch->batchId;
+        pthread_mutex_unlock(&batch->lock);
+        
+        NavBatch_Work(batch, &worker->solver);
+        
+        pthread_mutex_lock(&batch->lock);
+        
+        if (--batch->activeCount == 0)
+            pthread_cond_signal(&batch->finished);
+    }
+    
+    pthread_mutex_unlock(&batch->lock);
+    return NULL;
+}
+
+int NavBatch_Init(NavBatch* batch, int threadCount)
+{
+    assert(threadCount > 0);
+    
+    batch->threadCount = 0;
+    batch->mesh = NULL;
+    batch->requests = NULL;
+    batch->requestCount = 0;
+    batch->nextRequest = 0;
+    batch->activeCount = 0;
+    batch->batchId = 0;
+    batch->quit = 0;
+    
+    batch->workers = calloc(threadCount, sizeof(struct NavBatchWorker));
+    
+    if (!batch->workers)
+        return 0;
+    
+    pthread_mutex_init(&batch->lock, NULL);
+    pthread_cond_init(&batch->wake, NULL);
+    pthread_cond_init(&batch->finished, NULL);
+    
+    for (int i = 0; i < threadCount; ++i)
+    {
+        struct NavBatchWorker* worker = batch->workers + i;
+        worker->batch = batch;
+        NavSolver_Init(&worker->solver);
+        
+        if (i > 0 && pthread_create(&worker->thread, NULL, NavBatch_WorkerMain, worker) != 0)
+        {
+            // run with the threads we have
+            break;
+        }
+        
+        ++batch->threadCount;
+    }
+    
+    return 1;
+}
+
+void NavBatch_Shutdown(NavBatch* batch)
+{
+    if (!batch->workers)
+        return;
+    
+    pthread_mutex_lock(&batch->lock);
+    batch->quit = 1;
+    pthread_cond_broadcast(&batch->wake);
+    pthread_mutex_unlock(&batch->lock);
+    
+    for (int i = 0; i < batch->threadCount; ++i)
+    {
+        if (i > 0)
+            pthread_join(batch->workers[i].thread, NULL);
+        
+        NavSolver_Shutdown(&batch->workers[i].solver);
+    }
+    
+    pthread_cond_destroy(&batch->finished);
+    pthread_cond_destroy(&batch->wake);
+    pthread_mutex_destroy(&batch->lock);
+    
+    free(batch->workers);
+    batch->workers = NULL;
+    batch->threadCount = 0;
+}
+
+void NavBatch_Prepare(NavBatch* batch, const NavMesh* mesh)
+{
+    for (int i = 0; i < batch->threadCount; ++i)
+        NavSolver_Prepare(&batch->workers[i].solver, mesh);
+}
+
+void NavBatch_Solve(NavBatch* batch,
+                    const NavMesh* mesh,
+                    NavPathRequest* requests,
+                    int requestCount)
+{
+    if (batch->threadCount < 1 || requestCount < 1)
+        return;
+    
+    batch->mesh = mesh;
+    batch->requests = requests;
+    batch->requestCount = requestCount;
+    batch->nextRequest = 0;
+    
+    if (batch->threadCount == 1 || requestCount == 1)
+    {
+        NavBatch_Work(batch, &batch->workers[0].solver);
+        return;
+    }
+    
+    pthread_mutex_lock(&batch->lock);
+    batch->activeCount = batch->threadCount - 1;
+    ++batch->batchId;
+    pthread_cond_broadcast(&batch->wake);
+    pthread_mutex_unlock(&batch->lock);
+    
+    NavBatch_Work(batch, &batch->workers[0].solver);
+    
+    pthread_mutex_lock(&batch->lock);
+    
+    while (batch->activeCount > 0)
+        pthread_cond_wait(&batch->finished, &batch->lock);
+    
+    pthread_mutex_unlock(&batch->lock);
+}
+
+int NavBatch_DefaultThreadCount()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    
+    if (count < 1)
+        return 1;
+    
+    return (int)MIN(count, NAV_BATCH_THREADS_MAX);
+}
@@ -0,0 +1,75 @@
+
+#ifndef NAV_BATCH_H
+#define NAV_BATCH_H
+
+#include <pthread.h>
+#include "nav.h"
+
+#define NAV_BATCH_THREADS_MAX 8
+
+/*
+ Solves many paths at once on a pool of worker threads.
+ Each thread has its own solver, and solves only read the mesh,
+ so every request gets the same path it would get solved alone.
+ */
+
+typedef struct
+{
+    // filled by the caller
+    const NavPoly* startPoly;
+    Vec3 startPoint;
+    Vec3 endPoint;
+    float radius;
+    // NULL for the default, see NavQueryFilter
+    const NavQueryFilter* filter;
+    NavPath* outPath;
+    
+    // the poly below endPoint, and whether a path was found
+    const NavPoly* endPoly;
+    int result;
+} NavPathRequest;
+
+struct NavBatchWorker
+{
+    struct NavBatch* batch;
+    pthread_t thread;
+    NavSolver solver;
+};
+
+typedef struct NavBatch
+{
+    // the calling thread is worker 0, the rest have their own threads
+    int threadCount;
+    struct NavBatchWorker* workers;
+    
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t finished;
+    
+    // the batch being solved
+    const NavMesh* mesh;
+    NavPathRequest* requests;
+    int requestCount;
+    int nextRequest;
+    
+    // threads still working on the batch
+    int activeCount;
+    int batchId;
+    int quit;
+} NavBatch;
+
+extern int NavBatch_Init(NavBatch* batch, int threadCount);
+extern void NavBatch_Shutdown(NavBatch* batch);
+
+extern void NavBatch_Prepare(NavBatch* batch, const NavMesh* mesh);
+
+/* solves and smooths every request, returning once all are done */
+extern void NavBatch_Solve(NavBatch* batch,
+                           const NavMesh* mesh,
+                           NavPathRequest* requests,
+                           int requestCount);
+
+/* online processors, clamped to NAV_BATCH_THREADS_MAX */
+extern int NavBatch_DefaultThreadCount();
+
+#endif
@@ -0,0 +1,175 @@
+
+#include "nav_flow.h"
+#include <stdlib.h>
+#include <assert.h>
+
+void NavFlowField_Init(NavFlowField* field)
+{
+    field->goalPoly = -1;
+    field->polyCount = 0;
+    field->nextEdge = NULL;
+    field->costs = NULL;
+    field->lastUsed = 0;
+}
+
+void NavFlowField_Shutdown(NavFlowField* field)
+{
+    free(field->nextEdge);
+    free(field->costs);
+    NavFlowField_Init(field);
+}
+
+/* the flood enters a poly through an edge of its parent,
+   heading to the goal leaves through the shared edge on this side */
+static int NavFlowField_TwinEdge(const NavMesh* mesh, int polyIndex, int parentIndex, int enteredIndex)
+{
+    const NavEdge* entered = mesh->edges + enteredIndex;
+    const NavPoly* poly = mesh->polys + polyIndex;
+    
+    int twin = -1;
+    
+    for (int i = 0; i < poly->edgeCount; ++i)
+    {
+        const NavEdge* edge = mesh->edges + poly->edgeStart + i;
+        
+        if (edge->neighborIndex != parentIndex)
+            continue;
+        
+        // polys may share more than one edge, prefer the one that was crossed
+        if (edge->vertices[0] == entered->vertices[1] && edge->vertices[1] == entered->vertices[0])
+            return poly->edgeStart + i;
+        
+        if (twin == -1)
+            twin = poly->edgeStart + i;
+    }
+    
+    return twin;
+}
+
+int NavFlowField_Build(NavFlowField* field,
+                       NavSolver* solver,
+                       const NavMesh* mesh,
+                       const NavPoly* goalPoly,
+                       Vec3 goalPoint)
+{
+    if (field->polyCount != mesh->polyCount)
+    {
+        NavFlowField_Shutdown(field);
+        
+        field->nextEdge = malloc(sizeof(int) * mesh->polyCount);
+        field->costs = malloc(sizeof(float) * mesh->polyCount);
+        
+        if (!field->nextEdge || !field->costs)
+        {
+            NavFlowField_Shutdown(field);
+            return 0;
+        }
+        
+        field->polyCount = mesh->polyCount;
+    }
+    
+    field->goalPoly = goalPoly->index;
+    
+    // edges are duplicated in each direction with the same length,
+    // so costs out from the goal are the costs back to it
+    int reached = NavSolver_Flood(solver, mesh, goalPoly, goalPoint, INFINITY, NULL, field->costs);
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        const struct NavSearchNode* node = solver->pool + i;
+        
+        if (field->costs[i] == INFINITY || node->parent == -1)
+            field->nextEdge[i] = -1;
+        else
+            field->nextEdge[i] = NavFlowField_TwinEdge(mesh, i, node->parent, node->edgeIndex);
+    }
+    
+    return reached;
+}
+
+/* the edge to leave startPoly through. The flood does not cross polys under obstacles,
+   so a unit standing on one walled in by others steps to whichever neighbor is closest to the goal. */
+static int NavFlowField_FirstEdge(const NavFlowField* field, const NavMesh* mesh, const NavPoly* startPoly)
+{
+    int edgeIndex = field->nextEdge[startPoly->index];
+    
+    if (edgeIndex != -1 || !NavObstacles_IsBlocked(&mesh->obstacles, startPoly->index))
+        return edgeIndex;
+    
+    float bestCost = INFINITY;
+    
+    for (int i = 0; i < startPoly->edgeCount; ++i)
+    {
+        const NavEdge* edge = mesh->edges + startPoly->edgeStart + i;
+        if (edge->neighborIndex == -1) continue;
+        
+        float cost = field->costs[edge->neighborIndex];
+        
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            edgeIndex = startPoly->edgeStart + i;
+        }
+    }
+    
+    return edgeIndex;
+}
+
+int NavFlowField_Path(const NavFlowField* field,
+                      const NavMesh* mesh,
+                      Vec3 startPoint,
+                      Vec3 endPoint,
+                      const NavPoly* startPoly,
+                      NavPath* outPath)
+{
+    if (field->goalPoly == -1 || startPoly->index >= field->polyCount)
+        return 0;
+    
+    // count the corridor to the goal, each step is one poly closer so it cannot loop
+    int nodeCount = 2;
+    int polyIndex = startPoly->index;
+    int firstEdge = NavFlowField_FirstEdge(field, mesh, startPoly);
+    int edgeIndex = firstEdge;
+    
+    while (polyIndex != field->goalPoly)
+    {
+        if (edgeIndex == -1 || nodeCount > field->polyCount + 1)
+            return 0;
+        
+        polyIndex = mesh->links.neighbors[edgeIndex];
+        edgeIndex = field->nextEdge[polyIndex];
+        ++nodeCount;
+    }
+    
+    if (!NavPath_Reserve(outPath, nodeCount))
+        return 0;
+    
+    NavPathNode* nodes = outPath->nodes;
+    outPath->nodeCount = nodeCount;
+    
+    nodes[0].point = startPoint;
+    nodes[0].edgeIndex = -1;
+    nodes[0].polyIndex = startPoly->index;
+    
+    nodes[nodeCount - 1].point = endPoint;
+    nodes[nodeCount - 1].edgeIndex = -1;
+    nodes[nodeCount - 1].polyIndex = field->goalPoly;
+    
+    // middle points, the edge crossed into each poly, the same as a solved path
+    polyIndex = startPoly->index;
+    edgeIndex = firstEdge;
+    
+    for (int k = 1; k < nodeCount - 1; ++k)
+    {
+        polyIndex = mesh->links.neighbors[edgeIndex];
+        
+        nodes[k].point = mesh->links.midpoints[edgeIndex];
+        nodes[k].edgeIndex = edgeIndex;
+        nodes[k].polyIndex = polyIndex;
+        
+        edgeIndex = field->nextEdge[polyIndex];
+    }
+    
+    assert(polyIndex == field->goalPoly);
+    return 1;
+}
@@ -0,0 +1,50 @@
+
+#ifndef NAV_FLOW_H
+#define NAV_FLOW_H
+
+#include "nav.h"
+
+/*
+ A flow field toward one goal poly, for many units heading to the same place.
+ One flood out from the goal finds the edge each poly should leave through,
+ so the corridor from any poly is read off by following those edges
+ without searching again. Fields use the default query filter,
+ and go around the obstacles on the mesh when they are built.
+ A field floods the whole mesh, so it always meets obstacles. It is kept as they move,
+ and the paths read from it are checked against them instead.
+ */
+
+typedef struct
+{
+    // -1 if the field is empty
+    int goalPoly;
+    int polyCount;
+    
+    // the edge of each poly leading toward the goal, -1 at the goal or if the goal cannot be reached
+    int* nextEdge;
+    // path cost from each poly to the goal, INFINITY if it cannot be reached
+    float* costs;
+    
+    unsigned int lastUsed;
+} NavFlowField;
+
+extern void NavFlowField_Init(NavFlowField* field);
+extern void NavFlowField_Shutdown(NavFlowField* field);
+
+/* floods the whole mesh from goalPoint with solver, returns how many polys can reach the goal */
+extern int NavFlowField_Build(NavFlowField* field,
+                              NavSolver* solver,
+                              const NavMesh* mesh,
+                              const NavPoly* goalPoly,
+                              Vec3 goalPoint);
+
+/* the unsmoothed corridor from startPoly to the goal poly, ending at endPoint.
+   Returns 0 if startPoly cannot reach the goal. */
+extern int NavFlowField_Path(const NavFlowField* field,
+                             const NavMesh* mesh,
+                             Vec3 startPoint,
+                             Vec3 endPoint,
+                             const NavPoly* startPoly,
+                             NavPath* outPath);
+
+#endif
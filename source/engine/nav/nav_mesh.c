@@ -1,48 +1,82 @@
 
 #include "nav_mesh.h"
 #include <stdlib.h>
+#include <stdint.h>
 #include "platform.h"
 #include <assert.h>
 
 
+static size_t NavMesh_DataSize(int vertexCount, int edgeCount, int polyCount)
+{
+    return sizeof(Vec3) * vertexCount +
+        sizeof(NavPoly) * polyCount +
+        sizeof(NavEdge) * edgeCount +
+        sizeof(Vec2) * edgeCount;
+}
+
 int NavMesh_Init(NavMesh* mesh,
-                 unsigned short vertexCount,
-                 unsigned short edgeCount,
-                 unsigned short polyCount)
+                 int vertexCount,
+                 int edgeCount,
+                 int polyCount)
 {
     mesh->vertexCount = vertexCount;
     mesh->polyCount = polyCount;
     mesh->edgeCount = edgeCount;
     
-    mesh->vertices = malloc(sizeof(Vec3) * vertexCount);
-    if (!mesh->vertices)
-        return 0;
+    mesh->edgeDirs = NULL;
+    memset(&mesh->links, 0, sizeof(NavLinks));
+    memset(&mesh->grid, 0, sizeof(NavGrid));
+    memset(&mesh->regions, 0, sizeof(NavRegions));
+    memset(&mesh->visibility, 0, sizeof(NavVisibility));
+    memset(&mesh->obstacles, 0, sizeof(NavObstacles));
     
-    mesh->polys = malloc(sizeof(NavPoly) * polyCount);
-    if (!mesh->polys)
-    {
-        free(mesh->vertices);
+    /* all arrays share one allocation, laid out in the same order as a .bnav file */
+    mesh->data = malloc(NavMesh_DataSize(vertexCount, edgeCount, polyCount));
+    if (!mesh->data)
         return 0;
-    }
-    mesh->edges = malloc(sizeof(NavEdge) * edgeCount);
-    if (!mesh->edges)
-    {
-        free(mesh->vertices);
-        free(mesh->polys);
-        return 0;
-    }
+    
+    char* cursor = mesh->data;
+    
+    mesh->vertices = (Vec3*)cursor;
+    cursor += sizeof(Vec3) * vertexCount;
+    
+    mesh->polys = (NavPoly*)cursor;
+    cursor += sizeof(NavPoly) * polyCount;
+    
+    mesh->edges = (NavEdge*)cursor;
+    cursor += sizeof(NavEdge) * edgeCount;
+    
+    mesh->edgePoints = (Vec2*)cursor;
     
     return 1;
 }
 
 void NavMesh_Shutdown(NavMesh* mesh)
 {
-    if (mesh->vertices)
-        free(mesh->vertices);
-    if (mesh->polys)
-        free(mesh->polys);
-    if (mesh->edges)
-        free(mesh->edges);
+    if (mesh->data)
+        free(mesh->data);
+    if (mesh->edgeDirs)
+        free(mesh->edgeDirs);
+    if (mesh->links.data)
+        free(mesh->links.data);
+    if (mesh->grid.cellStart)
+        free(mesh->grid.cellStart);
+    if (mesh->grid.cellPolys)
+        free(mesh->grid.cellPolys);
+    
+    NavRegions_Shutdown(&mesh->regions);
+    NavVisibility_Shutdown(&mesh->visibility);
+    NavObstacles_Shutdown(&mesh->obstacles);
+    
+    mesh->data = NULL;
+    mesh->vertices = NULL;
+    mesh->polys = NULL;
+    mesh->edges = NULL;
+    mesh->edgePoints = NULL;
+    mesh->edgeDirs = NULL;
+    memset(&mesh->links, 0, sizeof(NavLinks));
+    mesh->grid.cellStart = NULL;
+    mesh->grid.cellPolys = NULL;
 }
 
 NavPoly* NavMesh_GetPolyNeighbor(const NavMesh* mesh,
@@ -61,60 +95,144 @@ NavPoly* NavMesh_GetPolyNeighbor(const NavMesh* mesh,
 }
 
 
-NavPoly* NavMesh_Raycast(const NavMesh* mesh, Ray3 ray, float* r)
+static int NavMesh_RaycastPoly(const NavMesh* mesh, const NavPoly* poly, Ray3 ray, float max, float* t)
 {
+    if (!AABB_IntersectsRay(poly->bounds, ray)) return 0;
+    
+    if (!Plane_IntersectRay(poly->plane, ray, t)) return 0;
+    
+    if (*t < 0.0f || *t >= max) return 0;
+    
+    // transform intersection into the poly's vector space
+    Vec3 origin = mesh->vertices[mesh->edges[poly->edgeStart].vertices[0]];
+    Vec3 local = Vec3_Sub(Ray3_Slide(ray, *t), origin);
+    
+    Vec2 intersection2;
+    intersection2.x = Vec3_Dot(local, poly->right);
+    intersection2.y = Vec3_Dot(local, poly->up);
+    
+    return Geo_PointInPoly(poly->edgeCount, mesh->edgePoints + poly->edgeStart, intersection2);
+}
+
+NavPoly* NavMesh_RaycastTested(const NavMesh* mesh, Ray3 ray, float* r, int* polysTested)
+{
+    *polysTested = 0;
+    
     float min = HUGE_VALF;
     NavPoly* result = NULL;
     float t;
     
-    for (int i = 0; i < mesh->polyCount; ++i)
+    const NavGrid* grid = &mesh->grid;
+    
+    if (!grid->cellStart)
     {
-        NavPoly* poly = mesh->polys + i;
-        
-        if (!AABB_IntersectsRay(poly->bounds, ray)) continue;
+        for (int i = 0; i < mesh->polyCount; ++i)
+        {
+            NavPoly* poly = mesh->polys + i;
+            ++(*polysTested);
+            
+            if (NavMesh_RaycastPoly(mesh, poly, ray, min, &t))
+            {
+                min = t;
+                result = poly;
+            }
+        }
+    }
+    else
+    {
+        // clip the ray to the XY bounds of the grid
+        float tEnter = 0.0f;
+        float tExit = HUGE_VALF;
         
-        if (Plane_IntersectRay(poly->plane, ray, &t))
+        for (int k = 0; k < 2; ++k)
         {
-            if (t < 0.0f) continue;
+            float o = Vec3_Get(ray.origin, k) - Vec2_Get(grid->origin, k);
+            float d = Vec3_Get(ray.dir, k);
+            float size = grid->cellSize * ((k == 0) ? grid->width : grid->height);
             
-            if (t < min)
+            if (fabsf(d) < V_EPSILON)
             {
-                Vec3 intersection = Ray3_Slide(ray, t);
-                
-                const NavEdge* originEdge = mesh->edges + poly->edgeStart;
-                Vec3 origin = mesh->vertices[originEdge->vertices[0]];
-                
-                // get vector in polygon
-                Vec3 rightVec = Vec3_Sub(mesh->vertices[originEdge->vertices[1]], origin);
-                rightVec = Vec3_Norm(rightVec);
-                
-                // get up vector
-                Vec3 upVec = Vec3_Norm(Vec3_Cross(rightVec, poly->plane.normal));
-                
-                // transform intersection into vector space
-                Vec2 intersection2;
-                intersection2.x = Vec3_Dot(Vec3_Sub(intersection, origin), rightVec);
-                intersection2.y = Vec3_Dot(Vec3_Sub(intersection, origin), upVec);
-                
-                // project polygon edge points into face local vector space
+                if (o < 0.0f || o > size)
+                    return NULL;
+            }
+            else
+            {
+                float t0 = -o / d;
+                float t1 = (size - o) / d;
                 
-                Vec2 verts[poly->edgeCount];
-                for (int j = 0; j < poly->edgeCount; ++j)
-                {
-                    const NavEdge* edge = mesh->edges + poly->edgeStart + j;
-                                        
-                    Vec3 pa = Vec3_Sub(mesh->vertices[edge->vertices[0]], origin);
-
-                    verts[j].x = Vec3_Dot(pa, rightVec);
-                    verts[j].y = Vec3_Dot(pa, upVec);
-                }
+                tEnter = MAX(tEnter, MIN(t0, t1));
+                tExit = MIN(tExit, MAX(t0, t1));
+            }
+        }
+        
+        if (tEnter > tExit)
+            return NULL;
+        
+        // walk the cells under the ray in order (2D DDA)
+        Vec3 enter = Ray3_Slide(ray, tEnter);
+        
+        int cell[2];
+        int step[2];
+        float tMax[2];
+        float tDelta[2];
+        
+        for (int k = 0; k < 2; ++k)
+        {
+            int cellCount = (k == 0) ? grid->width : grid->height;
+            float o = Vec2_Get(grid->origin, k);
+            float d = Vec3_Get(ray.dir, k);
+            
+            cell[k] = (int)floorf((Vec3_Get(enter, k) - o) / grid->cellSize);
+            cell[k] = CLAMP(cell[k], 0, cellCount - 1);
+            
+            if (d > V_EPSILON)
+            {
+                step[k] = 1;
+                tMax[k] = (o + (cell[k] + 1) * grid->cellSize - Vec3_Get(ray.origin, k)) / d;
+                tDelta[k] = grid->cellSize / d;
+            }
+            else if (d < -V_EPSILON)
+            {
+                step[k] = -1;
+                tMax[k] = (o + cell[k] * grid->cellSize - Vec3_Get(ray.origin, k)) / d;
+                tDelta[k] = -grid->cellSize / d;
+            }
+            else
+            {
+                step[k] = 0;
+                tMax[k] = HUGE_VALF;
+                tDelta[k] = 0.0f;
+            }
+        }
+        
+        while (1)
+        {
+            int cellIndex = cell[1] * grid->width + cell[0];
+            
+            for (int i = grid->cellStart[cellIndex]; i < grid->cellStart[cellIndex + 1]; ++i)
+            {
+                NavPoly* poly = mesh->polys + grid->cellPolys[i];
+                ++(*polysTested);
                 
-                if (Geo_PointInPoly(poly->edgeCount, verts, intersection2))
+                if (NavMesh_RaycastPoly(mesh, poly, ray, min, &t))
                 {
                     min = t;
                     result = poly;
                 }
             }
+            
+            // every remaining cell is further along the ray than this hit
+            float cellExit = MIN(MIN(tMax[0], tMax[1]), tExit);
+            
+            if (min <= cellExit || cellExit >= tExit)
+                break;
+            
+            int k = (tMax[0] < tMax[1]) ? 0 : 1;
+            cell[k] += step[k];
+            tMax[k] += tDelta[k];
+            
+            if (cell[0] < 0 || cell[0] >= grid->width || cell[1] < 0 || cell[1] >= grid->height)
+                break;
         }
     }
     
@@ -126,6 +244,188 @@ NavPoly* NavMesh_Raycast(const NavMesh* mesh, Ray3 ray, float* r)
     return result;
 }
 
+NavPoly* NavMesh_Raycast(const NavMesh* mesh, Ray3 ray, float* r)
+{
+    int polysTested;
+    return NavMesh_RaycastTested(mesh, ray, r, &polysTested);
+}
+
+#define NAV_LOCATE_STEPS_MAX 16
+
+/* twice the signed area of the edge loop in XY, positive when counter clockwise */
+static float NavMesh_PolyWinding(const NavMesh* mesh, const NavPoly* poly)
+{
+    float area = 0.0f;
+    
+    for (int i = 0; i < poly->edgeCount; ++i)
+    {
+        const NavEdge* edge = mesh->edges + poly->edgeStart + i;
+        Vec3 a = mesh->vertices[edge->vertices[0]];
+        Vec3 b = mesh->vertices[edge->vertices[1]];
+        area += a.x * b.y - b.x * a.y;
+    }
+    
+    return area;
+}
+
+/* returns the neighbor across the edge point is furthest outside of.
+   NULL if the point is inside (in XY) or the edge has no neighbor. */
+static const NavPoly* NavMesh_StepToward(const NavMesh* mesh, const NavPoly* poly, Vec2 point)
+{
+    float area = NavMesh_PolyWinding(mesh, poly);
+    
+    const NavEdge* exit = NULL;
+    float exitDist = 0.0f;
+    
+    for (int i = 0; i < poly->edgeCount; ++i)
+    {
+        const NavEdge* edge = mesh->edges + poly->edgeStart + i;
+        Vec3 a = mesh->vertices[edge->vertices[0]];
+        Vec3 b = mesh->vertices[edge->vertices[1]];
+        
+        Vec2 edgeVec = Vec2_Create(b.x - a.x, b.y - a.y);
+        float length = sqrtf(edgeVec.x * edgeVec.x + edgeVec.y * edgeVec.y);
+        
+        if (length < V_EPSILON) continue;
+        
+        // distance outside of the edge, positive when point is on the outer side
+        float cross = edgeVec.x * (point.y - a.y) - edgeVec.y * (point.x - a.x);
+        float dist = ((area > 0.0f) ? -cross : cross) / length;
+        
+        if (dist > exitDist)
+        {
+            exitDist = dist;
+            exit = edge;
+        }
+    }
+    
+    if (!exit || exit->neighborIndex == -1)
+        return NULL;
+    
+    return mesh->polys + exit->neighborIndex;
+}
+
+NavPoly* NavMesh_LocatePoint(const NavMesh* mesh,
+                             const NavPoly* hintPoly,
+                             Vec3 point,
+                             float* t)
+{
+    Ray3 ray = Ray3_Create(point, Vec3_Create(0.0f, 0.0f, -1.0f));
+    
+    const NavPoly* poly = hintPoly;
+    
+    for (int i = 0; poly && i < NAV_LOCATE_STEPS_MAX; ++i)
+    {
+        if (NavMesh_RaycastPoly(mesh, poly, ray, HUGE_VALF, t))
+            return mesh->polys + poly->index;
+        
+        poly = NavMesh_StepToward(mesh, poly, Vec2_FromVec3(point));
+    }
+    
+    return NavMesh_Raycast(mesh, ray, t);
+}
+
+/* where the line leaves poly in XY, clipping against each edge (Cyrus-Beck).
+   Returns the edge index within the poly, or -1 if the line ends inside it. */
+static int NavMesh_ClipLine(const NavMesh* mesh, const NavPoly* poly, Vec2 start, Vec2 dir, float* tExit)
+{
+    float sign = (NavMesh_PolyWinding(mesh, poly) > 0.0f) ? -1.0f : 1.0f;
+    
+    int exitEdge = -1;
+    *tExit = 1.0f;
+    
+    for (int i = 0; i < poly->edgeCount; ++i)
+    {
+        const NavEdge* edge = mesh->edges + poly->edgeStart + i;
+        Vec3 a = mesh->vertices[edge->vertices[0]];
+        Vec3 b = mesh->vertices[edge->vertices[1]];
+        
+        // outward normal of the edge
+        Vec2 normal = Vec2_Create(-(b.y - a.y) * sign, (b.x - a.x) * sign);
+        
+        float denom = Vec2_Dot(normal, dir);
+        
+        // only edges the line is heading out of can be the exit
+        if (denom <= 0.0f)
+            continue;
+        
+        float t = Vec2_Dot(normal, Vec2_Create(a.x - start.x, a.y - start.y)) / denom;
+        
+        if (t < *tExit)
+        {
+            *tExit = t;
+            exitEdge = i;
+        }
+    }
+    
+    return exitEdge;
+}
+
+int NavMesh_LineWalk(const NavMesh* mesh,
+                     const NavPoly* startPoly,
+                     Vec3 start,
+                     Vec3 end,
+                     NavEdgeFlag queryFlags,
+                     NavLineHit* hit)
+{
+    Vec3 vec = Vec3_Sub(end, start);
+    Vec2 start2 = Vec2_FromVec3(start);
+    Vec2 dir2 = Vec2_FromVec3(vec);
+    
+    const NavPoly* poly = startPoly;
+    float tEnter = 0.0f;
+    
+    hit->polysCrossed = 0;
+    
+    // each poly is crossed at most once along a line
+    for (int steps = 0; poly && steps < mesh->polyCount; ++steps)
+    {
+        ++hit->polysCrossed;
+        
+        float tExit;
+        int exitEdge = NavMesh_ClipLine(mesh, poly, start2, dir2, &tExit);
+        
+        tExit = MAX(tExit, tEnter);
+        
+        // the line is linear and so is the plane, so it passes through the surface
+        // if it is on different sides at either end of the part within the poly
+        float h0 = Plane_SignedDist(poly->plane, Vec3_Add(start, Vec3_Scale(vec, tEnter)));
+        float h1 = Plane_SignedDist(poly->plane, Vec3_Add(start, Vec3_Scale(vec, tExit)));
+        
+        if (h0 * h1 < 0.0f)
+        {
+            hit->t = tEnter + (tExit - tEnter) * (h0 / (h0 - h1));
+            hit->point = Vec3_Add(start, Vec3_Scale(vec, hit->t));
+            hit->poly = poly;
+            hit->edgeIndex = -1;
+            return 1;
+        }
+        
+        if (exitEdge == -1)
+            break;
+        
+        const NavEdge* edge = mesh->edges + poly->edgeStart + exitEdge;
+        
+        if (edge->flags & queryFlags)
+        {
+            hit->t = tExit;
+            hit->point = Vec3_Add(start, Vec3_Scale(vec, tExit));
+            hit->poly = poly;
+            hit->edgeIndex = poly->edgeStart + exitEdge;
+            return 1;
+        }
+        
+        // off the edge of the mesh
+        if (edge->neighborIndex == -1)
+            break;
+        
+        poly = mesh->polys + edge->neighborIndex;
+        tEnter = tExit;
+    }
+    
+    return 0;
+}
+
 int NavMesh_LineEdgeCast(const NavMesh* mesh,
                          const NavPoly* poly,
                          Vec2 p1,
@@ -153,12 +453,42 @@ int NavMesh_LineEdgeCast(const NavMesh* mesh,
     return 0;
 }
 
+// far past any level, keeps sizes from overflowing on a bad file
+#define NAV_MESH_COUNT_MAX (1 << 24)
+
+static int NavMesh_ValidCounts(int vertexCount, int edgeCount, int polyCount)
+{
+    return vertexCount > 0 && vertexCount <= NAV_MESH_COUNT_MAX &&
+        edgeCount > 0 && edgeCount <= NAV_MESH_COUNT_MAX &&
+        polyCount > 0 && polyCount <= NAV_MESH_COUNT_MAX;
+}
+
+/* indices in a file are used without checks once loaded */
+static int NavMesh_ValidEdge(const NavMesh* mesh, const NavEdge* edge)
+{
+    return edge->neighborIndex >= -1 && edge->neighborIndex < mesh->polyCount &&
+        edge->vertices[0] >= 0 && edge->vertices[0] < mesh->vertexCount &&
+        edge->vertices[1] >= 0 && edge->vertices[1] < mesh->vertexCount;
+}
+
+/* polys list their edges in order, with none between them (see NavLinks) */
+static int NavMesh_ValidPoly(const NavMesh* mesh, int polyIndex)
+{
+    const NavPoly* poly = mesh->polys + polyIndex;
+    int expectedStart = (polyIndex == 0) ? 0 : poly[-1].edgeStart + poly[-1].edgeCount;
+    
+    return poly->edgeStart == expectedStart &&
+        poly->edgeCount >= 3 &&
+        poly->edgeStart + poly->edgeCount <= mesh->edgeCount;
+}
+
 static int NavMesh_FromNAV(NavMesh* mesh, FILE* file)
 {
     int vertCount = -1;
-    short polyCount = -1;
+    int polyCount = -1;
     int edgeCount = -1;
     int readInfo = 0;
+    int version = 0;
     
     char lineBuffer[LINE_BUFFER_MAX];
     
@@ -171,7 +501,10 @@ static int NavMesh_FromNAV(NavMesh* mesh, FILE* file)
         
         if (strstr(command, "version"))
         {
-            if (atoi(data) != 2)
+            // version 3 adds edge costs and poly areas
+            version = atoi(data);
+            
+            if (version != 2 && version != 3)
                 return 0;
         }
         else if (strstr(command, "vertex_count"))
@@ -190,11 +523,12 @@ static int NavMesh_FromNAV(NavMesh* mesh, FILE* file)
         {
             if (!readInfo)
             {
-                if (edgeCount == -1 || vertCount == -1 || polyCount == -1)
+                if (!NavMesh_ValidCounts(vertCount, edgeCount, polyCount))
                 {
                     return 0;
                 }
-                NavMesh_Init(mesh, vertCount, edgeCount, polyCount);
+                if (!NavMesh_Init(mesh, vertCount, edgeCount, polyCount))
+                    return 0;
                 readInfo = 0;
             }
             
@@ -214,21 +548,30 @@ static int NavMesh_FromNAV(NavMesh* mesh, FILE* file)
             {                fgets(lineBuffer, LINE_BUFFER_MAX, file);
 
                 
-                int solid = 0;
+                // version 2 only has a solid column, which is the first flag
+                int flags = 0;
+                float cost = 1.0f;
+                
                 if (sscanf(lineBuffer,
-                           "%hd, %hu, %hu, %i",
+                           "%i, %i, %i, %i, %f",
                            &mesh->edges[i].neighborIndex,
                            &mesh->edges[i].vertices[0],
                            &mesh->edges[i].vertices[1],
-                           &solid) != 4)
+                           &flags,
+                           &cost) != (version >= 3 ? 5 : 4))
                 {
                     return 0;
                 }
                 
-                mesh->edges[i].flags = kNavEdgeFlagNone;
+                // a free or negative cost would break the search
+                if (!(cost >= NAV_EDGE_COST_MIN && cost < INFINITY))
+                    return 0;
 
-                if (solid)
-                    mesh->edges[i].flags |= kNavEdgeFlagSolid;
+                mesh->edges[i].flags = flags;
+                mesh->edges[i].cost = cost;
+                
+                if (!NavMesh_ValidEdge(mesh, mesh->edges + i))
+                    return 0;
             }
         }
         else if (strstr(command, "polys"))
@@ -237,10 +580,18 @@ static int NavMesh_FromNAV(NavMesh* mesh, FILE* file)
             {
                 mesh->polys[i].index = i;
                 
+                int area = kNavAreaGround;
+                
                 fgets(lineBuffer, LINE_BUFFER_MAX, file);
-                sscanf(lineBuffer, "%hu, %hu",
+                sscanf(lineBuffer, "%i, %i, %i",
                        &mesh->polys[i].edgeStart,
-                       &mesh->polys[i].edgeCount);
+                       &mesh->polys[i].edgeCount,
+                       &area);
+                
+                if (area < 0 || area >= NAV_AREA_COUNT || !NavMesh_ValidPoly(mesh, i))
+                    return 0;
+                
+                mesh->polys[i].area = area;
                 
                 fgets(lineBuffer, LINE_BUFFER_MAX, file);
                 sscanf(lineBuffer, "%f, %f, %f",
@@ -293,7 +644,7 @@ static int NavMesh_FromNAV(NavMesh* mesh, FILE* file)
         
         if (current->vertices[0] == next->vertices[0] || current->vertices[0] == next->vertices[1])
         {
-            unsigned short temp = current->vertices[0];
+            int temp = current->vertices[0];
             current->vertices[0] = current->vertices[1];
             current->vertices[1] = temp;
         }
@@ -304,7 +655,7 @@ static int NavMesh_FromNAV(NavMesh* mesh, FILE* file)
             
             if (current->vertices[1] == next->vertices[1])
             {
-                unsigned short temp = next->vertices[0];
+                int temp = next->vertices[0];
                 next->vertices[0] = next->vertices[1];
                 next->vertices[1] = temp;
             }
@@ -317,23 +668,339 @@ static int NavMesh_FromNAV(NavMesh* mesh, FILE* file)
     return 1;
 }
 
+/*
+ .bnav is the in memory layout of a mesh written straight to disk,
+ with bounds, planes, bases and edge winding already computed.
+ It is loaded with a single read, and no parsing.
+ The struct sizes are stored so that a layout change invalidates old files.
+ A visibility table may follow the mesh, files without one still load.
+ */
+
+#define NAV_BNAV_VERSION 3
+
+typedef struct
+{
+    int32_t version;
+    int32_t vertexCount;
+    int32_t polyCount;
+    int32_t edgeCount;
+    int32_t polySize;
+    int32_t edgeSize;
+} NavBNAVHeader;
+
+/* areas index filter tables, costs must keep the search moving forward,
+   and every index must be in range */
+static int NavMesh_Validate(const NavMesh* mesh)
+{
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        if (mesh->polys[i].area >= NAV_AREA_COUNT || !NavMesh_ValidPoly(mesh, i))
+            return 0;
+    }
+    
+    for (int i = 0; i < mesh->edgeCount; ++i)
+    {
+        if (!(mesh->edges[i].cost >= NAV_EDGE_COST_MIN && mesh->edges[i].cost < INFINITY))
+            return 0;
+        
+        if (!NavMesh_ValidEdge(mesh, mesh->edges + i))
+            return 0;
+    }
+    
+    return 1;
+}
+
+static int NavMesh_FromBNAV(NavMesh* mesh, FILE* file)
+{
+    NavBNAVHeader header;
+    
+    // stored little endian
+    if (End_IsBig())
+        return 0;
+    
+    if (fread(&header, sizeof(header), 1, file) != 1)
+        return 0;
+    
+    if (header.version != NAV_BNAV_VERSION ||
+        header.polySize != sizeof(NavPoly) ||
+        header.edgeSize != sizeof(NavEdge))
+    {
+        return 0;
+    }
+    
+    if (!NavMesh_ValidCounts(header.vertexCount, header.edgeCount, header.polyCount))
+        return 0;
+    
+    if (!NavMesh_Init(mesh, header.vertexCount, header.edgeCount, header.polyCount))
+        return 0;
+    
+    size_t size = NavMesh_DataSize(header.vertexCount, header.edgeCount, header.polyCount);
+    
+    if (fread(mesh->data, size, 1, file) != 1 || !NavMesh_Validate(mesh))
+    {
+        NavMesh_Shutdown(mesh);
+        return 0;
+    }
+    
+    // optional
+    NavVisibility_Read(&mesh->visibility, mesh->polyCount, file);
+    return 1;
+}
+
+int NavMesh_WriteBNAV(const NavMesh* mesh, const char* path)
+{
+    if (End_IsBig())
+        return 0;
+    
+    FILE* file = fopen(path, "wb");
+    
+    if (!file) return 0;
+    
+    NavBNAVHeader header;
+    header.version = NAV_BNAV_VERSION;
+    header.vertexCount = mesh->vertexCount;
+    header.polyCount = mesh->polyCount;
+    header.edgeCount = mesh->edgeCount;
+    header.polySize = sizeof(NavPoly);
+    header.edgeSize = sizeof(NavEdge);
+    
+    size_t size = NavMesh_DataSize(mesh->vertexCount, mesh->edgeCount, mesh->polyCount);
+    
+    int status = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(mesh->data, size, 1, file) == 1;
+    
+    if (status && mesh->visibility.polyCount > 0)
+        status = NavVisibility_Write(&mesh->visibility, file);
+    
+    fclose(file);
+    return status;
+}
+
+static void NavMesh_BuildBasis(NavMesh* mesh)
+{
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        NavPoly* poly = mesh->polys + i;
+        
+        const NavEdge* originEdge = mesh->edges + poly->edgeStart;
+        Vec3 origin = mesh->vertices[originEdge->vertices[0]];
+        
+        // get vector in polygon
+        poly->right = Vec3_Norm(Vec3_Sub(mesh->vertices[originEdge->vertices[1]], origin));
+        
+        // get up vector
+        poly->up = Vec3_Norm(Vec3_Cross(poly->right, poly->plane.normal));
+        
+        // project polygon edge points into face local vector space
+        for (int j = 0; j < poly->edgeCount; ++j)
+        {
+            const NavEdge* edge = mesh->edges + poly->edgeStart + j;
+            Vec3 pa = Vec3_Sub(mesh->vertices[edge->vertices[0]], origin);
+            
+            mesh->edgePoints[poly->edgeStart + j] = Vec2_Create(Vec3_Dot(pa, poly->right),
+                                                                Vec3_Dot(pa, poly->up));
+        }
+    }
+}
+
+/* smoothing offsets portals along their edges, so directions are normalized once here */
+static int NavMesh_BuildEdgeDirs(NavMesh* mesh)
+{
+    mesh->edgeDirs = malloc(sizeof(Vec3) * MAX(mesh->edgeCount, 1));
+    
+    if (!mesh->edgeDirs)
+        return 0;
+    
+    for (int i = 0; i < mesh->edgeCount; ++i)
+    {
+        const NavEdge* edge = mesh->edges + i;
+        mesh->edgeDirs[i] = Vec3_Norm(Vec3_Sub(mesh->vertices[edge->vertices[0]], mesh->vertices[edge->vertices[1]]));
+    }
+    
+    return 1;
+}
+
+static int NavMesh_BuildLinks(NavMesh* mesh)
+{
+    NavLinks* links = &mesh->links;
+    
+    // largest members first, so each array is aligned
+    size_t size = sizeof(Vec3) * mesh->edgeCount +
+        sizeof(int) * mesh->edgeCount +
+        sizeof(float) * mesh->edgeCount +
+        sizeof(int) * (mesh->polyCount + 1) +
+        sizeof(unsigned char) * mesh->polyCount;
+    
+    links->data = malloc(size);
+    
+    if (!links->data)
+        return 0;
+    
+    char* cursor = links->data;
+    
+    links->midpoints = (Vec3*)cursor;
+    cursor += sizeof(Vec3) * mesh->edgeCount;
+    
+    links->neighbors = (int*)cursor;
+    cursor += sizeof(int) * mesh->edgeCount;
+    
+    links->costs = (float*)cursor;
+    cursor += sizeof(float) * mesh->edgeCount;
+    
+    links->edgeStarts = (int*)cursor;
+    cursor += sizeof(int) * (mesh->polyCount + 1);
+    
+    links->areas = (unsigned char*)cursor;
+    
+    for (int i = 0; i < mesh->edgeCount; ++i)
+    {
+        const NavEdge* edge = mesh->edges + i;
+        
+        links->midpoints[i] = Vec3_Lerp(mesh->vertices[edge->vertices[0]], mesh->vertices[edge->vertices[1]], 0.5f);
+        links->neighbors[i] = edge->neighborIndex;
+        links->costs[i] = edge->cost;
+    }
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        links->edgeStarts[i] = mesh->polys[i].edgeStart;
+        links->areas[i] = mesh->polys[i].area;
+    }
+    
+    links->edgeStarts[mesh->polyCount] = mesh->polys[mesh->polyCount - 1].edgeStart + mesh->polys[mesh->polyCount - 1].edgeCount;
+    return 1;
+}
+
+#define NAV_GRID_DIMENSION_MAX 512
+
+static void NavGrid_CellRange(const NavGrid* grid, AABB bounds, int* minCell, int* maxCell)
+{
+    for (int k = 0; k < 2; ++k)
+    {
+        int cellCount = (k == 0) ? grid->width : grid->height;
+        float o = Vec2_Get(grid->origin, k);
+        
+        minCell[k] = (int)floorf((Vec3_Get(bounds.min, k) - o) / grid->cellSize);
+        maxCell[k] = (int)floorf((Vec3_Get(bounds.max, k) - o) / grid->cellSize);
+        
+        minCell[k] = CLAMP(minCell[k], 0, cellCount - 1);
+        maxCell[k] = CLAMP(maxCell[k], 0, cellCount - 1);
+    }
+}
+
+static int NavMesh_BuildGrid(NavMesh* mesh)
+{
+    NavGrid* grid = &mesh->grid;
+    
+    if (mesh->polyCount < 1)
+        return 1;
+    
+    Vec2 min = Vec2_Create(INFINITY, INFINITY);
+    Vec2 max = Vec2_Create(-INFINITY, -INFINITY);
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        const NavPoly* poly = mesh->polys + i;
+        min.x = MIN(min.x, poly->bounds.min.x);
+        min.y = MIN(min.y, poly->bounds.min.y);
+        max.x = MAX(max.x, poly->bounds.max.x);
+        max.y = MAX(max.y, poly->bounds.max.y);
+    }
+    
+    // aim for about one poly per cell
+    float sizeX = MAX(max.x - min.x, V_EPSILON);
+    float sizeY = MAX(max.y - min.y, V_EPSILON);
+    
+    grid->cellSize = sqrtf((sizeX * sizeY) / mesh->polyCount);
+    grid->cellSize = MAX(grid->cellSize, MAX(sizeX, sizeY) / NAV_GRID_DIMENSION_MAX);
+    
+    grid->origin = min;
+    grid->width = MAX((int)ceilf(sizeX / grid->cellSize), 1);
+    grid->height = MAX((int)ceilf(sizeY / grid->cellSize), 1);
+    
+    int cellCount = grid->width * grid->height;
+    
+    grid->cellStart = calloc(cellCount + 1, sizeof(int));
+    if (!grid->cellStart)
+        return 0;
+    
+    // count polys in each cell, then offset into a single packed array
+    int minCell[2];
+    int maxCell[2];
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        NavGrid_CellRange(grid, mesh->polys[i].bounds, minCell, maxCell);
+        
+        for (int y = minCell[1]; y <= maxCell[1]; ++y)
+            for (int x = minCell[0]; x <= maxCell[0]; ++x)
+                ++grid->cellStart[y * grid->width + x + 1];
+    }
+    
+    for (int i = 0; i < cellCount; ++i)
+        grid->cellStart[i + 1] += grid->cellStart[i];
+    
+    grid->cellPolys = malloc(sizeof(int) * MAX(grid->cellStart[cellCount], 1));
+    int* fill = malloc(sizeof(int) * cellCount);
+    
+    if (!grid->cellPolys || !fill)
+    {
+        free(fill);
+        return 0;
+    }
+    
+    memcpy(fill, grid->cellStart, sizeof(int) * cellCount);
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        NavGrid_CellRange(grid, mesh->polys[i].bounds, minCell, maxCell);
+        
+        for (int y = minCell[1]; y <= maxCell[1]; ++y)
+            for (int x = minCell[0]; x <= maxCell[0]; ++x)
+                grid->cellPolys[fill[y * grid->width + x]++] = i;
+    }
+    
+    free(fill);
+    return 1;
+}
+
 int NavMesh_FromPath(NavMesh* mesh, const char* path)
 {
-    FILE* file = fopen(path, "r");
+    int binary = strcmp(Filepath_Extension(path), "bnav") == 0;
+    FILE* file = fopen(path, binary ? "rb" : "r");
     
     if (!file) return 0;
     
+    // the readers may fail before or after allocating, either way shutting down is safe
+    memset(mesh, 0, sizeof(NavMesh));
+    
     int status = 0;
     
-    if (strcmp(Filepath_Extension(path), "nav") == 0)
+    if (binary)
+    {
+        status = NavMesh_FromBNAV(mesh, file);
+    }
+    else if (strcmp(Filepath_Extension(path), "nav") == 0)
     {
         status = NavMesh_FromNAV(mesh, file);
+        
+        if (status)
+            NavMesh_BuildBasis(mesh);
     }
     
     fclose(file);
     
     if (!status)
+    {
+        NavMesh_Shutdown(mesh);
         return 0;
+    }
+    
+    if (!NavMesh_BuildEdgeDirs(mesh) || !NavMesh_BuildLinks(mesh) || !NavMesh_BuildGrid(mesh))
+    {
+        NavMesh_Shutdown(mesh);
+        return 0;
+    }
     
     return 1;
 }
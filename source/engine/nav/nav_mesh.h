@@ -4,13 +4,33 @@
 
 #include "vec_math.h"
 #include "geo_math.h"
+#include "nav_region.h"
+#include "nav_visibility.h"
+#include "nav_obstacle.h"
 
 typedef enum
 {
     kNavEdgeFlagNone = 0,
     kNavEdgeFlagSolid = 1 << 0,
+    // this bit and above are free for levels to mark edges, see NavQueryFilter
+    kNavEdgeFlagCustom = 1 << 8,
 } NavEdgeFlag;
 
+#define NAV_AREA_COUNT 16
+
+// edge costs below this are rejected when loading
+#define NAV_EDGE_COST_MIN 0.01f
+
+/* the kind of ground a poly covers, solves scale or skip areas with a NavQueryFilter.
+   Areas past these are free for levels to use. */
+typedef enum
+{
+    kNavAreaGround = 0,
+    kNavAreaAcid,
+    kNavAreaHealer,
+    kNavAreaThreat,
+} NavArea;
+
 
 /*
  Nav edges store both positions and connectivity
@@ -19,57 +39,179 @@ typedef enum
 
 typedef struct
 {
-    /* the index of the poly connected to */
     NavEdgeFlag flags;
-
-    // -1 if no connection
-    short neighborIndex;
-    unsigned short vertices[2];
+    
+    /* the index of the poly connected to, -1 if no connection */
+    int neighborIndex;
+    int vertices[2];
+    
+    // scales the path cost of crossing this poly to this edge, 1 for plain ground
+    float cost;
 } NavEdge;
 
 typedef struct
 {
     // index into mesh edges
-    unsigned short edgeStart;
+    int edgeStart;
     // how many edges in this poly?
-    unsigned short edgeCount;
-
+    int edgeCount;
+    
     // stores polygon normal and center
     Plane plane;
     AABB bounds;
     
-    unsigned short index;
+    // local 2D basis for point in polygon tests, the origin is the first edge vertex
+    Vec3 right;
+    Vec3 up;
+    
+    int index;
+    // NavArea, less than NAV_AREA_COUNT
+    unsigned char area;
 } NavPoly;
 
+/*
+ uniform 2D grid over the XY bounds of the polys.
+ Used to limit raycasts to the polys along the path of the ray.
+ */
+
+typedef struct
+{
+    Vec2 origin;
+    float cellSize;
+    int width;
+    int height;
+    
+    // cell i overlaps cellPolys[cellStart[i]] through cellPolys[cellStart[i + 1] - 1]
+    int* cellStart;
+    int* cellPolys;
+} NavGrid;
+
+/*
+ The parts of the mesh a search reads, copied out of the polys and edges at load,
+ so those must not be changed afterward.
+ Expanding a poly only needs where its edges lead, what they cost, and their midpoints,
+ so packing these on their own keeps the geometry raycasts use out of the cache.
+ Edges are stored poly by poly, so the edges of poly i are
+ edgeStarts[i] through edgeStarts[i + 1] - 1.
+ */
+
 typedef struct
 {
-    unsigned short vertexCount;
-    unsigned short polyCount;
-    unsigned short edgeCount;
+    // single allocation holding the arrays below
+    void* data;
+    
+    // polyCount + 1 entries
+    int* edgeStarts;
+    // NavArea of each poly
+    unsigned char* areas;
     
+    // the same as NavEdge neighborIndex and cost
+    int* neighbors;
+    float* costs;
+    Vec3* midpoints;
+} NavLinks;
 
+typedef struct
+{
+    int vertexCount;
+    int polyCount;
+    int edgeCount;
+    
+    // single allocation holding the arrays below
+    void* data;
+    
     Vec3* vertices;
     NavPoly* polys;
     NavEdge* edges;
+    
+    // the first vertex of each edge, projected into its poly basis
+    Vec2* edgePoints;
+    
+    // normalized direction from the second vertex of each edge to the first, built at load
+    Vec3* edgeDirs;
+    
+    // used by searches instead of polys and edges
+    NavLinks links;
+    
+    NavGrid grid;
+    
+    // empty unless built with NavMesh_BuildRegions
+    NavRegions regions;
+    
+    // empty unless built with NavMesh_BuildVisibility, or loaded from a .bnav which has it
+    NavVisibility visibility;
+    
+    // units and props blocking polys, changes while the level runs
+    NavObstacles obstacles;
 } NavMesh;
 
 extern int NavMesh_Init(NavMesh* mesh,
-                        unsigned short vertexCount,
-                        unsigned short edgeCount,
-                        unsigned short polyCount);
+                        int vertexCount,
+                        int edgeCount,
+                        int polyCount);
 
 extern int NavMesh_FromPath(NavMesh* mesh, const char* path);
 
 extern void NavMesh_Shutdown(NavMesh* mesh);
 
+/* writes a .bnav, including the visibility table if it has been built */
+extern int NavMesh_WriteBNAV(const NavMesh* mesh, const char* path);
+
 // returns the poly at the connection given by the index
 extern NavPoly* NavMesh_GetPolyNeighbor(const NavMesh* mesh,
                                         const NavPoly* poly,
                                         int edgeIndex);
 
 extern NavPoly* NavMesh_Raycast(const NavMesh* mesh, Ray3 ray, float* t);
+/* the same, also counting the polys tested against the ray */
+extern NavPoly* NavMesh_RaycastTested(const NavMesh* mesh, Ray3 ray, float* t, int* polysTested);
+
+/* finds the poly straight down from point, like a raycast,
+   but walks across neighbors from hintPoly first.
+   Falls back to a full raycast if the walk does not find it. */
+extern NavPoly* NavMesh_LocatePoint(const NavMesh* mesh,
+                                    const NavPoly* hintPoly,
+                                    Vec3 point,
+                                    float* t);
 
 
+typedef struct
+{
+    // fraction of the way from start to end
+    float t;
+    Vec3 point;
+    
+    // the poly the line stopped in, and the edge it hit, -1 if it hit the surface
+    const NavPoly* poly;
+    int edgeIndex;
+    
+    // how many polys the line entered, set whether or not it hit
+    int polysCrossed;
+} NavLineHit;
+
+/* walks the polys under the line from start to end in XY, beginning on startPoly.
+   Returns 1 if the line leaves a poly through an edge matching queryFlags,
+   or passes through the surface of a poly it crosses.
+   The cost is proportional to the number of polys crossed.
+   If the line leaves the mesh there is no hit. */
+extern int NavMesh_LineWalk(const NavMesh* mesh,
+                            const NavPoly* startPoly,
+                            Vec3 start,
+                            Vec3 end,
+                            NavEdgeFlag queryFlags,
+                            NavLineHit* hit);
+
+/* tests line of sight between each pair of polys within range of each other (see nav_visibility.h).
+   This walks many lines per pair, so large meshes should bake it into their .bnav offline. */
+extern int NavMesh_BuildVisibility(NavMesh* mesh, float range);
+
+/* places obstacle id over poly, blocking it and the polys around with centers within radius of center.
+   Ids are chosen by the caller and may be sparse. Setting the same again costs nothing,
+   otherwise only the polys the obstacle left and entered are updated. Returns 0 if it could not allocate. */
+extern int NavMesh_SetObstacle(NavMesh* mesh, int id, const NavPoly* poly, Vec3 center, float radius);
+/* takes obstacle id off the mesh, if it was on */
+extern void NavMesh_ClearObstacle(NavMesh* mesh, int id);
+
 /* this is for determining if a line crosses a nav mesh edge.
    This is useful for detecting intersections with solid edges */
 extern int NavMesh_LineEdgeCast(const NavMesh* mesh,
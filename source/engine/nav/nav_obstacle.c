@@ -0,0 +1,194 @@
+
+#include "nav_mesh.h"
+#include "stretchy_buffer.h"
+#include <stdlib.h>
+#include <assert.h>
+
+// polys looked at around an obstacle, those past this are left clear
+#define NAV_OBSTACLE_VISIT_MAX (NAV_OBSTACLE_POLYS_MAX * 4)
+
+void NavObstacles_Shutdown(NavObstacles* obstacles)
+{
+    stb_sb_free(obstacles->obstacles);
+    free(obstacles->polyBlockers);
+    free(obstacles->blockedPolys);
+    free(obstacles->blockedSlots);
+    
+    memset(obstacles, 0, sizeof(NavObstacles));
+}
+
+static int NavObstacles_Prepare(NavObstacles* obstacles, int polyCount)
+{
+    if (obstacles->polyCount == polyCount)
+        return 1;
+    
+    NavObstacles_Shutdown(obstacles);
+    
+    obstacles->polyBlockers = calloc(polyCount, sizeof(unsigned short));
+    obstacles->blockedPolys = malloc(sizeof(int) * polyCount);
+    obstacles->blockedSlots = malloc(sizeof(int) * polyCount);
+    
+    if (!obstacles->polyBlockers || !obstacles->blockedPolys || !obstacles->blockedSlots)
+    {
+        NavObstacles_Shutdown(obstacles);
+        return 0;
+    }
+    
+    for (int i = 0; i < polyCount; ++i)
+        obstacles->blockedSlots[i] = -1;
+    
+    obstacles->polyCount = polyCount;
+    return 1;
+}
+
+static void NavObstacles_Block(NavObstacles* obstacles, int polyIndex)
+{
+    if (obstacles->polyBlockers[polyIndex]++ > 0)
+        return;
+    
+    obstacles->blockedSlots[polyIndex] = obstacles->blockedCount;
+    obstacles->blockedPolys[obstacles->blockedCount++] = polyIndex;
+    ++obstacles->version;
+}
+
+static void NavObstacles_Unblock(NavObstacles* obstacles, int polyIndex)
+{
+    assert(obstacles->polyBlockers[polyIndex] > 0);
+    
+    if (--obstacles->polyBlockers[polyIndex] > 0)
+        return;
+    
+    // move the last blocked poly into the gap
+    int slot = obstacles->blockedSlots[polyIndex];
+    int last = obstacles->blockedPolys[--obstacles->blockedCount];
+    
+    obstacles->blockedPolys[slot] = last;
+    obstacles->blockedSlots[last] = slot;
+    obstacles->blockedSlots[polyIndex] = -1;
+    ++obstacles->version;
+}
+
+/* the poly itself, then a walk across neighbors whose bounds reach the circle */
+static int NavObstacle_FindPolys(const NavMesh* mesh, const NavPoly* poly, Vec3 center, float radius, int* outPolys)
+{
+    int visited[NAV_OBSTACLE_VISIT_MAX];
+    int visitedCount = 0;
+    int polyCount = 0;
+    
+    visited[visitedCount++] = poly->index;
+    outPolys[polyCount++] = poly->index;
+    
+    if (radius <= 0.0f)
+        return polyCount;
+    
+    for (int i = 0; i < visitedCount && polyCount < NAV_OBSTACLE_POLYS_MAX; ++i)
+    {
+        const NavPoly* current = mesh->polys + visited[i];
+        
+        for (int j = 0; j < current->edgeCount; ++j)
+        {
+            int neighborIndex = mesh->edges[current->edgeStart + j].neighborIndex;
+            if (neighborIndex == -1) continue;
+            
+            int seen = 0;
+            
+            for (int k = 0; k < visitedCount; ++k)
+                seen |= visited[k] == neighborIndex;
+            
+            if (seen || visitedCount == NAV_OBSTACLE_VISIT_MAX)
+                continue;
+            
+            const NavPoly* neighbor = mesh->polys + neighborIndex;
+            
+            // the closest point of the bounds in XY is out of reach
+            float dx = MAX(MAX(neighbor->bounds.min.x - center.x, center.x - neighbor->bounds.max.x), 0.0f);
+            float dy = MAX(MAX(neighbor->bounds.min.y - center.y, center.y - neighbor->bounds.max.y), 0.0f);
+            
+            if (dx * dx + dy * dy > radius * radius)
+                continue;
+            
+            visited[visitedCount++] = neighborIndex;
+            
+            Vec2 offset = Vec2_Sub(Vec2_FromVec3(neighbor->plane.point), Vec2_FromVec3(center));
+            
+            if (Vec2_LengthSq(offset) <= radius * radius && polyCount < NAV_OBSTACLE_POLYS_MAX)
+                outPolys[polyCount++] = neighborIndex;
+        }
+    }
+    
+    return polyCount;
+}
+
+static NavObstacle* NavObstacles_Get(NavObstacles* obstacles, int id)
+{
+    while (stb_sb_count(obstacles->obstacles) <= id)
+    {
+        NavObstacle empty;
+        empty.centerPoly = -1;
+        empty.center = Vec3_Zero;
+        empty.radius = 0.0f;
+        empty.polyCount = 0;
+        
+        stb_sb_push(obstacles->obstacles, empty);
+    }
+    
+    return obstacles->obstacles + id;
+}
+
+int NavMesh_SetObstacle(NavMesh* mesh, int id, const NavPoly* poly, Vec3 center, float radius)
+{
+    assert(id >= 0);
+    
+    if (!poly)
+    {
+        NavMesh_ClearObstacle(mesh, id);
+        return 1;
+    }
+    
+    NavObstacles* obstacles = &mesh->obstacles;
+    
+    if (!NavObstacles_Prepare(obstacles, mesh->polyCount))
+        return 0;
+    
+    NavObstacle* obstacle = NavObstacles_Get(obstacles, id);
+    
+    // standing still
+    if (obstacle->centerPoly == poly->index && obstacle->radius == radius &&
+        (radius <= 0.0f || (obstacle->center.x == center.x && obstacle->center.y == center.y)))
+    {
+        return 1;
+    }
+    
+    int polys[NAV_OBSTACLE_POLYS_MAX];
+    int polyCount = NavObstacle_FindPolys(mesh, poly, center, radius, polys);
+    
+    // block the new polys before clearing the old, so a poly in both never changes state
+    for (int i = 0; i < polyCount; ++i)
+        NavObstacles_Block(obstacles, polys[i]);
+    
+    for (int i = 0; i < obstacle->polyCount; ++i)
+        NavObstacles_Unblock(obstacles, obstacle->polys[i]);
+    
+    memcpy(obstacle->polys, polys, sizeof(int) * polyCount);
+    obstacle->polyCount = polyCount;
+    obstacle->centerPoly = poly->index;
+    obstacle->center = center;
+    obstacle->radius = radius;
+    return 1;
+}
+
+void NavMesh_ClearObstacle(NavMesh* mesh, int id)
+{
+    NavObstacles* obstacles = &mesh->obstacles;
+    
+    if (id >= stb_sb_count(obstacles->obstacles))
+        return;
+    
+    NavObstacle* obstacle = obstacles->obstacles + id;
+    
+    for (int i = 0; i < obstacle->polyCount; ++i)
+        NavObstacles_Unblock(obstacles, obstacle->polys[i]);
+    
+    obstacle->polyCount = 0;
+    obstacle->centerPoly = -1;
+}
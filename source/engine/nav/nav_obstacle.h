@@ -0,0 +1,58 @@
+
+#ifndef NAV_OBSTACLE_H
+#define NAV_OBSTACLE_H
+
+#include "vec_math.h"
+
+// most polys one obstacle can block
+#define NAV_OBSTACLE_POLYS_MAX 16
+
+/*
+ Temporary obstacles on the mesh, such as units and props standing on it.
+ Each blocks the poly under it, and the polys near it with centers inside its radius.
+ Searches close blocked polys before they start, except their start and end polys,
+ so a unit on a blocked poly can still leave, and a blocked poly can still be a goal.
+ Moving an obstacle only touches the polys it leaves and enters.
+ */
+
+typedef struct
+{
+    // -1 when the obstacle is not on the mesh
+    int centerPoly;
+    Vec3 center;
+    float radius;
+    
+    int polyCount;
+    int polys[NAV_OBSTACLE_POLYS_MAX];
+} NavObstacle;
+
+typedef struct
+{
+    // stretchy buffer, indexed by obstacle id
+    NavObstacle* obstacles;
+    
+    // allocated the first time an obstacle is set
+    int polyCount;
+    
+    // how many obstacles are on each poly
+    unsigned short* polyBlockers;
+    
+    // every poly with blockers, in no order
+    int* blockedPolys;
+    int blockedCount;
+    
+    // the index of each poly in blockedPolys, -1 if it is clear
+    int* blockedSlots;
+    
+    // changes whenever a poly becomes blocked or clear
+    unsigned int version;
+} NavObstacles;
+
+extern void NavObstacles_Shutdown(NavObstacles* obstacles);
+
+static inline int NavObstacles_IsBlocked(const NavObstacles* obstacles, int polyIndex)
+{
+    return obstacles->blockedCount > 0 && obstacles->polyBlockers[polyIndex] > 0;
+}
+
+#endif
@@ -0,0 +1,113 @@
+
+#include "nav_profile.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+NavProfile* NavProfile_Create(void)
+{
+    NavProfile* profile = calloc(1, sizeof(NavProfile));
+    
+    if (!profile)
+        return NULL;
+    
+    const char* logPath = getenv("NAV_QUERY_LOG");
+    
+    if (logPath && logPath[0])
+    {
+        profile->log = fopen(logPath, "w");
+        
+        if (!profile->log)
+            printf("nav: could not open query log %s\n", logPath);
+    }
+    
+    return profile;
+}
+
+void NavProfile_Destroy(NavProfile* profile)
+{
+    if (!profile)
+        return;
+    
+    if (profile->log)
+        fclose(profile->log);
+    
+    free(profile);
+}
+
+const char* NavProfile_QueryName(NavQueryType type)
+{
+    switch (type)
+    {
+        case kNavQueryRaycast: return "raycast";
+        case kNavQuerySolve: return "solve";
+        case kNavQuerySmooth: return "smooth";
+        case kNavQueryLine: return "line";
+        default: return "unknown";
+    }
+}
+
+uint64_t NavProfile_Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void NavProfile_Add(NavProfile* profile, NavQueryType type, uint64_t start, long polys, long expansions)
+{
+    if (!profile)
+        return;
+    
+    NavQueryStats* stats = profile->tick + type;
+    ++stats->calls;
+    stats->polys += polys;
+    stats->expansions += expansions;
+    stats->nanoseconds += NavProfile_Now() - start;
+}
+
+void NavProfile_EndTick(NavProfile* profile)
+{
+    if (!profile)
+        return;
+    
+    for (int i = 0; i < kNavQueryCount; ++i)
+    {
+        NavQueryStats* tick = profile->tick + i;
+        NavQueryStats* total = profile->total + i;
+        
+        total->calls += tick->calls;
+        total->polys += tick->polys;
+        total->expansions += tick->expansions;
+        total->nanoseconds += tick->nanoseconds;
+    }
+    
+    memcpy(profile->lastTick, profile->tick, sizeof(profile->tick));
+    memset(profile->tick, 0, sizeof(profile->tick));
+    ++profile->ticks;
+    
+    if (profile->log)
+        fprintf(profile->log, "tick\n");
+    
+    if (profile->ticks % NAV_PROFILE_PRINT_TICKS == 0)
+        NavProfile_Print(profile, stdout);
+}
+
+void NavProfile_Print(const NavProfile* profile, FILE* file)
+{
+    int ticks = profile->ticks > 0 ? profile->ticks : 1;
+    
+    fprintf(file, "nav profile, %i ticks, per tick:\n", profile->ticks);
+    
+    for (int i = 0; i < kNavQueryCount; ++i)
+    {
+        const NavQueryStats* total = profile->total + i;
+        
+        fprintf(file, "  %-8s %8.2f calls %10.1f polys %10.1f expansions %9.3f us\n",
+                NavProfile_QueryName(i),
+                total->calls / (double)ticks,
+                total->polys / (double)ticks,
+                total->expansions / (double)ticks,
+                total->nanoseconds / (ticks * 1000.0));
+    }
+}
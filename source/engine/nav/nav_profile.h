@@ -0,0 +1,84 @@
+
+#ifndef NAV_PROFILE_H
+#define NAV_PROFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ Counters and timers for nav queries, built in when NAV_PROFILE is defined.
+ Without it the macros below do nothing and NavSystem has no profile.
+ 
+ When the NAV_QUERY_LOG environment variable names a file,
+ queries are also written there one per line, so navbench can replay them
+ against the same mesh (navbench <file.nav> --replay <log>).
+ Query filters are not recorded, replays use the default.
+ */
+
+// how often the per tick averages are printed
+#define NAV_PROFILE_PRINT_TICKS 600
+
+typedef enum
+{
+    kNavQueryRaycast = 0,
+    kNavQuerySolve,
+    kNavQuerySmooth,
+    kNavQueryLine,
+    kNavQueryCount,
+} NavQueryType;
+
+typedef struct
+{
+    int calls;
+    
+    // polys tested by rays, in solved corridors, in smoothed paths or crossed by lines
+    long polys;
+    // search nodes closed by solves
+    long expansions;
+    
+    uint64_t nanoseconds;
+} NavQueryStats;
+
+typedef struct
+{
+    // the tick in progress, the last finished tick and every tick so far
+    NavQueryStats tick[kNavQueryCount];
+    NavQueryStats lastTick[kNavQueryCount];
+    NavQueryStats total[kNavQueryCount];
+    
+    int ticks;
+    
+    // NULL unless NAV_QUERY_LOG is set
+    FILE* log;
+} NavProfile;
+
+extern NavProfile* NavProfile_Create(void);
+extern void NavProfile_Destroy(NavProfile* profile);
+
+extern const char* NavProfile_QueryName(NavQueryType type);
+
+extern uint64_t NavProfile_Now(void);
+extern void NavProfile_Add(NavProfile* profile, NavQueryType type, uint64_t start, long polys, long expansions);
+
+extern void NavProfile_EndTick(NavProfile* profile);
+extern void NavProfile_Print(const NavProfile* profile, FILE* file);
+
+#ifdef NAV_PROFILE
+
+#define NAV_PROFILE_START(start) uint64_t start = NavProfile_Now()
+#define NAV_PROFILE_ADD(profile, type, start, polys, expansions) \
+    NavProfile_Add(profile, type, start, polys, expansions)
+
+// fprintf arguments, written to the query log if there is one
+#define NAV_PROFILE_LOG(profile, ...) \
+    do { if ((profile) && (profile)->log) fprintf((profile)->log, __VA_ARGS__); } while (0)
+
+#else
+
+#define NAV_PROFILE_START(start)
+#define NAV_PROFILE_ADD(profile, type, start, polys, expansions) ((void)0)
+#define NAV_PROFILE_LOG(profile, ...) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,321 @@
+
+#include "nav.h"
+#include <stdlib.h>
+#include <assert.h>
+
+void NavRegions_Shutdown(NavRegions* regions)
+{
+    free(regions->regions);
+    free(regions->exits);
+    free(regions->costs);
+    free(regions->polyRegions);
+    free(regions->regionPolys);
+    
+    memset(regions, 0, sizeof(NavRegions));
+}
+
+/* a region is a connected group of polys whose centers share a cell,
+   so every exit of a region can be reached without leaving it */
+static int NavRegions_Group(NavRegions* regions, const NavMesh* mesh)
+{
+    Vec2 min = Vec2_Create(INFINITY, INFINITY);
+    Vec2 max = Vec2_Create(-INFINITY, -INFINITY);
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        Vec3 center = mesh->polys[i].plane.point;
+        min.x = MIN(min.x, center.x);
+        min.y = MIN(min.y, center.y);
+        max.x = MAX(max.x, center.x);
+        max.y = MAX(max.y, center.y);
+    }
+    
+    float sizeX = MAX(max.x - min.x, V_EPSILON);
+    float sizeY = MAX(max.y - min.y, V_EPSILON);
+    float cellSize = sqrtf((sizeX * sizeY * NAV_REGION_POLYS) / mesh->polyCount);
+    int width = MAX((int)ceilf(sizeX / cellSize), 1);
+    
+    int* cells = malloc(sizeof(int) * mesh->polyCount);
+    int* stack = malloc(sizeof(int) * mesh->polyCount);
+    regions->polyRegions = malloc(sizeof(int) * mesh->polyCount);
+    
+    if (!cells || !stack || !regions->polyRegions)
+    {
+        free(cells);
+        free(stack);
+        return 0;
+    }
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        Vec3 center = mesh->polys[i].plane.point;
+        int x = MIN((int)((center.x - min.x) / cellSize), width - 1);
+        int y = (int)((center.y - min.y) / cellSize);
+        
+        cells[i] = y * width + x;
+        regions->polyRegions[i] = -1;
+    }
+    
+    regions->regionCount = 0;
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        if (regions->polyRegions[i] != -1)
+            continue;
+        
+        int regionIndex = regions->regionCount++;
+        int stackCount = 0;
+        
+        regions->polyRegions[i] = regionIndex;
+        stack[stackCount++] = i;
+        
+        while (stackCount > 0)
+        {
+            const NavPoly* poly = mesh->polys + stack[--stackCount];
+            
+            for (int j = 0; j < poly->edgeCount; ++j)
+            {
+                int neighborIndex = mesh->edges[poly->edgeStart + j].neighborIndex;
+                
+                if (neighborIndex == -1 ||
+                    regions->polyRegions[neighborIndex] != -1 ||
+                    cells[neighborIndex] != cells[i])
+                {
+                    continue;
+                }
+                
+                regions->polyRegions[neighborIndex] = regionIndex;
+                stack[stackCount++] = neighborIndex;
+            }
+        }
+    }
+    
+    free(cells);
+    free(stack);
+    
+    regions->regions = calloc(regions->regionCount, sizeof(NavRegion));
+    regions->regionPolys = malloc(sizeof(int) * mesh->polyCount);
+    
+    if (!regions->regions || !regions->regionPolys)
+        return 0;
+    
+    // count polys in each region, then offset into a single packed array
+    for (int i = 0; i < mesh->polyCount; ++i)
+        ++regions->regions[regions->polyRegions[i]].polyCount;
+    
+    int polyStart = 0;
+    
+    for (int i = 0; i < regions->regionCount; ++i)
+    {
+        regions->regions[i].polyStart = polyStart;
+        polyStart += regions->regions[i].polyCount;
+        regions->regions[i].polyCount = 0;
+    }
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        NavRegion* region = regions->regions + regions->polyRegions[i];
+        regions->regionPolys[region->polyStart + region->polyCount++] = i;
+    }
+    
+    return 1;
+}
+
+typedef struct
+{
+    int region;
+    int neighbor;
+    int polyIndex;
+    int edgeIndex;
+} NavBorderEdge;
+
+static int NavBorderEdge_Compare(const void* a, const void* b)
+{
+    const NavBorderEdge* edgeA = a;
+    const NavBorderEdge* edgeB = b;
+    
+    if (edgeA->region != edgeB->region)
+        return edgeA->region < edgeB->region ? -1 : 1;
+    if (edgeA->neighbor != edgeB->neighbor)
+        return edgeA->neighbor < edgeB->neighbor ? -1 : 1;
+    
+    return edgeA->edgeIndex - edgeB->edgeIndex;
+}
+
+/* one exit for each pair of neighboring regions */
+static int NavRegions_FindExits(NavRegions* regions, const NavMesh* mesh)
+{
+    NavBorderEdge* borders = malloc(sizeof(NavBorderEdge) * MAX(mesh->edgeCount, 1));
+    int borderCount = 0;
+    
+    if (!borders)
+        return 0;
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        const NavPoly* poly = mesh->polys + i;
+        
+        for (int j = 0; j < poly->edgeCount; ++j)
+        {
+            int edgeIndex = poly->edgeStart + j;
+            int neighborIndex = mesh->edges[edgeIndex].neighborIndex;
+            
+            if (neighborIndex == -1 || regions->polyRegions[neighborIndex] == regions->polyRegions[i])
+                continue;
+            
+            NavBorderEdge* border = borders + borderCount++;
+            border->region = regions->polyRegions[i];
+            border->neighbor = regions->polyRegions[neighborIndex];
+            border->polyIndex = i;
+            border->edgeIndex = edgeIndex;
+        }
+    }
+    
+    // runs of edges between the same two regions are one exit
+    qsort(borders, borderCount, sizeof(NavBorderEdge), NavBorderEdge_Compare);
+    
+    regions->exits = malloc(sizeof(NavRegionExit) * MAX(borderCount, 1));
+    regions->exitCount = 0;
+    
+    if (!regions->exits)
+    {
+        free(borders);
+        return 0;
+    }
+    
+    for (int i = 0; i < borderCount; )
+    {
+        int runEnd = i;
+        Vec3 middle = Vec3_Zero;
+        
+        while (runEnd < borderCount &&
+               borders[runEnd].region == borders[i].region &&
+               borders[runEnd].neighbor == borders[i].neighbor)
+        {
+            middle = Vec3_Add(middle, mesh->links.midpoints[borders[runEnd].edgeIndex]);
+            ++runEnd;
+        }
+        
+        middle = Vec3_Scale(middle, 1.0f / (runEnd - i));
+        
+        const NavBorderEdge* closest = borders + i;
+        float closestDist = INFINITY;
+        
+        for (int j = i; j < runEnd; ++j)
+        {
+            float dist = Vec3_Dist(mesh->links.midpoints[borders[j].edgeIndex], middle);
+            
+            if (dist < closestDist)
+            {
+                closestDist = dist;
+                closest = borders + j;
+            }
+        }
+        
+        NavRegionExit* exit = regions->exits + regions->exitCount++;
+        exit->region = closest->region;
+        exit->neighbor = closest->neighbor;
+        exit->polyIndex = closest->polyIndex;
+        exit->edgeIndex = closest->edgeIndex;
+        exit->twin = -1;
+        exit->point = mesh->links.midpoints[closest->edgeIndex];
+        
+        i = runEnd;
+    }
+    
+    free(borders);
+    
+    // exits are sorted by region, then neighbor
+    for (int i = 0; i < regions->exitCount; ++i)
+    {
+        NavRegion* region = regions->regions + regions->exits[i].region;
+        
+        if (region->exitCount == 0)
+            region->exitStart = i;
+        
+        ++region->exitCount;
+    }
+    
+    for (int i = 0; i < regions->exitCount; ++i)
+    {
+        NavRegionExit* exit = regions->exits + i;
+        const NavRegion* neighbor = regions->regions + exit->neighbor;
+        
+        for (int j = neighbor->exitStart; j < neighbor->exitStart + neighbor->exitCount; ++j)
+        {
+            if (regions->exits[j].neighbor == exit->region)
+            {
+                exit->twin = j;
+                break;
+            }
+        }
+    }
+    
+    return 1;
+}
+
+static int NavRegions_ComputeCosts(NavRegions* regions, const NavMesh* mesh)
+{
+    int costCount = 0;
+    
+    for (int i = 0; i < regions->regionCount; ++i)
+    {
+        regions->regions[i].costStart = costCount;
+        costCount += regions->regions[i].exitCount * regions->regions[i].exitCount;
+    }
+    
+    regions->costs = malloc(sizeof(float) * MAX(costCount, 1));
+    
+    if (!regions->costs)
+        return 0;
+    
+    NavSolver solver;
+    NavSolver_Init(&solver);
+    NavSolver_Prepare(&solver, mesh);
+    
+    // flood the region from each exit, then read off the cost to every other exit
+    for (int i = 0; i < regions->regionCount; ++i)
+    {
+        const NavRegion* region = regions->regions + i;
+        
+        for (int a = 0; a < region->exitCount; ++a)
+        {
+            const NavRegionExit* from = regions->exits + region->exitStart + a;
+            
+            NavSolver_CloseAll(&solver, mesh);
+            NavSolver_Allow(&solver, regions->regionPolys + region->polyStart, region->polyCount);
+            NavSolver_Search(&solver, mesh, from->point, from->point, mesh->polys + from->polyIndex, NULL, NULL);
+            
+            float* costs = regions->costs + region->costStart + a * region->exitCount;
+            
+            for (int b = 0; b < region->exitCount; ++b)
+            {
+                const NavRegionExit* to = regions->exits + region->exitStart + b;
+                costs[b] = NavSolver_FloodCost(&solver, mesh, from->point, to->polyIndex, to->point);
+            }
+        }
+    }
+    
+    NavSolver_Shutdown(&solver);
+    return 1;
+}
+
+int NavMesh_BuildRegions(NavMesh* mesh)
+{
+    NavRegions* regions = &mesh->regions;
+    NavRegions_Shutdown(regions);
+    
+    // small meshes are cheap enough to search directly
+    if (mesh->polyCount < NAV_REGION_POLYS * 4)
+        return 1;
+    
+    if (!NavRegions_Group(regions, mesh) ||
+        !NavRegions_FindExits(regions, mesh) ||
+        !NavRegions_ComputeCosts(regions, mesh))
+    {
+        NavRegions_Shutdown(regions);
+        return 0;
+    }
+    
+    return 1;
+}
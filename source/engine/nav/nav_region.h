@@ -0,0 +1,65 @@
+
+#ifndef NAV_REGION_H
+#define NAV_REGION_H
+
+#include "vec_math.h"
+
+// about how many polys are grouped into each region
+#define NAV_REGION_POLYS 64
+
+/*
+ Regions are an optional hierarchy over the nav mesh used for long paths.
+ Polys are grouped into connected regions, and each border between two regions is an exit.
+ Path costs between every pair of exits in a region are computed at load time,
+ so a search can hop from exit to exit instead of visiting every poly.
+ */
+
+typedef struct
+{
+    // polys are regionPolys[polyStart] through regionPolys[polyStart + polyCount - 1]
+    int polyStart;
+    int polyCount;
+    
+    // exits leaving this region
+    int exitStart;
+    int exitCount;
+    
+    // exitCount x exitCount path costs, the cost from exit a to b is costs[costStart + a * exitCount + b]
+    int costStart;
+} NavRegion;
+
+typedef struct
+{
+    // the region being left and the region entered
+    int region;
+    int neighbor;
+    
+    // the boundary edge nearest the middle of the border, and its poly
+    int polyIndex;
+    int edgeIndex;
+    
+    // the exit of the neighbor leading back, -1 if there is none
+    int twin;
+    
+    // edge center
+    Vec3 point;
+} NavRegionExit;
+
+typedef struct
+{
+    int regionCount;
+    int exitCount;
+    
+    NavRegion* regions;
+    NavRegionExit* exits;
+    float* costs;
+    
+    // region index of each poly
+    int* polyRegions;
+    // poly indicies grouped by region
+    int* regionPolys;
+} NavRegions;
+
+extern void NavRegions_Shutdown(NavRegions* regions);
+
+#endif
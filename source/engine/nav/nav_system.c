@@ -1,16 +1,165 @@
 
 #include "nav_system.h"
 #include "platform.h"
+#include "stretchy_buffer.h"
+
+static void NavPathCache_Clear(NavPathCache* cache)
+{
+    for (int i = 0; i < NAV_PATH_CACHE_SIZE; ++i)
+    {
+        cache->entries[i].startPoly = -1;
+        cache->entries[i].endPoly = -1;
+    }
+}
+
+static NavPathCacheEntry* NavPathCache_Find(NavPathCache* cache, int startPoly, int endPoly)
+{
+    for (int i = 0; i < NAV_PATH_CACHE_SIZE; ++i)
+    {
+        NavPathCacheEntry* entry = cache->entries + i;
+        
+        if (entry->startPoly == startPoly && entry->endPoly == endPoly)
+        {
+            entry->lastUsed = ++cache->clock;
+            return entry;
+        }
+    }
+    
+    return NULL;
+}
+
+/* takes an empty entry, or the least recently used */
+static NavPathCacheEntry* NavPathCache_Insert(NavPathCache* cache, int startPoly, int endPoly)
+{
+    NavPathCacheEntry* oldest = cache->entries;
+    
+    for (int i = 0; i < NAV_PATH_CACHE_SIZE; ++i)
+    {
+        NavPathCacheEntry* entry = cache->entries + i;
+        
+        if (entry->startPoly == -1)
+        {
+            oldest = entry;
+            break;
+        }
+        
+        if (entry->lastUsed < oldest->lastUsed)
+            oldest = entry;
+    }
+    
+    oldest->startPoly = startPoly;
+    oldest->endPoly = endPoly;
+    oldest->lastUsed = ++cache->clock;
+    return oldest;
+}
+
+static void NavFlowCache_Clear(NavFlowCache* cache)
+{
+    for (int i = 0; i < NAV_FLOW_FIELD_COUNT; ++i)
+        cache->fields[i].goalPoly = -1;
+}
+
+/* the field toward goalPoly, or the least recently used to build a new one into */
+static NavFlowField* NavFlowCache_Find(NavFlowCache* cache, int goalPoly, int* found)
+{
+    NavFlowField* oldest = cache->fields;
+    *found = 0;
+    
+    for (int i = 0; i < NAV_FLOW_FIELD_COUNT; ++i)
+    {
+        NavFlowField* field = cache->fields + i;
+        
+        if (field->goalPoly == goalPoly)
+        {
+            oldest = field;
+            *found = 1;
+            break;
+        }
+        
+        if (field->lastUsed < oldest->lastUsed)
+            oldest = field;
+    }
+    
+    oldest->lastUsed = ++cache->clock;
+    return oldest;
+}
+
+static void NavPlanner_Init(NavPlanner* planner)
+{
+    NavSolver_Init(&planner->solver);
+    planner->outPath = NULL;
+    planner->radius = 0.0f;
+    planner->ticks = 0;
+    planner->tickExpansions = 0;
+    planner->maxTickExpansions = 0;
+    planner->pathTicks = 0;
+    planner->pathExpansions = 0;
+    planner->filtered = 0;
+    NavQueryFilter_Init(&planner->filter);
+    planner->obstacleVersion = 0;
+}
 
 void NavSystem_Init(NavSystem* system)
 {
     NavSolver_Init(&system->solver);
+    NavPlanner_Init(&system->planner);
+    system->floodCosts = NULL;
+    
+    system->pathCache.clock = 0;
+    system->pathCache.hits = 0;
+    system->pathCache.misses = 0;
+    NavPathCache_Clear(&system->pathCache);
+    
+    for (int i = 0; i < NAV_PATH_CACHE_SIZE; ++i)
+        NavPath_Init(&system->pathCache.entries[i].corridor);
+    
+    system->flowCache.clock = 0;
+    system->flowCache.builds = 0;
+    system->flowCache.hits = 0;
+    
+    for (int i = 0; i < NAV_FLOW_FIELD_COUNT; ++i)
+        NavFlowField_Init(system->flowCache.fields + i);
+    
+    NavAvoidance_Init(&system->avoidance, NAV_AVOID_TIME_HORIZON);
+    NavBatch_Init(&system->batch, NavBatch_DefaultThreadCount());
+
+#ifdef NAV_PROFILE
+    system->profile = NavProfile_Create();
+#else
+    system->profile = NULL;
+#endif
 }
 
 void NavSystem_Shutdown(NavSystem* system)
 {
     NavSolver_Shutdown(&system->solver);
+    NavSolver_Shutdown(&system->planner.solver);
+    NavBatch_Shutdown(&system->batch);
     NavSystem_LoadMesh(system, NULL);
+    
+    if (system->floodCosts)
+        stb_sb_free(system->floodCosts);
+    
+    system->floodCosts = NULL;
+    
+    for (int i = 0; i < NAV_PATH_CACHE_SIZE; ++i)
+        NavPath_Shutdown(&system->pathCache.entries[i].corridor);
+    
+    for (int i = 0; i < NAV_FLOW_FIELD_COUNT; ++i)
+        NavFlowField_Shutdown(system->flowCache.fields + i);
+    
+    NavAvoidance_Shutdown(&system->avoidance);
+    NavProfile_Destroy(system->profile);
+    system->profile = NULL;
+}
+
+void NavSystem_EndTick(NavSystem* system)
+{
+#ifdef NAV_PROFILE
+    NavProfile_EndTick(system->profile);
+#else
+    (void)system;
+#endif
 }
 
 int NavSystem_LoadMesh(NavSystem* system, const char* path)
@@ -24,17 +173,45 @@ int NavSystem_LoadMesh(NavSystem* system, const char* path)
     char fullPath[MAX_OS_PATH];
     Filepath_Append(fullPath, Filepath_DataDir(), path);
     
+    NAV_PROFILE_LOG(system->profile, "mesh %s\n", path);
+    
+    // cached and planned paths refer to polys of the old mesh
+    NavPathCache_Clear(&system->pathCache);
+    NavFlowCache_Clear(&system->flowCache);
+    system->planner.outPath = NULL;
+    
     int result = NavMesh_FromPath(&system->navMesh, fullPath);
     
     if (result)
+    {
+        // regions are optional, paths are still solved without them
+        NavMesh_BuildRegions(&system->navMesh);
         NavSolver_Prepare(&system->solver, &system->navMesh);
+        NavSolver_Prepare(&system->planner.solver, &system->navMesh);
+        NavBatch_Prepare(&system->batch, &system->navMesh);
+        
+        if (system->floodCosts)
+            stb_sb_free(system->floodCosts);
+        
+        system->floodCosts = NULL;
+        stb_sb_add(system->floodCosts, system->navMesh.polyCount);
+    }
     
     return 0;
 }
 
 int NavSystem_Raycast(const NavSystem* system, Ray3 ray, NavRaycastResult* hitInfo)
 {
-    if ((hitInfo->poly = NavMesh_Raycast(&system->navMesh, ray, &hitInfo->distance)))
+    NAV_PROFILE_LOG(system->profile, "raycast %.9g %.9g %.9g %.9g %.9g %.9g\n",
+                    ray.origin.x, ray.origin.y, ray.origin.z, ray.dir.x, ray.dir.y, ray.dir.z);
+    NAV_PROFILE_START(start);
+    
+    int polysTested;
+    hitInfo->poly = NavMesh_RaycastTested(&system->navMesh, ray, &hitInfo->distance, &polysTested);
+    
+    NAV_PROFILE_ADD(system->profile, kNavQueryRaycast, start, polysTested, 0);
+    
+    if (hitInfo->poly)
     {
         hitInfo->point = Ray3_Slide(ray, hitInfo->distance);
         return 1;
@@ -43,37 +220,210 @@ int NavSystem_Raycast(const NavSystem* system, Ray3 ray, NavRaycastResult* hitIn
     return 0;
 }
 
+int NavSystem_LocatePoint(const NavSystem* system,
+                          const NavPoly* hintPoly,
+                          Vec3 point,
+                          NavRaycastResult* hitInfo)
+{
+    NAV_PROFILE_LOG(system->profile, "locate %i %.9g %.9g %.9g\n",
+                    hintPoly ? hintPoly->index : -1, point.x, point.y, point.z);
+    
+    if ((hitInfo->poly = NavMesh_LocatePoint(&system->navMesh, hintPoly, point, &hitInfo->distance)))
+    {
+        hitInfo->point = Vec3_Offset(point, 0.0f, 0.0f, -hitInfo->distance);
+        return 1;
+    }
+    
+    return 0;
+}
+
+int NavSystem_Linecast(const NavSystem* system,
+                       const NavPoly* hintPoly,
+                       Vec3 start,
+                       Vec3 end,
+                       NavLineHit* hit)
+{
+    float t;
+    const NavPoly* poly = NavMesh_LocatePoint(&system->navMesh, hintPoly, start, &t);
+    
+    if (poly)
+        return NavMesh_LineWalk(&system->navMesh, poly, start, end, kNavEdgeFlagSolid, hit);
+    
+    // start is off the mesh, so walk back from the end instead
+    poly = NavMesh_LocatePoint(&system->navMesh, hintPoly, end, &t);
+    
+    if (poly && NavMesh_LineWalk(&system->navMesh, poly, end, start, kNavEdgeFlagSolid, hit))
+    {
+        hit->t = 1.0f - hit->t;
+        return 1;
+    }
+    
+    return 0;
+}
+
+/* a linecast, counted as a line query */
+static int NavSystem_LineSolid(const NavSystem* system,
+                               const NavPoly* hintPoly,
+                               Vec3 start,
+                               Vec3 end)
+{
+    NAV_PROFILE_START(lineStart);
+    
+    NavLineHit hit;
+    int result = NavSystem_Linecast(system, hintPoly, start, end, &hit);
+    
+    NAV_PROFILE_ADD(system->profile, kNavQueryLine, lineStart, hit.polysCrossed, 0);
+    return result;
+}
+
 int NavSystem_LineIntersectsSolid(const NavSystem* system,
-                             Vec3 start,
-                             Vec3 end,
-                             float height)
+                                  const NavPoly* hintPoly,
+                                  Vec3 start,
+                                  Vec3 end)
 {
-    Vec3 vec = Vec3_Sub(end, start);
+    NAV_PROFILE_LOG(system->profile, "line %i %.9g %.9g %.9g %.9g %.9g %.9g\n",
+                    hintPoly ? hintPoly->index : -1, start.x, start.y, start.z, end.x, end.y, end.z);
     
-    Ray3 r0 = Ray3_Create(start, Vec3_Norm(vec));
+    return NavSystem_LineSolid(system, hintPoly, start, end);
+}
+
+int NavSystem_PolyLineIntersectsSolid(const NavSystem* system,
+                                      const NavPoly* startPoly,
+                                      const NavPoly* endPoly,
+                                      Vec3 start,
+                                      Vec3 end)
+{
+    NAV_PROFILE_LOG(system->profile, "polyline %i %i %.9g %.9g %.9g %.9g %.9g %.9g\n",
+                    startPoly ? startPoly->index : -1, endPoly ? endPoly->index : -1,
+                    start.x, start.y, start.z, end.x, end.y, end.z);
     
-    Ray3 r1 = Ray3_Create(start, Vec3_Create(0.0f, 0.0f, -1.0f));
-    Ray3 r2 = Ray3_Create(end, Vec3_Create(0.0f, 0.0f, -1.0f));
+    // only clear pairs are certain, and only for lines high enough over both polys
+    if (startPoly && endPoly &&
+        start.z >= startPoly->bounds.max.z + NAV_VISIBILITY_HEIGHT &&
+        end.z >= endPoly->bounds.max.z + NAV_VISIBILITY_HEIGHT)
+    {
+        NAV_PROFILE_START(tableStart);
+        
+        if (NavVisibility_Get(&system->navMesh.visibility, startPoly->index, endPoly->index) == kNavVisibilityAll)
+        {
+            NAV_PROFILE_ADD(system->profile, kNavQueryLine, tableStart, 0, 0);
+            return 0;
+        }
+    }
     
-    // check if the line intersects with the ground 
-    float t;
-    if (NavMesh_Raycast(&system->navMesh, r0, &t))
+    return NavSystem_LineSolid(system, startPoly, start, end);
+}
+
+static void NavSystem_SmoothPath(const NavSystem* system, NavPath* path, float radius)
+{
+#ifdef NAV_PROFILE
+    uint64_t start = NavProfile_Now();
+    int portalCount = path->nodeCount;
+    
+    NavSolver_SmoothPath(&system->navMesh, path, radius);
+    NavProfile_Add(system->profile, kNavQuerySmooth, start, portalCount, 0);
+#else
+    NavSolver_SmoothPath(&system->navMesh, path, radius);
+#endif
+}
+
+/* a corridor crosses an obstacle if any poly between its ends is blocked */
+static int NavSystem_CorridorBlocked(const NavSystem* system, const NavPath* corridor)
+{
+    const NavObstacles* obstacles = &system->navMesh.obstacles;
+    
+    if (obstacles->blockedCount == 0 || corridor->nodeCount < 1)
+        return 0;
+    
+    int startPoly = corridor->nodes[0].polyIndex;
+    int endPoly = corridor->nodes[corridor->nodeCount - 1].polyIndex;
+    
+    for (int i = 0; i < corridor->nodeCount; ++i)
     {
-        if (t * t < Vec3_LengthSq(vec))
+        int polyIndex = corridor->nodes[i].polyIndex;
+        
+        if (polyIndex != startPoly && polyIndex != endPoly && NavObstacles_IsBlocked(obstacles, polyIndex))
             return 1;
     }
     
-    NavPoly* poly = NULL;
+    return 0;
+}
+
+/* a result found with no obstacles in the way is still the best while it stays clear,
+   one found around obstacles may not be once they move */
+static int NavSystem_ResultValid(const NavSystem* system,
+                                 unsigned int obstacleVersion,
+                                 int obstructed,
+                                 int result,
+                                 const NavPath* corridor)
+{
+    if (obstructed && obstacleVersion != system->navMesh.obstacles.version)
+        return 0;
+    
+    return !result || !NavSystem_CorridorBlocked(system, corridor);
+}
+
+/* fills outPath from the cache, returns NULL if the corridor has not been solved recently */
+static const NavPathCacheEntry* NavSystem_FindCached(NavSystem* system,
+                                                     Vec3 startPoint,
+                                                     Vec3 endPoint,
+                                                     const NavPoly* startPoly,
+                                                     const NavPoly* endPoly,
+                                                     NavPath* outPath)
+{
+    NavPathCache* cache = &system->pathCache;
+    NavPathCacheEntry* entry = NavPathCache_Find(cache, startPoly->index, endPoly->index);
+    
+    if (entry && (!NavSystem_ResultValid(system, entry->obstacleVersion, entry->obstructed, entry->result, &entry->corridor) ||
+                  (entry->result && !NavPath_Copy(&entry->corridor, outPath))))
+    {
+        // stale or out of memory, solved again into a new entry
+        entry->startPoly = -1;
+        entry->endPoly = -1;
+        entry = NULL;
+    }
+    
+    if (!entry)
+    {
+        ++cache->misses;
+        return NULL;
+    }
     
-    poly = NavMesh_Raycast(&system->navMesh, r1, &t);
+    ++cache->hits;
     
-    if (poly == NULL)
-        poly = NavMesh_Raycast(&system->navMesh, r2, &t);
+    if (entry->result)
+    {
+        // same corridor, new endpoints
+        outPath->nodes[0].point = startPoint;
+        outPath->nodes[outPath->nodeCount - 1].point = endPoint;
+    }
+    else
+    {
+        NavPath_Clear(outPath);
+    }
     
-    if (poly && NavMesh_LineEdgeCast(&system->navMesh, poly, Vec2_FromVec3(start), Vec2_FromVec3(end), kNavEdgeFlagSolid))
-        return 1;
+    return entry;
+}
+
+static void NavSystem_CacheResult(NavSystem* system,
+                                  const NavPoly* startPoly,
+                                  const NavPoly* endPoly,
+                                  unsigned int obstacleVersion,
+                                  int obstructed,
+                                  int result,
+                                  const NavPath* path)
+{
+    NavPathCacheEntry* entry = NavPathCache_Insert(&system->pathCache, startPoly->index, endPoly->index);
+    entry->result = result;
+    entry->obstacleVersion = obstacleVersion;
+    entry->obstructed = obstructed;
     
-    return 0;
+    // a corridor that could not be stored is not cached
+    if (result && !NavPath_Copy(path, &entry->corridor))
+    {
+        entry->startPoly = -1;
+        entry->endPoly = -1;
+    }
 }
 
 int NavSystem_FindPath(NavSystem* system,
@@ -82,19 +432,239 @@ int NavSystem_FindPath(NavSystem* system,
                        Vec3 endPoint,
                        const NavPoly* startPoly,
                        const NavPoly* endPoly,
+                       const NavQueryFilter* filter,
                        NavPath* outPath)
 {
-    int result = NavSolver_Solve(&system->solver,
-                                &system->navMesh,
-                                startPoint,
-                                endPoint,
-                                startPoly,
-                                endPoly,
-                                outPath);
+    NAV_PROFILE_LOG(system->profile, "%s %.9g %.9g %.9g %.9g %.9g %.9g %.9g %i %i\n", "path", radius,
+                    startPoint.x, startPoint.y, startPoint.z, endPoint.x, endPoint.y, endPoint.z,
+                    startPoly ? startPoly->index : -1, endPoly ? endPoly->index : -1);
+    
+    if (!startPoly || !endPoly)
+        return 0;
+    
+    const NavPathCacheEntry* entry = NULL;
+    int result;
+    
+    if (!filter)
+        entry = NavSystem_FindCached(system, startPoint, endPoint, startPoly, endPoly, outPath);
+    
+    if (entry)
+    {
+        result = entry->result;
+    }
+    else
+    {
+        NAV_PROFILE_START(start);
+        
+        result = NavSolver_Solve(&system->solver,
+                                 &system->navMesh,
+                                 startPoint,
+                                 endPoint,
+                                 startPoly,
+                                 endPoly,
+                                 filter,
+                                 outPath);
+        
+        NAV_PROFILE_ADD(system->profile, kNavQuerySolve, start, result ? outPath->nodeCount : 0, system->solver.expansions);
+        
+        if (!filter)
+        {
+            const NavObstacles* obstacles = &system->navMesh.obstacles;
+            NavSystem_CacheResult(system, startPoly, endPoly, obstacles->version, system->solver.blockedReached > 0, result, outPath);
+        }
+    }
     
     if (!result) return 0;
-    NavSolver_SmoothPath(&system->navMesh, outPath, radius);
+    NavSystem_SmoothPath(system, outPath, radius);
+    return 1;
+}
+
+int NavSystem_FindFlowPath(NavSystem* system,
+                           float radius,
+                           Vec3 startPoint,
+                           Vec3 endPoint,
+                           const NavPoly* startPoly,
+                           const NavPoly* endPoly,
+                           NavPath* outPath)
+{
+    NAV_PROFILE_LOG(system->profile, "%s %.9g %.9g %.9g %.9g %.9g %.9g %.9g %i %i\n", "flow", radius,
+                    startPoint.x, startPoint.y, startPoint.z, endPoint.x, endPoint.y, endPoint.z,
+                    startPoly ? startPoly->index : -1, endPoly ? endPoly->index : -1);
+    
+    if (!startPoly || !endPoly)
+        return 0;
+    
+    NavFlowCache* cache = &system->flowCache;
+    
+    int found;
+    NavFlowField* field = NavFlowCache_Find(cache, endPoly->index, &found);
+    
+    if (found)
+    {
+        ++cache->hits;
+    }
+    else
+    {
+        ++cache->builds;
+        
+        NAV_PROFILE_START(start);
+        int reached = NavFlowField_Build(field, &system->solver, &system->navMesh, endPoly, endPoint);
+        
+        NAV_PROFILE_ADD(system->profile, kNavQuerySolve, start, reached, system->solver.expansions);
+        
+        if (!reached)
+            return 0;
+    }
+    
+    if (!NavFlowField_Path(field, &system->navMesh, startPoint, endPoint, startPoly, outPath))
+        return 0;
+    
+    // an obstacle has moved onto the way since the field was built, solve around it instead
+    if (NavSystem_CorridorBlocked(system, outPath))
+    {
+        NAV_PROFILE_START(solveStart);
+        int result = NavSolver_Solve(&system->solver, &system->navMesh, startPoint, endPoint, startPoly, endPoly, NULL, outPath);
+        NAV_PROFILE_ADD(system->profile, kNavQuerySolve, solveStart, result ? outPath->nodeCount : 0, system->solver.expansions);
+        
+        if (!result)
+            return 0;
+    }
+    
+    NavSystem_SmoothPath(system, outPath, radius);
     return 1;
 }
 
+static NavSolveStatus NavSystem_FinishPlan(NavSystem* system)
+{
+    NavPlanner* planner = &system->planner;
+    NavPath* outPath = planner->outPath;
+    
+    int result = NavSolver_Result(&planner->solver, &system->navMesh, outPath);
+    
+    if (!planner->filtered)
+        NavSystem_CacheResult(system, planner->solver.startPoly, planner->solver.endPoly, planner->obstacleVersion, planner->solver.blockedReached > 0, result, outPath);
+    
+    if (result)
+        NavSystem_SmoothPath(system, outPath, planner->radius);
+    
+    planner->pathTicks = planner->ticks;
+    planner->pathExpansions = planner->solver.expansions;
+    planner->outPath = NULL;
+    
+    return result ? kNavSolveDone : kNavSolveFailed;
+}
+
+NavSolveStatus NavSystem_BeginPlan(NavSystem* system,
+                                   float radius,
+                                   Vec3 startPoint,
+                                   Vec3 endPoint,
+                                   const NavPoly* startPoly,
+                                   const NavPoly* endPoly,
+                                   const NavQueryFilter* filter,
+                                   NavPath* outPath)
+{
+    NAV_PROFILE_LOG(system->profile, "%s %.9g %.9g %.9g %.9g %.9g %.9g %.9g %i %i\n", "plan", radius,
+                    startPoint.x, startPoint.y, startPoint.z, endPoint.x, endPoint.y, endPoint.z,
+                    startPoly ? startPoly->index : -1, endPoly ? endPoly->index : -1);
+    
+    NavPlanner* planner = &system->planner;
+    planner->outPath = NULL;
+    
+    if (!startPoly || !endPoly)
+    {
+        NavPath_Clear(outPath);
+        return kNavSolveFailed;
+    }
+    
+    const NavPathCacheEntry* entry = NULL;
+    
+    if (!filter)
+        entry = NavSystem_FindCached(system, startPoint, endPoint, startPoly, endPoly, outPath);
+    
+    if (entry)
+    {
+        if (!entry->result)
+            return kNavSolveFailed;
+        
+        NavSystem_SmoothPath(system, outPath, radius);
+        return kNavSolveDone;
+    }
+    
+    planner->outPath = outPath;
+    planner->radius = radius;
+    planner->ticks = 0;
+    planner->filtered = filter != NULL;
+    planner->obstacleVersion = system->navMesh.obstacles.version;
+    
+    if (filter)
+        planner->filter = *filter;
+    
+    if (NavSolver_Begin(&planner->solver,
+                        &system->navMesh,
+                        startPoint,
+                        endPoint,
+                        startPoly,
+                        endPoly,
+                        filter ? &planner->filter : NULL) != kNavSolveRunning)
+    {
+        return NavSystem_FinishPlan(system);
+    }
+    
+    return kNavSolveRunning;
+}
+
+NavSolveStatus NavSystem_StepPlan(NavSystem* system, int maxExpansions)
+{
+    NavPlanner* planner = &system->planner;
+    
+    if (!planner->outPath)
+        return kNavSolveFailed;
+    
+    NAV_PROFILE_LOG(system->profile, "step %i\n", maxExpansions);
+    NAV_PROFILE_START(start);
+    
+    int expansions = planner->solver.expansions;
+    NavSolveStatus status = NavSolver_Step(&planner->solver, &system->navMesh, maxExpansions);
+    
+    NAV_PROFILE_ADD(system->profile, kNavQuerySolve, start, 0, planner->solver.expansions - expansions);
+    
+    ++planner->ticks;
+    planner->tickExpansions = planner->solver.expansions - expansions;
+    planner->maxTickExpansions = MAX(planner->maxTickExpansions, planner->tickExpansions);
+    
+    if (status == kNavSolveRunning)
+        return status;
+    
+    return NavSystem_FinishPlan(system);
+}
+
+void NavSystem_CancelPlan(NavSystem* system, const NavPath* outPath)
+{
+    if (system->planner.outPath == outPath)
+    {
+        NAV_PROFILE_LOG(system->profile, "cancel\n");
+        system->planner.outPath = NULL;
+    }
+}
+
+const float* NavSystem_Flood(NavSystem* system,
+                             const NavPoly* startPoly,
+                             Vec3 startPoint,
+                             float maxCost,
+                             const NavQueryFilter* filter)
+{
+    NAV_PROFILE_LOG(system->profile, "flood %i %.9g %.9g %.9g %.9g\n",
+                    startPoly ? startPoly->index : -1, startPoint.x, startPoint.y, startPoint.z, maxCost);
+    
+    NavSolver_Flood(&system->solver, &system->navMesh, startPoly, startPoint, maxCost, filter, system->floodCosts);
+    return system->floodCosts;
+}
+
+void NavSystem_FindPaths(NavSystem* system,
+                         NavPathRequest* requests,
+                         int requestCount)
+{
+    NavBatch_Solve(&system->batch, &system->navMesh, requests, requestCount);
+}
+
 
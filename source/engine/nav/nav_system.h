@@ -3,6 +3,10 @@
 #define NAV_SYSTEM_H
 
 #include "nav.h"
+#include "nav_batch.h"
+#include "nav_flow.h"
+#include "nav_avoid.h"
+#include "nav_profile.h"
 
 typedef struct
 {
@@ -11,10 +15,115 @@ typedef struct
     float distance;
 } NavRaycastResult;
 
+#define NAV_PATH_CACHE_SIZE 32
+
+/*
+ Recently solved paths, before smoothing, keyed by start and end poly.
+ The mesh does not change during a level, so the corridor is reused
+ for any endpoints on the same polys and only smoothed again.
+ Obstacles do change, so a corridor is only reused while it crosses none of them,
+ and one solved around obstacles only until they move.
+ */
+
+typedef struct
+{
+    // -1 if the entry is empty
+    int startPoly;
+    int endPoly;
+    
+    int result;
+    unsigned int lastUsed;
+    NavPath corridor;
+    
+    // the mesh obstacles when it was solved, and whether the search ran into any of them
+    unsigned int obstacleVersion;
+    int obstructed;
+} NavPathCacheEntry;
+
+typedef struct
+{
+    NavPathCacheEntry entries[NAV_PATH_CACHE_SIZE];
+    unsigned int clock;
+    
+    int hits;
+    int misses;
+} NavPathCache;
+
+#define NAV_FLOW_FIELD_COUNT 4
+
+/*
+ Flow fields toward the goal polys most recently asked for.
+ Units converging on the same target share one field,
+ the least recently used is rebuilt for a new goal.
+ */
+
+typedef struct
+{
+    NavFlowField fields[NAV_FLOW_FIELD_COUNT];
+    unsigned int clock;
+    
+    int builds;
+    int hits;
+} NavFlowCache;
+
+// ticks ahead units steer to avoid each other, see NavAvoidance
+#define NAV_AVOID_TIME_HORIZON 20.0f
+
+// nodes a planned path may close each tick, see NavSystem_StepPlan
+#define NAV_PLAN_EXPANSIONS_PER_TICK 256
+
+/*
+ A single path solved a little at a time, so long paths don't stall a tick.
+ It has its own solver, so floods and other queries can run while it waits.
+ */
+
+typedef struct
+{
+    NavSolver solver;
+    
+    // NULL when nothing is being planned
+    NavPath* outPath;
+    float radius;
+    int ticks;
+    
+    // a copy of the filter the path was started with, if it had one
+    NavQueryFilter filter;
+    int filtered;
+    
+    // nodes closed by the last step
+    int tickExpansions;
+    // the most nodes closed by any step
+    int maxTickExpansions;
+    
+    // the mesh obstacles when the path was started
+    unsigned int obstacleVersion;
+    
+    // how many steps and nodes the last finished path took
+    int pathTicks;
+    int pathExpansions;
+} NavPlanner;
+
 typedef struct
 {
     NavMesh navMesh;
     NavSolver solver;
+    NavBatch batch;
+    NavPlanner planner;
+    
+    // per poly costs from the last NavSystem_Flood
+    float* floodCosts;
+    
+    // used by NavSystem_FindPath, cleared when a mesh is loaded
+    NavPathCache pathCache;
+    
+    // used by NavSystem_FindFlowPath, cleared when a mesh is loaded
+    NavFlowCache flowCache;
+    
+    // steering between moving units, filled and solved by the engine each tick
+    NavAvoidance avoidance;
+    
+    // query counters and timers, NULL unless built with NAV_PROFILE
+    NavProfile* profile;
 } NavSystem;
 
 extern void NavSystem_Init(NavSystem* system);
@@ -22,21 +131,95 @@ extern void NavSystem_Shutdown(NavSystem* system);
 
 extern int NavSystem_LoadMesh(NavSystem* system, const char* path);
 
+/* call once per engine tick, finishes the tick for the profile */
+extern void NavSystem_EndTick(NavSystem* system);
+
 extern int NavSystem_Raycast(const NavSystem* system, Ray3 ray, NavRaycastResult* hitInfo);
 
+/* same as a raycast straight down from point.
+   hintPoly is a guess, such as the poly an object was on last tick. */
+extern int NavSystem_LocatePoint(const NavSystem* system,
+                                 const NavPoly* hintPoly,
+                                 Vec3 point,
+                                 NavRaycastResult* hitInfo);
+
+/* walks the line across the mesh, stopping at solid edges and the ground.
+   hintPoly is a guess for the poly under start, see NavMesh_LineWalk. */
+extern int NavSystem_Linecast(const NavSystem* system,
+                              const NavPoly* hintPoly,
+                              Vec3 start,
+                              Vec3 end,
+                              NavLineHit* hit);
+
 extern int NavSystem_LineIntersectsSolid(const NavSystem* system,
+                                         const NavPoly* hintPoly,
                                          Vec3 start,
-                                         Vec3 end,
-                                         float height);
+                                         Vec3 end);
 
+/* the same test between points over two known polys.
+   Pairs the mesh visibility table has as clear are answered from it when both points are
+   NAV_VISIBILITY_HEIGHT above the tops of their polys, everything else walks the line. */
+extern int NavSystem_PolyLineIntersectsSolid(const NavSystem* system,
+                                             const NavPoly* startPoly,
+                                             const NavPoly* endPoly,
+                                             Vec3 start,
+                                             Vec3 end);
+
+/* filter may be NULL for the default (see NavQueryFilter),
+   only paths with the default filter are cached */
 extern int NavSystem_FindPath(NavSystem* system,
                               float radius,
                               Vec3 startPoint,
                               Vec3 endPoint,
                               const NavPoly* startPoly,
                               const NavPoly* endPoly,
+                              const NavQueryFilter* filter,
                               NavPath* outPath);
 
+/* the same path as NavSystem_FindPath, read from a flow field toward endPoly.
+   The first path to a goal floods the whole mesh, every path after to the same poly only follows the field.
+   Paths may differ slightly from a solved path, the field is not guided toward the start,
+   and always uses the default filter. */
+extern int NavSystem_FindFlowPath(NavSystem* system,
+                                  float radius,
+                                  Vec3 startPoint,
+                                  Vec3 endPoint,
+                                  const NavPoly* startPoly,
+                                  const NavPoly* endPoly,
+                                  NavPath* outPath);
+
+/* starts planning a path into outPath, replacing any path already being planned.
+   Returns kNavSolveDone if it was found right away, such as from the path cache,
+   otherwise call NavSystem_StepPlan until it finishes. The filter is copied. */
+extern NavSolveStatus NavSystem_BeginPlan(NavSystem* system,
+                                          float radius,
+                                          Vec3 startPoint,
+                                          Vec3 endPoint,
+                                          const NavPoly* startPoly,
+                                          const NavPoly* endPoly,
+                                          const NavQueryFilter* filter,
+                                          NavPath* outPath);
+
+/* once finished the path is smoothed, the same as NavSystem_FindPath */
+extern NavSolveStatus NavSystem_StepPlan(NavSystem* system, int maxExpansions);
+
+/* stops planning if outPath is the path being planned */
+extern void NavSystem_CancelPlan(NavSystem* system, const NavPath* outPath);
+
+/* path costs to every poly within maxCost of startPoint, see NavSolver_Flood.
+   The result is shared, and valid until the next flood or mesh load. */
+extern const float* NavSystem_Flood(NavSystem* system,
+                                    const NavPoly* startPoly,
+                                    Vec3 startPoint,
+                                    float maxCost,
+                                    const NavQueryFilter* filter);
+
+/* solves many requests in parallel, each the same as a NavSystem_FindPath
+   to the poly found below its end point */
+extern void NavSystem_FindPaths(NavSystem* system,
+                                NavPathRequest* requests,
+                                int requestCount);
+
 // finds a point close to searchPoint on the nav mesh
 extern Vec3 NavSystem_FindClosePoint(const NavMesh* mesh,
                                      const NavPoly* poly,
@@ -0,0 +1,507 @@
+
+#include "nav_mesh.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+// center and up to this many corners of each poly
+#define NAV_VISIBILITY_CORNERS_MAX 8
+
+// pairs with more corners than this between them are never proven clear
+#define NAV_VISIBILITY_HULL_MAX (NAV_VISIBILITY_CORNERS_MAX * 2)
+
+// edges this close to the hull of a pair count as inside it
+#define NAV_VISIBILITY_SLACK 0.01f
+
+// 'NVI2' little endian, tables from before clear pairs were proven read as missing
+#define NAV_VISIBILITY_TAG 0x3249564e
+
+void NavVisibility_Shutdown(NavVisibility* visibility)
+{
+    free(visibility->polyOrder);
+    free(visibility->rowFirst);
+    free(visibility->rowOffset);
+    free(visibility->data);
+    
+    memset(visibility, 0, sizeof(NavVisibility));
+}
+
+typedef struct
+{
+    uint32_t code;
+    int polyIndex;
+} NavCurvePoly;
+
+static int NavCurvePoly_Compare(const void* a, const void* b)
+{
+    const NavCurvePoly* polyA = a;
+    const NavCurvePoly* polyB = b;
+    
+    if (polyA->code != polyB->code)
+        return polyA->code < polyB->code ? -1 : 1;
+    
+    return polyA->polyIndex - polyB->polyIndex;
+}
+
+/* spreads the low 16 bits of x out to the even bits */
+static uint32_t NavVisibility_Spread(uint32_t x)
+{
+    x &= 0xFFFF;
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+static int NavVisibility_SortPolys(NavVisibility* visibility, const NavMesh* mesh)
+{
+    Vec2 min = Vec2_Create(INFINITY, INFINITY);
+    Vec2 max = Vec2_Create(-INFINITY, -INFINITY);
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        Vec3 center = mesh->polys[i].plane.point;
+        min.x = MIN(min.x, center.x);
+        min.y = MIN(min.y, center.y);
+        max.x = MAX(max.x, center.x);
+        max.y = MAX(max.y, center.y);
+    }
+    
+    float scale = 65535.0f / MAX(MAX(max.x - min.x, max.y - min.y), V_EPSILON);
+    
+    NavCurvePoly* sorted = malloc(sizeof(NavCurvePoly) * mesh->polyCount);
+    visibility->polyOrder = malloc(sizeof(int) * mesh->polyCount);
+    
+    if (!sorted || !visibility->polyOrder)
+    {
+        free(sorted);
+        return 0;
+    }
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        Vec3 center = mesh->polys[i].plane.point;
+        uint32_t x = (uint32_t)((center.x - min.x) * scale);
+        uint32_t y = (uint32_t)((center.y - min.y) * scale);
+        
+        sorted[i].code = NavVisibility_Spread(x) | (NavVisibility_Spread(y) << 1);
+        sorted[i].polyIndex = i;
+    }
+    
+    qsort(sorted, mesh->polyCount, sizeof(NavCurvePoly), NavCurvePoly_Compare);
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+        visibility->polyOrder[sorted[i].polyIndex] = i;
+    
+    free(sorted);
+    return 1;
+}
+
+/* the center, and each corner pulled in a little so lines do not graze the edges */
+static int NavVisibility_Samples(const NavMesh* mesh, const NavPoly* poly, Vec3* samples)
+{
+    Vec3 up = Vec3_Create(0.0f, 0.0f, NAV_VISIBILITY_HEIGHT);
+    Vec3 center = poly->plane.point;
+    
+    int count = 0;
+    samples[count++] = Vec3_Add(center, up);
+    
+    for (int i = 0; i < MIN(poly->edgeCount, NAV_VISIBILITY_CORNERS_MAX); ++i)
+    {
+        Vec3 corner = mesh->vertices[mesh->edges[poly->edgeStart + i].vertices[0]];
+        samples[count++] = Vec3_Add(Vec3_Lerp(corner, center, 0.1f), up);
+    }
+    
+    return count;
+}
+
+typedef struct
+{
+    // queue of polys reached by a cover test, and a flag per poly for whether it is in it
+    int* polys;
+    char* reached;
+} NavVisibilityScratch;
+
+static int NavVisibility_ComparePoints(const void* a, const void* b)
+{
+    const Vec2* pointA = a;
+    const Vec2* pointB = b;
+    
+    if (pointA->x != pointB->x)
+        return pointA->x < pointB->x ? -1 : 1;
+    
+    if (pointA->y != pointB->y)
+        return pointA->y < pointB->y ? -1 : 1;
+    
+    return 0;
+}
+
+static float NavVisibility_Turn(Vec2 o, Vec2 a, Vec2 b)
+{
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+/* 2D hull around the corners of both polys (monotone chain), hull needs room for twice the corners */
+static int NavVisibility_Hull(const NavMesh* mesh, const NavPoly* polyA, const NavPoly* polyB, Vec2* hull)
+{
+    Vec2 points[NAV_VISIBILITY_HULL_MAX];
+    int pointCount = 0;
+    
+    const NavPoly* polys[2] = {polyA, polyB};
+    
+    for (int p = 0; p < 2; ++p)
+    {
+        for (int i = 0; i < polys[p]->edgeCount; ++i)
+            points[pointCount++] = Vec2_FromVec3(mesh->vertices[mesh->edges[polys[p]->edgeStart + i].vertices[0]]);
+    }
+    
+    qsort(points, pointCount, sizeof(Vec2), NavVisibility_ComparePoints);
+    
+    int count = 0;
+    
+    for (int i = 0; i < pointCount; ++i)
+    {
+        while (count >= 2 && NavVisibility_Turn(hull[count - 2], hull[count - 1], points[i]) <= 0.0f)
+            --count;
+        
+        hull[count++] = points[i];
+    }
+    
+    int lower = count + 1;
+    
+    for (int i = pointCount - 2; i >= 0; --i)
+    {
+        while (count >= lower && NavVisibility_Turn(hull[count - 2], hull[count - 1], points[i]) <= 0.0f)
+            --count;
+        
+        hull[count++] = points[i];
+    }
+    
+    // the last point closes the loop
+    return MAX(count - 1, 1);
+}
+
+/* whether segment ab comes within NAV_VISIBILITY_SLACK of the hull, by separating axes */
+static int NavVisibility_Touches(const Vec2* hull, int hullCount, Vec2 a, Vec2 b)
+{
+    // the hull edges, then the segment itself
+    for (int i = 0; i <= hullCount; ++i)
+    {
+        Vec2 from = (i < hullCount) ? hull[i] : a;
+        Vec2 to = (i < hullCount) ? hull[(i + 1) % hullCount] : b;
+        
+        Vec2 axis = Vec2_Create(to.y - from.y, from.x - to.x);
+        float length = Vec2_Length(axis);
+        
+        if (length < V_EPSILON)
+            continue;
+        
+        axis = Vec2_Scale(axis, 1.0f / length);
+        
+        float hullMin = INFINITY;
+        float hullMax = -INFINITY;
+        
+        for (int j = 0; j < hullCount; ++j)
+        {
+            float d = Vec2_Dot(hull[j], axis);
+            hullMin = MIN(hullMin, d);
+            hullMax = MAX(hullMax, d);
+        }
+        
+        float da = Vec2_Dot(a, axis);
+        float db = Vec2_Dot(b, axis);
+        
+        if (MIN(da, db) > hullMax + NAV_VISIBILITY_SLACK || MAX(da, db) < hullMin - NAV_VISIBILITY_SLACK)
+            return 0;
+    }
+    
+    return 1;
+}
+
+/* whether every line between points NAV_VISIBILITY_HEIGHT over the tops of the two polys is clear.
+   Such a line stays inside the hull of both polys, so it is enough that the polys reached from polyA
+   through edges inside the hull have no solid or open edges in it, and are not higher than the line. */
+static int NavVisibility_Covered(const NavMesh* mesh, const NavPoly* polyA, const NavPoly* polyB, NavVisibilityScratch* scratch)
+{
+    if (polyA->edgeCount + polyB->edgeCount > NAV_VISIBILITY_HULL_MAX)
+        return 0;
+    
+    Vec2 hull[NAV_VISIBILITY_HULL_MAX * 2];
+    int hullCount = NavVisibility_Hull(mesh, polyA, polyB, hull);
+    
+    float ceiling = MIN(polyA->bounds.max.z, polyB->bounds.max.z) + NAV_VISIBILITY_HEIGHT;
+    
+    int count = 0;
+    int covered = 1;
+    
+    scratch->polys[count++] = polyA->index;
+    scratch->reached[polyA->index] = 1;
+    
+    for (int next = 0; covered && next < count; ++next)
+    {
+        const NavPoly* poly = mesh->polys + scratch->polys[next];
+        
+        if (poly->bounds.max.z > ceiling)
+        {
+            covered = 0;
+            break;
+        }
+        
+        for (int i = 0; i < poly->edgeCount; ++i)
+        {
+            const NavEdge* edge = mesh->edges + poly->edgeStart + i;
+            Vec2 a = Vec2_FromVec3(mesh->vertices[edge->vertices[0]]);
+            Vec2 b = Vec2_FromVec3(mesh->vertices[edge->vertices[1]]);
+            
+            if (!NavVisibility_Touches(hull, hullCount, a, b))
+                continue;
+            
+            if ((edge->flags & kNavEdgeFlagSolid) || edge->neighborIndex == -1)
+            {
+                covered = 0;
+                break;
+            }
+            
+            if (!scratch->reached[edge->neighborIndex])
+            {
+                scratch->reached[edge->neighborIndex] = 1;
+                scratch->polys[count++] = edge->neighborIndex;
+            }
+        }
+    }
+    
+    for (int i = 0; i < count; ++i)
+        scratch->reached[scratch->polys[i]] = 0;
+    
+    return covered;
+}
+
+static NavVisibilityState NavVisibility_Test(const NavMesh* mesh, const NavPoly* polyA, const NavPoly* polyB, NavVisibilityScratch* scratch)
+{
+    Vec3 samplesA[NAV_VISIBILITY_CORNERS_MAX + 1];
+    Vec3 samplesB[NAV_VISIBILITY_CORNERS_MAX + 1];
+    
+    int countA = NavVisibility_Samples(mesh, polyA, samplesA);
+    int countB = NavVisibility_Samples(mesh, polyB, samplesB);
+    
+    int clear = 0;
+    int blocked = 0;
+    
+    for (int i = 0; i < countA; ++i)
+    {
+        for (int j = 0; j < countB; ++j)
+        {
+            NavLineHit hit;
+            
+            if (NavMesh_LineWalk(mesh, polyA, samplesA[i], samplesB[j], kNavEdgeFlagSolid, &hit))
+                ++blocked;
+            else
+                ++clear;
+            
+            // some lines are clear and some are not
+            if (clear && blocked)
+                return kNavVisibilityUnknown;
+        }
+    }
+    
+    if (!clear)
+        return kNavVisibilityNone;
+    
+    // the samples only suggest it, clear is stored when it holds for any line
+    return NavVisibility_Covered(mesh, polyA, polyB, scratch) ? kNavVisibilityAll : kNavVisibilityUnknown;
+}
+
+static void NavVisibility_Set(NavVisibility* visibility, int row, int column, NavVisibilityState state)
+{
+    column -= visibility->rowFirst[row];
+    
+    int byte = visibility->rowOffset[row] + (column >> 2);
+    assert(column >= 0 && byte < visibility->rowOffset[row + 1]);
+    
+    visibility->data[byte] |= state << ((column & 3) * 2);
+}
+
+int NavMesh_BuildVisibility(NavMesh* mesh, float range)
+{
+    NavVisibility* visibility = &mesh->visibility;
+    NavVisibility_Shutdown(visibility);
+    
+    if (mesh->polyCount < 1)
+        return 1;
+    
+    int* rowLast = malloc(sizeof(int) * mesh->polyCount);
+    visibility->rowFirst = malloc(sizeof(int) * mesh->polyCount);
+    visibility->rowOffset = malloc(sizeof(int) * (mesh->polyCount + 1));
+    
+    if (!rowLast || !visibility->rowFirst || !visibility->rowOffset ||
+        !NavVisibility_SortPolys(visibility, mesh))
+    {
+        free(rowLast);
+        NavVisibility_Shutdown(visibility);
+        return 0;
+    }
+    
+    visibility->polyCount = mesh->polyCount;
+    visibility->range = range;
+    
+    // find the band of columns in range of each row
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        int row = visibility->polyOrder[i];
+        visibility->rowFirst[row] = row;
+        rowLast[row] = row;
+    }
+    
+    for (int a = 0; a < mesh->polyCount; ++a)
+    {
+        Vec3 centerA = mesh->polys[a].plane.point;
+        int rowA = visibility->polyOrder[a];
+        
+        for (int b = a + 1; b < mesh->polyCount; ++b)
+        {
+            if (Vec3_DistSq(centerA, mesh->polys[b].plane.point) > range * range)
+                continue;
+            
+            int rowB = visibility->polyOrder[b];
+            
+            visibility->rowFirst[rowA] = MIN(visibility->rowFirst[rowA], rowB);
+            rowLast[rowA] = MAX(rowLast[rowA], rowB);
+            visibility->rowFirst[rowB] = MIN(visibility->rowFirst[rowB], rowA);
+            rowLast[rowB] = MAX(rowLast[rowB], rowA);
+        }
+    }
+    
+    int size = 0;
+    
+    for (int i = 0; i < mesh->polyCount; ++i)
+    {
+        visibility->rowOffset[i] = size;
+        size += (rowLast[i] - visibility->rowFirst[i] + 4) / 4;
+    }
+    
+    visibility->rowOffset[mesh->polyCount] = size;
+    free(rowLast);
+    
+    visibility->data = calloc(size, 1);
+    
+    NavVisibilityScratch scratch;
+    scratch.polys = malloc(sizeof(int) * mesh->polyCount);
+    scratch.reached = calloc(mesh->polyCount, 1);
+    
+    if (!visibility->data || !scratch.polys || !scratch.reached)
+    {
+        free(scratch.polys);
+        free(scratch.reached);
+        NavVisibility_Shutdown(visibility);
+        return 0;
+    }
+    
+    for (int a = 0; a < mesh->polyCount; ++a)
+    {
+        const NavPoly* polyA = mesh->polys + a;
+        int rowA = visibility->polyOrder[a];
+        
+        // a poly is convex, so it can always see itself
+        NavVisibility_Set(visibility, rowA, rowA, kNavVisibilityAll);
+        
+        for (int b = a + 1; b < mesh->polyCount; ++b)
+        {
+            const NavPoly* polyB = mesh->polys + b;
+            
+            if (Vec3_DistSq(polyA->plane.point, polyB->plane.point) > range * range)
+                continue;
+            
+            NavVisibilityState state = NavVisibility_Test(mesh, polyA, polyB, &scratch);
+            int rowB = visibility->polyOrder[b];
+            
+            NavVisibility_Set(visibility, rowA, rowB, state);
+            NavVisibility_Set(visibility, rowB, rowA, state);
+        }
+    }
+    
+    free(scratch.polys);
+    free(scratch.reached);
+    return 1;
+}
+
+typedef struct
+{
+    int32_t tag;
+    int32_t polyCount;
+    float range;
+    int32_t dataSize;
+} NavVisibilityHeader;
+
+int NavVisibility_Read(NavVisibility* visibility, int polyCount, FILE* file)
+{
+    NavVisibility_Shutdown(visibility);
+    
+    NavVisibilityHeader header;
+    
+    if (fread(&header, sizeof(header), 1, file) != 1)
+        return 0;
+    
+    if (header.tag != NAV_VISIBILITY_TAG ||
+        header.polyCount != polyCount ||
+        header.dataSize < 0)
+    {
+        return 0;
+    }
+    
+    visibility->polyOrder = malloc(sizeof(int) * polyCount);
+    visibility->rowFirst = malloc(sizeof(int) * polyCount);
+    visibility->rowOffset = malloc(sizeof(int) * (polyCount + 1));
+    visibility->data = malloc(MAX(header.dataSize, 1));
+    
+    if (!visibility->polyOrder || !visibility->rowFirst || !visibility->rowOffset || !visibility->data ||
+        fread(visibility->polyOrder, sizeof(int), polyCount, file) != (size_t)polyCount ||
+        fread(visibility->rowFirst, sizeof(int), polyCount, file) != (size_t)polyCount ||
+        fread(visibility->rowOffset, sizeof(int), polyCount + 1, file) != (size_t)polyCount + 1 ||
+        fread(visibility->data, 1, header.dataSize, file) != (size_t)header.dataSize)
+    {
+        NavVisibility_Shutdown(visibility);
+        return 0;
+    }
+    
+    // a bad row would read outside of the data
+    for (int i = 0; i < polyCount; ++i)
+    {
+        if (visibility->polyOrder[i] < 0 || visibility->polyOrder[i] >= polyCount ||
+            visibility->rowOffset[i] < 0 || visibility->rowOffset[i] > visibility->rowOffset[i + 1])
+        {
+            NavVisibility_Shutdown(visibility);
+            return 0;
+        }
+    }
+    
+    if (visibility->rowOffset[polyCount] != header.dataSize)
+    {
+        NavVisibility_Shutdown(visibility);
+        return 0;
+    }
+    
+    visibility->polyCount = polyCount;
+    visibility->range = header.range;
+    return 1;
+}
+
+int NavVisibility_Write(const NavVisibility* visibility, FILE* file)
+{
+    if (visibility->polyCount < 1)
+        return 0;
+    
+    int polyCount = visibility->polyCount;
+    
+    NavVisibilityHeader header;
+    header.tag = NAV_VISIBILITY_TAG;
+    header.polyCount = polyCount;
+    header.range = visibility->range;
+    header.dataSize = visibility->rowOffset[polyCount];
+    
+    return fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(visibility->polyOrder, sizeof(int), polyCount, file) == (size_t)polyCount &&
+        fwrite(visibility->rowFirst, sizeof(int), polyCount, file) == (size_t)polyCount &&
+        fwrite(visibility->rowOffset, sizeof(int), polyCount + 1, file) == (size_t)polyCount + 1 &&
+        fwrite(visibility->data, 1, header.dataSize, file) == (size_t)header.dataSize;
+}
@@ -0,0 +1,69 @@
+
+#ifndef NAV_VISIBILITY_H
+#define NAV_VISIBILITY_H
+
+#include <stdio.h>
+
+// poly pairs with centers further apart than this are not stored
+#define NAV_VISIBILITY_RANGE 64.0f
+
+// clear pairs hold for lines at least this high above the tops of both polys, below the middle of a unit
+#define NAV_VISIBILITY_HEIGHT 1.0f
+
+/*
+ A precomputed table of line of sight between pairs of nearby polys.
+ A pair is clear when every line between points NAV_VISIBILITY_HEIGHT over the polys
+ is proven to stay on the mesh, away from solid edges and above the ground.
+ Lines are also sampled between the center and corners of each poly,
+ and a pair where all of them were blocked is marked as none. That is only a hint,
+ lines between other points may get through, so it still needs a real line walk like unknown pairs.
+ 
+ Polys are sorted along a z-order curve, so the polys near each other
+ are also near in the table, and each row only stores the band of columns
+ in range of its poly, with 2 bits per pair.
+ */
+
+typedef enum
+{
+    kNavVisibilityUnknown = 0,
+    kNavVisibilityNone = 1,
+    kNavVisibilityAll = 2,
+} NavVisibilityState;
+
+typedef struct
+{
+    int polyCount;
+    float range;
+    
+    // the row and column of each poly
+    int* polyOrder;
+    
+    // row i starts at column rowFirst[i], its bytes are data[rowOffset[i]] through data[rowOffset[i + 1] - 1]
+    int* rowFirst;
+    int* rowOffset;
+    unsigned char* data;
+} NavVisibility;
+
+extern void NavVisibility_Shutdown(NavVisibility* visibility);
+
+static inline NavVisibilityState NavVisibility_Get(const NavVisibility* visibility, int polyA, int polyB)
+{
+    if (visibility->polyCount < 1)
+        return kNavVisibilityUnknown;
+    
+    int row = visibility->polyOrder[polyA];
+    int column = visibility->polyOrder[polyB] - visibility->rowFirst[row];
+    int byte = visibility->rowOffset[row] + (column >> 2);
+    
+    if (column < 0 || byte >= visibility->rowOffset[row + 1])
+        return kNavVisibilityUnknown;
+    
+    return (visibility->data[byte] >> ((column & 3) * 2)) & 3;
+}
+
+/* the table is stored at the end of a .bnav file,
+   read returns 0 if the file has none, or it does not match polyCount */
+extern int NavVisibility_Read(NavVisibility* visibility, int polyCount, FILE* file);
+extern int NavVisibility_Write(const NavVisibility* visibility, FILE* file);
+
+#endif
@@ -43,6 +43,7 @@ int RenderSystem_Init(RenderSystem* system,
         system->scaleFactor = 1.0f;
                 
         system->renderer = renderer;
+        memset(&system->renderList, 0, sizeof(RenderList));
         
         system->renderer->prepareGuiBuffer(renderer, &engine->guiSystem.buffer);
         system->renderer->prepareHintBuffer(renderer, &engine->renderSystem.hintBuffer);
@@ -55,6 +56,13 @@ int RenderSystem_Init(RenderSystem* system,
 
 void RenderSystem_Shutdown(RenderSystem* system, struct Engine* engine)
 {
+    RenderList* list = &system->renderList;
+    free(list->units);
+    free(list->unitLights);
+    free(list->props);
+    free(list->propLights);
+    memset(list, 0, sizeof(RenderList));
+    
     system->renderer->shutdown(system->renderer);
 
     system->renderer->cleanupGuiBuffer(system->renderer, &engine->guiSystem.buffer);
@@ -96,6 +104,8 @@ int RenderSystem_LoadStaticModel(RenderSystem* system, int modelIndex, const cha
 
     if (path == NULL)
     {
+        // props share the mesh, clear them first
+        assert(model->refCount == 0);
         system->renderer->cleanupMesh(system->renderer, &model->mesh);
         StaticModel_Shutdown(model);
         return 0;
@@ -143,6 +153,8 @@ int RenderSystem_LoadSkelModel(RenderSystem* system, int modelIndex, const char*
     
     if (path == NULL)
     {
+        // units share the skeleton and skin, clear them first
+        assert(model->refCount == 0);
         system->renderer->cleanupSkelSkin(system->renderer, &model->skin);
         SkelModel_Shutdown(model);
         return 0;
@@ -167,28 +179,46 @@ int RenderSystem_LoadSkelModel(RenderSystem* system, int modelIndex, const char*
     }
 }
 
+static void RenderList_Reserve(RenderList* list, int unitCapacity, int propCapacity)
+{
+    if (unitCapacity > list->unitCapacity)
+    {
+        list->units = realloc(list->units, sizeof(int) * unitCapacity);
+        list->unitLights = realloc(list->unitLights, sizeof(LightEntry) * unitCapacity);
+        list->unitCapacity = unitCapacity;
+    }
+    
+    if (propCapacity > list->propCapacity)
+    {
+        list->props = realloc(list->props, sizeof(int) * propCapacity);
+        list->propLights = realloc(list->propLights, sizeof(LightEntry) * propCapacity);
+        list->propCapacity = propCapacity;
+    }
+}
+
 static void RenderSystem_PrepareObservers(Renderer* renderer,
                                           const Frustum* cam,
                                           const FogView* vis,
                                           const Engine* engine,
                                           RenderList* renderList)
 {
+    const SceneHot* hot = &engine->sceneSystem.hot;
     short observerCount = 0;
     
     
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+    for (int i = 0; i < hot->liveUnitCount; ++i)
     {
-        const Unit* unit = engine->sceneSystem.units + i;
-        
-        if (!unit->dead && unit->playerId == ENGINE_PLAYER_LOCAL)
+        if (hot->unitPlayerIds[i] == ENGINE_PLAYER_LOCAL)
         {
+            int viewRadius = hot->unitViewRadii[i];
+            
             /* visbility data for shader */
-            Sphere sphere = Sphere_Create(unit->position, unit->viewRadius);
+            Sphere sphere = Sphere_Create(hot->unitPositions[i], viewRadius);
             
             if (Sphere_IntersectsPoint(sphere, cam->position) || Frustum_SphereVisible(cam, sphere))
             {
-                renderList->observerList.points[observerCount] = unit->position;
-                renderList->observerList.radiiSq[observerCount] = unit->viewRadius * unit->viewRadius;
+                renderList->observerList.points[observerCount] = hot->unitPositions[i];
+                renderList->observerList.radiiSq[observerCount] = viewRadius * viewRadius;
                 
                 ++observerCount;
                 
@@ -223,17 +253,19 @@ static void RenderSystem_Cull(Renderer* renderer,
     
     renderList->chunkCount = counter;
     
+    const SceneHot* hot = &engine->sceneSystem.hot;
+    
     /* Props */
     counter = 0;
-    for (int i = 0; i < SCENE_SYSTEM_PROPS_MAX; ++i)
+    for (int k = 0; k < hot->livePropCount; ++k)
     {
-        const Prop* prop = engine->sceneSystem.props + i;
+        int i = hot->liveProps[k];
         
-        if (prop->dead) continue;
-        if (!prop->model.loaded  || !prop->visible) continue;
+        if (hot->propFlags[k] & kSceneHotHidden) continue;
         if (playerView->propVisibility[i] < 0.22f) continue;
-        if (!Frustum_AabbVisible(cam, prop->bounds)) continue;
+        if (!Frustum_AabbVisible(cam, hot->propBounds[k])) continue;
         
+        const Prop* prop = engine->sceneSystem.props + i;
         renderList->props[counter] = i;
         
         int canidateCount = 0;
@@ -242,7 +274,7 @@ static void RenderSystem_Cull(Renderer* renderer,
             for (int j = 0; j < engine->sceneSystem.lightCount; ++j)
             {
                 const Light* light = engine->sceneSystem.lights + j;
-                Vec3 dir = Vec3_Sub(prop->position, light->point);
+                Vec3 dir = Vec3_Sub(hot->propPositions[k], light->point);
                 
                 float bias = 5.0f;
                 float radius = light->radius + bias;
@@ -253,7 +285,7 @@ static void RenderSystem_Cull(Renderer* renderer,
                     Vec3_Dot(light->forward, Vec3_Norm(dir)) > cosf(light->angle + angleBias))
                 {
                     lightSearchList[canidateCount].lightIndex = j;
-                    lightSearchList[canidateCount].distSq = Vec3_DistSq(prop->position, light->point);
+                    lightSearchList[canidateCount].distSq = Vec3_DistSq(hot->propPositions[k], light->point);
                     
                     ++canidateCount;
                 }
@@ -281,12 +313,12 @@ static void RenderSystem_Cull(Renderer* renderer,
     
     /* Units */
     counter = 0;
-    for (int i = 0; i < SCENE_SYSTEM_UNITS_MAX; ++i)
+    for (int k = 0; k < hot->liveUnitCount; ++k)
     {
-        const Unit* unit = engine->sceneSystem.units + i;
-        if (unit->dead) continue;
+        int i = hot->liveUnits[k];
+        
         if (playerView->unitVisibility[i] < 0.22) continue;
-        if (!Frustum_AabbVisible(cam, unit->bounds)) continue;
+        if (!Frustum_AabbVisible(cam, hot->unitBounds[k])) continue;
         
         renderList->units[counter] = i;
         
@@ -294,7 +326,7 @@ static void RenderSystem_Cull(Renderer* renderer,
         for (int j = 0; j < engine->sceneSystem.lightCount; ++j)
         {
             const Light* light = engine->sceneSystem.lights + j;
-            Vec3 dir = Vec3_Sub(unit->position, light->point);
+            Vec3 dir = Vec3_Sub(hot->unitPositions[k], light->point);
             
             float bias = 5.0f;
             float radius = light->radius + bias;
@@ -305,7 +337,7 @@ static void RenderSystem_Cull(Renderer* renderer,
                 Vec3_Dot(light->forward, Vec3_Norm(dir)) > cosf(light->angle + angleBias))
             {
                 lightSearchList[canidateCount].lightIndex = j;
-                lightSearchList[canidateCount].distSq = Vec3_DistSq(unit->position, light->point);
+                lightSearchList[canidateCount].distSq = Vec3_DistSq(hot->unitPositions[k], light->point);
                 
                 ++canidateCount;
             }
@@ -355,13 +387,44 @@ void RenderSystem_Render(RenderSystem* system,
                          const struct Engine* engine)
 {
     
-    RenderList list;
-    memset(&list, 0, sizeof(RenderList));
+    RenderList* list = &system->renderList;
+    RenderList_Reserve(list, engine->sceneSystem.unitCapacity, engine->sceneSystem.propCapacity);
+    memset(&list->observerList, 0, sizeof(list->observerList));
+    
+    RenderSystem_Cull(system->renderer, cam, &engine->fogView, engine, list);
+    RenderSystem_PrepareObservers(system->renderer, cam, &engine->fogView, engine, list);
     
-    RenderSystem_Cull(system->renderer, cam, &engine->fogView, engine, &list);
-    RenderSystem_PrepareObservers(system->renderer, cam, &engine->fogView, engine, &list);
+    system->renderer->render(system->renderer, engine, cam, list);
+}
+
+void FogView_Reserve(FogView* view, int unitCapacity, int propCapacity)
+{
+    if (unitCapacity > view->unitCapacity)
+    {
+        view->unitVisibility = realloc(view->unitVisibility, sizeof(float) * unitCapacity);
+        view->observerPoints = realloc(view->observerPoints, sizeof(Vec3) * unitCapacity);
+        view->observerRadiiSq = realloc(view->observerRadiiSq, sizeof(float) * unitCapacity);
+        
+        memset(view->unitVisibility + view->unitCapacity, 0, sizeof(float) * (unitCapacity - view->unitCapacity));
+        view->unitCapacity = unitCapacity;
+    }
     
-    system->renderer->render(system->renderer, engine, cam, &list);
+    if (propCapacity > view->propCapacity)
+    {
+        view->propVisibility = realloc(view->propVisibility, sizeof(float) * propCapacity);
+        
+        memset(view->propVisibility + view->propCapacity, 0, sizeof(float) * (propCapacity - view->propCapacity));
+        view->propCapacity = propCapacity;
+    }
+}
+
+void FogView_Shutdown(FogView* view)
+{
+    free(view->unitVisibility);
+    free(view->propVisibility);
+    free(view->observerPoints);
+    free(view->observerRadiiSq);
+    memset(view, 0, sizeof(FogView));
 }
 
 
@@ -25,6 +25,7 @@ typedef struct
     Renderer* renderer;
     
     HintBuffer hintBuffer;
+    RenderList renderList;
     
     StaticModel models[RENDER_SYSTEM_MAX_MODELS];
     SkelModel skelModels[RENDER_SYSTEM_MAX_MODELS];
@@ -57,4 +58,8 @@ extern int RenderSystem_PrepareHintBuffer(RenderSystem* system, HintBuffer* buff
 extern void RenderSystem_Render(RenderSystem* system,
                                 const Frustum* cam,
                                 const struct Engine* engine);
+
+/* grows the visibility arrays to hold every unit and prop, they never shrink */
+extern void FogView_Reserve(FogView* view, int unitCapacity, int propCapacity);
+extern void FogView_Shutdown(FogView* view);
 #endif
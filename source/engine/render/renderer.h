@@ -32,8 +32,15 @@ typedef struct
 
 typedef struct
 {
-    float unitVisibility[SCENE_SYSTEM_UNITS_MAX];
-    float propVisibility[SCENE_SYSTEM_PROPS_MAX];
+    // by unit and prop index, grown to the scene's capacity by FogView_Reserve
+    float* unitVisibility;
+    float* propVisibility;
+    int unitCapacity;
+    int propCapacity;
+    
+    // scratch for building the view
+    Vec3* observerPoints;
+    float* observerRadiiSq;
 } FogView;
 
 
@@ -41,13 +48,16 @@ typedef struct
 
 typedef struct
 {
-    int units[SCENE_SYSTEM_UNITS_MAX];
-    LightEntry unitLights[SCENE_SYSTEM_UNITS_MAX];
+    // grown to the scene's capacity before culling
+    int* units;
+    LightEntry* unitLights;
     int unitCount;
+    int unitCapacity;
     
-    int props[SCENE_SYSTEM_PROPS_MAX];
-    LightEntry propLights[SCENE_SYSTEM_UNITS_MAX];
+    int* props;
+    LightEntry* propLights;
     int propCount;
+    int propCapacity;
     
     int chunks[SCENE_SYSTEM_CHUNKS_MAX];
     int chunkCount;
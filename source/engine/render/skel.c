@@ -23,128 +23,134 @@ int Skel_Init(Skel* skel, short jointCount, short attachPointCount)
     if (!skel->joints)
         return 0;
     
-    skel->renderJointRotations = malloc(sizeof(Quat) * jointCount);
-    if (!skel->renderJointRotations)
-    {
-        free(skel->joints);
-        return 0;
-    }
-    
-    skel->renderJointOrigins = malloc(sizeof(Vec3) * jointCount);
-    if (!skel->renderJointRotations)
-    {
-        free(skel->joints);
-        free(skel->renderJointRotations);
-        return 0;
-    }
-    
-    for (int i = 0; i < jointCount; ++i)
-    {
-        skel->joints[i].modelRotation = Quat_Identity;
-        skel->joints[i].rotation = Quat_Identity;
-    }
-    
     for (int i = 0; i < SKEL_ATTACH_POINTS_MAX; ++i)
-    {
         skel->attachPoints[i].rotation = Quat_Identity;
-        skel->attachPoints[i].modelRotation = Quat_Identity;
-    }
     
     skel->origin = Vec3_Zero;
-    skel->rotation = Quat_Identity;
-    skel->offset = Vec3_Zero;
     
     return 1;
 
 }
 
-int Skel_Copy(Skel* dest, const Skel* source)
+void Skel_Shutdown(Skel* skel)
 {
-    assert(dest);
-    assert(source);
+    if (skel->joints)
+    {
+        free(skel->joints);
+        skel->joints = NULL;
+    }
+}
 
-    dest->jointCount = source->jointCount;
-    dest->attachPointCount = source->attachPointCount;
+/* local rotations, model rotations, model heads and model tails */
+static size_t SkelPosePool_SlotSize(int jointsPerPose)
+{
+    return (sizeof(Quat) * 2 + sizeof(Vec3) * 2) * jointsPerPose;
+}
+
+int SkelPosePool_Init(SkelPosePool* pool, int poseCount, int jointsPerPose)
+{
+    assert(pool);
     
-    dest->joints = malloc(sizeof(SkelJoint) * source->jointCount);
-    if (!dest->joints)
-        return 0;
+    pool->data = NULL;
+    pool->poseCount = 0;
+    pool->jointsPerPose = 0;
     
-    dest->renderJointRotations = malloc(sizeof(Quat) * source->jointCount);
-    if (!dest->renderJointRotations)
+    if (poseCount > 0 && jointsPerPose > 0)
     {
-        free(dest->joints);
-        return 0;
+        pool->data = malloc(SkelPosePool_SlotSize(jointsPerPose) * poseCount);
+        if (!pool->data)
+            return 0;
     }
     
-    dest->renderJointOrigins = malloc(sizeof(Vec3) * source->jointCount);
-    if (!dest->renderJointRotations)
+    pool->poseCount = poseCount;
+    pool->jointsPerPose = jointsPerPose;
+    return 1;
+}
+
+void SkelPosePool_Shutdown(SkelPosePool* pool)
+{
+    if (pool->data)
     {
-        free(dest->joints);
-        free(dest->renderJointRotations);
-        return 0;
+        free(pool->data);
+        pool->data = NULL;
     }
     
-    memcpy(dest->joints, source->joints, source->jointCount * sizeof(SkelJoint));
-    memcpy(dest->attachPoints, source->attachPoints, source->attachPointCount * sizeof(SkelAttachPoint));
-
-    dest->origin = source->origin;
-    dest->rotation = source->rotation;
-    dest->offset = source->offset;
-    return 1;
+    pool->poseCount = 0;
+    pool->jointsPerPose = 0;
 }
 
-void Skel_Shutdown(Skel* skel)
+int SkelPose_Init(SkelPose* pose, const Skel* skel, SkelPosePool* pool, int slot)
 {
-    if (skel->joints)
-        free(skel->joints);
+    assert(pose && skel && pool);
+    
+    if (slot < 0 || slot >= pool->poseCount || skel->jointCount > pool->jointsPerPose)
+    {
+        printf("skel pose slot: %i does not fit %i joints\n", slot, skel->jointCount);
+        return 0;
+    }
+    
+    int jointCount = pool->jointsPerPose;
+    char* data = pool->data + SkelPosePool_SlotSize(jointCount) * slot;
     
-    if (skel->renderJointOrigins)
-        free(skel->renderJointOrigins);
+    pose->skel = skel;
+    pose->rotations = (Quat*)data;
+    pose->modelRotations = pose->rotations + jointCount;
+    pose->modelHeads = (Vec3*)(pose->modelRotations + jointCount);
+    pose->modelTails = pose->modelHeads + jointCount;
     
-    if (skel->renderJointRotations)
-        free(skel->renderJointRotations);
+    for (int i = 0; i < skel->jointCount; ++i)
+    {
+        pose->rotations[i] = Quat_Identity;
+        pose->modelRotations[i] = Quat_Identity;
+    }
+    
+    for (int i = 0; i < SKEL_ATTACH_POINTS_MAX; ++i)
+    {
+        pose->attachPoints[i].modelPosition = Vec3_Zero;
+        pose->attachPoints[i].modelRotation = Quat_Identity;
+    }
+    
+    pose->offset = Vec3_Zero;
+    pose->rotation = Quat_Identity;
+    return 1;
 }
 
-/* posing transforms the world joints by the current local joint configuration */
-void Skel_Pose(Skel* skel)
+/* posing transforms the model joints by the current local joint configuration */
+void SkelPose_Update(SkelPose* pose)
 {
-    assert(skel);
+    assert(pose);
+    const Skel* skel = pose->skel;
     
-    Vec3 worldOrigin = Quat_MultVec3(&skel->rotation, Vec3_Add(skel->origin, skel->offset));
+    Vec3 worldOrigin = Quat_MultVec3(&pose->rotation, Vec3_Add(skel->origin, pose->offset));
     
     for (int i = 0; i < skel->jointCount; ++i)
     {
-        SkelJoint* joint = skel->joints + i;
+        const SkelJoint* joint = skel->joints + i;
         
         if (joint->parent < 0)
         {
-            joint->modelHead = worldOrigin;
-            joint->modelTail =  Vec3_Add(worldOrigin, joint->tail);
-            joint->modelRotation = Quat_Mult(skel->rotation, joint->rotation);
+            pose->modelHeads[i] = worldOrigin;
+            pose->modelTails[i] = Vec3_Add(worldOrigin, joint->tail);
+            pose->modelRotations[i] = Quat_Mult(pose->rotation, pose->rotations[i]);
         }
         else
         {
-            const SkelJoint* parent = &skel->joints[joint->parent];
-            
-            joint->modelHead = parent->modelTail;
-            joint->modelRotation = Quat_Mult(parent->modelRotation, joint->rotation);
-            joint->modelTail = Vec3_Add(Quat_MultVec3(&joint->modelRotation, joint->tail), parent->modelTail);
+            pose->modelHeads[i] = pose->modelTails[joint->parent];
+            pose->modelRotations[i] = Quat_Mult(pose->modelRotations[joint->parent], pose->rotations[i]);
+            pose->modelTails[i] = Vec3_Add(Quat_MultVec3(&pose->modelRotations[i], joint->tail), pose->modelTails[joint->parent]);
         }
-        
-        skel->renderJointOrigins[i] = joint->modelHead;
-        skel->renderJointRotations[i] = joint->modelRotation;
     }
     
     for (int i = 0; i < skel->attachPointCount; ++i)
     {
-        SkelAttachPoint* point = skel->attachPoints + i;
+        const SkelAttachPoint* point = skel->attachPoints + i;
         assert(point->joint >= 0 && point->joint < skel->jointCount);
         
-        const SkelJoint* joint = skel->joints + point->joint;
+        SkelAttachPose* attachPose = pose->attachPoints + i;
+        const Quat* jointRotation = pose->modelRotations + point->joint;
         
-        point->modelRotation = Quat_Mult(joint->modelRotation, point->rotation);
-        point->modelPosition = Vec3_Add(Quat_MultVec3(&joint->modelRotation, point->offset), joint->modelTail);
+        attachPose->modelRotation = Quat_Mult(*jointRotation, point->rotation);
+        attachPose->modelPosition = Vec3_Add(Quat_MultVec3(jointRotation, point->offset), pose->modelTails[point->joint]);
     }
 }
 
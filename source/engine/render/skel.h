@@ -12,20 +12,13 @@
  Bone rotations from the 3d editor to not come into play. All animations store rotations relative to pose positions.
  */
 
-/* joint transform in local space and persistent joint data */
+/* joint in the rest pose, shared by every model using the skeleton */
 typedef struct
 {
     char name[SKEL_JOINT_NAME_MAX];
     short parent;
     
-    /* joint info in local space */
-    Quat rotation;
     Vec3 tail; /* relative to head */
-    
-    /* joint pose in model space */
-    Quat modelRotation;
-    Vec3 modelHead;
-    Vec3 modelTail;
 } SkelJoint;
 
 typedef struct
@@ -35,25 +28,17 @@ typedef struct
     short joint;
     Vec3 offset;
     Quat rotation; /* offset rotation from bone rotation */
-    
-    /* attach point position in model space */
-    Vec3 modelPosition;
-    Quat modelRotation;
 } SkelAttachPoint;
 
 /*
-Skel stores the current pose in local space, and the current pose in world space
-this allows engine code to manipulate joint transformations in local space and apply
-transformations directly to vertices from the world space skeleton.
-*/
+ Skel is the rig loaded with a model, the joint hierarchy and attach points.
+ It does not change once loaded, and is shared by every instance of the model.
+ Each instance has its own SkelPose.
+ */
 
 typedef struct
 {
     SkelJoint* joints;
-    /* data for GPU skinning */
-    Quat* renderJointRotations;
-    Vec3* renderJointOrigins;
-    
     
     /* attach points for attaching weapons etc, offset from bones */
     SkelAttachPoint attachPoints[SKEL_ATTACH_POINTS_MAX];
@@ -61,21 +46,57 @@ typedef struct
     /* position of root bone head relative to skeleton */
     Vec3 origin;
     
+    /* number of joints in skeleton */
+    short jointCount;
+    short attachPointCount;
+} Skel;
+
+/* attach point position in model space */
+typedef struct
+{
+    Vec3 modelPosition;
+    Quat modelRotation;
+} SkelAttachPose;
+
+/*
+ SkelPose stores the current pose of a Skel in local space, and in model space.
+ This allows engine code to manipulate joint transformations in local space and apply
+ transformations directly to vertices from the model space pose.
+ The joint arrays are a slot in a SkelPosePool.
+ */
+
+typedef struct
+{
+    const Skel* skel;
+    
+    /* joint rotations in local space */
+    Quat* rotations;
+    
+    /* joint pose in model space, the rotations and heads are also the data for GPU skinning */
+    Quat* modelRotations;
+    Vec3* modelHeads;
+    Vec3* modelTails;
+    
+    SkelAttachPose attachPoints[SKEL_ATTACH_POINTS_MAX];
+    
     /* A vector offset from root bone position for animation
     The relative vector, rather than absolute position is helpful to allow the skeleton to be updated without changing animations
      */
     Vec3 offset;
     
-    /* local rotation. This handled in the skeleton, rather than render matrix for attachments and collisions */
+    /* local rotation. This handled in the pose, rather than render matrix for attachments and collisions */
     Quat rotation;
-    
-    /* number of joints in skeleton */
-    short jointCount;
-    short attachPointCount;
-} Skel;
+} SkelPose;
+
+/* joint storage for a fixed number of poses, allocated once */
+typedef struct
+{
+    char* data;
+    int poseCount;
+    int jointsPerPose;
+} SkelPosePool;
 
 extern int Skel_Init(Skel* skel, short jointCount, short attachPointCount);
-extern int Skel_Copy(Skel* dest, const Skel* source);
 extern void Skel_Shutdown(Skel* skel);
 
 extern short Skel_FindJointIndex(const Skel* skel, const char* name);
@@ -90,7 +111,14 @@ extern short Skel_AddAttachPoint(Skel* skel,
                                  int joint,
                                  const char* name);
 
-/* updates world joints from local */
-extern void Skel_Pose(Skel* skel);
+extern int SkelPosePool_Init(SkelPosePool* pool, int poseCount, int jointsPerPose);
+extern void SkelPosePool_Shutdown(SkelPosePool* pool);
+
+/* uses the joint storage of slot in the pool, which must fit the skeleton.
+   Allocates nothing, the pose starts at the rest pose. */
+extern int SkelPose_Init(SkelPose* pose, const Skel* skel, SkelPosePool* pool, int slot);
+
+/* updates model space joints from local */
+extern void SkelPose_Update(SkelPose* pose);
 
 #endif
@@ -212,12 +212,12 @@ void SkelAnimatorInfo_Clear(SkelAnimatorInfo* info)
     info->finishedTransition = 0;
 }
 
-int SkelAnimator_Init(SkelAnimator* animator, Skel* skel)
+int SkelAnimator_Init(SkelAnimator* animator, SkelPose* pose)
 {
     if (!animator)
         return 0;
     
-    animator->skel = skel;
+    animator->pose = pose;
     animator->anim = NULL;
     animator->targetAnim = NULL;
     animator->frame = 0;
@@ -248,8 +248,8 @@ static void SkelAnimator_ReplaceAnim(SkelAnimator* animator,
     
     size_t rotationDataOffset = startFrame * anim->jointCount;
     
-    for (int i = 0; i < animator->skel->jointCount; ++i)
-        animator->skel->joints[i].rotation = anim->jointRotations[rotationDataOffset + i];
+    for (int i = 0; i < animator->pose->skel->jointCount; ++i)
+        animator->pose->rotations[i] = anim->jointRotations[rotationDataOffset + i];
 }
 
 int SkelAnimator_SetAnim(SkelAnimator* animator,
@@ -263,9 +263,9 @@ int SkelAnimator_SetAnim(SkelAnimator* animator,
     if (animator->anim == anim || (animator->targetAnim == anim && transitionFrameCount != 0))
         return 0;
     
-    if (anim->jointCount != animator->skel->jointCount)
+    if (anim->jointCount != animator->pose->skel->jointCount)
     {
-        printf("anim bones: %i do not match skel bones %i\n", anim->jointCount, animator->skel->jointCount);
+        printf("anim bones: %i do not match skel bones %i\n", anim->jointCount, animator->pose->skel->jointCount);
         return 0;
     }
     
@@ -297,9 +297,10 @@ void SkelAnimator_RestartAnim(SkelAnimator* animator)
     animator->subFrame = 0;
 }
 
-static void SkelAnimator_TickAnim(SkelAnimator* animator, Skel* skel, SkelAnimatorInfo* frameInfo)
+static void SkelAnimator_TickAnim(SkelAnimator* animator, SkelPose* pose, SkelAnimatorInfo* frameInfo)
 {
-    assert(animator && skel && frameInfo);
+    assert(animator && pose && frameInfo);
+    const Skel* skel = pose->skel;
     const SkelAnim* anim = animator->anim;
     
     if (!anim || anim->frameCount < 1)
@@ -324,18 +325,18 @@ static void SkelAnimator_TickAnim(SkelAnimator* animator, Skel* skel, SkelAnimat
         {
             Quat from = anim->jointRotations[currentDataStart + i];
             Quat to = anim->jointRotations[nextDataStart + i];
-            skel->joints[i].rotation = Quat_Slerp(from, to, interp);
+            pose->rotations[i] = Quat_Slerp(from, to, interp);
         }
         
-        skel->offset = Vec3_Lerp(current->rootOffset, next->rootOffset, interp);
+        pose->offset = Vec3_Lerp(current->rootOffset, next->rootOffset, interp);
     }
     else
     {
         // no interploation necessary 1 to 1 frame count
         for (int i = 0; i < skel->jointCount; ++i)
-            skel->joints[i].rotation = anim->jointRotations[currentDataStart + i];
+            pose->rotations[i] = anim->jointRotations[currentDataStart + i];
         
-        skel->offset = current->rootOffset;
+        pose->offset = current->rootOffset;
     }
     
     ++animator->subFrame;
@@ -367,7 +368,8 @@ static void SkelAnimator_TickAnim(SkelAnimator* animator, Skel* skel, SkelAnimat
 SkelAnimatorInfo SkelAnimator_Tick(SkelAnimator* animator)
 {
     assert(animator);
-    Skel* skel = animator->skel;
+    SkelPose* pose = animator->pose;
+    const Skel* skel = pose->skel;
     
     SkelAnimatorInfo info;
     SkelAnimatorInfo_Clear(&info);
@@ -389,14 +391,14 @@ SkelAnimatorInfo SkelAnimator_Tick(SkelAnimator* animator)
         {
             Quat from = currentAnim->jointRotations[previousDataStart + i];
             Quat to = targetAnim->jointRotations[nextDataStart + i];
-            skel->joints[i].rotation = Quat_Slerp(from, to, interp);
+            pose->rotations[i] = Quat_Slerp(from, to, interp);
         }
         
         // lerp offset as well
         Vec3 currentOffset = currentAnim->frames[animator->frame].rootOffset;
         Vec3 targetOffset = targetAnim->frames[animator->targetStartFrame].rootOffset;
         
-        skel->offset = Vec3_Lerp(currentOffset, targetOffset, interp);
+        pose->offset = Vec3_Lerp(currentOffset, targetOffset, interp);
         
         ++animator->transitionFrame;
         
@@ -408,7 +410,7 @@ SkelAnimatorInfo SkelAnimator_Tick(SkelAnimator* animator)
     }
     else
     {
-        SkelAnimator_TickAnim(animator, skel, &info);
+        SkelAnimator_TickAnim(animator, pose, &info);
     }
     
     return info;
@@ -84,7 +84,7 @@ DESIGN
 
 typedef struct
 {
-    Skel* skel;
+    SkelPose* pose;
     const SkelAnim* anim;
     const SkelAnim* targetAnim;
     short targetStartFrame;
@@ -101,7 +101,7 @@ typedef struct
     int enableInterp;
 } SkelAnimator;
 
-extern int SkelAnimator_Init(SkelAnimator* animator, Skel* skel);
+extern int SkelAnimator_Init(SkelAnimator* animator, SkelPose* pose);
 extern void SkelAnimator_Shutdown(SkelAnimator* animator);
 
 
@@ -94,8 +94,6 @@ static int SkelModel_FromSKMESH(SkelModel* model, FILE* file)
                     sscanf(lineBuffer, "( %s ), %hi, %f, %f, %f", joint->name, &joint->parent, &joint->tail.x, &joint->tail.y, &joint->tail.z);
                 }
                 
-                joint->rotation = Quat_Identity;
-                
             }
         }
         else if (strstr(command, "attach_points"))
@@ -212,52 +210,72 @@ int SkelModel_FromPath(SkelModel* model, const char* path)
         return 0;
     
     Material_Init(&model->material);
-    SkelAnimator_Init(&model->animator, &model->skel);
     return 1;
 }
 
-int SkelModel_Copy(SkelModel* dest, const SkelModel* source)
+void SkelModel_Shutdown(SkelModel* model)
 {
-    assert(dest && source);
+    Skel_Shutdown(&model->skel);
+    SkelSkin_Shutdown(&model->skin);
+}
+
+void SkelModelInstance_Init(SkelModelInstance* instance)
+{
+    instance->shared = NULL;
+    Material_Init(&instance->material);
+}
+
+int SkelModelInstance_Set(SkelModelInstance* instance,
+                          SkelModel* model,
+                          SkelPosePool* pool,
+                          int slot)
+{
+    assert(instance && model);
     
-    if (!Skel_Copy(&dest->skel, &source->skel))
-        return 0;
+    SkelModelInstance_Clear(instance);
     
-    if (!SkelSkin_Copy(&dest->skin, &source->skin))
+    if (!SkelPose_Init(&instance->pose, &model->skel, pool, slot))
         return 0;
     
-    if (!SkelAnimator_Init(&dest->animator, &dest->skel))
+    if (!SkelAnimator_Init(&instance->animator, &instance->pose))
         return 0;
     
-    Material_Copy(&dest->material, &source->material);
+    ++model->refCount;
+    instance->shared = model;
     
-    memcpy(dest->attachPointTable, source->attachPointTable, sizeof(source->attachPointTable));
+    Material_Copy(&instance->material, &model->material);
+    
+    for (int i = 0; i < SKEL_ATTACH_POINTS_MAX; ++i)
+        instance->attachPointTable[i] = -1;
     
     return 1;
 }
 
-void SkelModel_Shutdown(SkelModel* model)
+void SkelModelInstance_Clear(SkelModelInstance* instance)
 {
-    Skel_Shutdown(&model->skel);
-    SkelSkin_Shutdown(&model->skin);
-    SkelAnimator_Shutdown(&model->animator);
+    if (instance->shared)
+    {
+        assert(instance->shared->refCount > 0);
+        --instance->shared->refCount;
+        instance->shared = NULL;
+    }
 }
 
-SkelAnimatorInfo SkelModel_Tick(SkelModel* model)
+SkelAnimatorInfo SkelModelInstance_Tick(SkelModelInstance* instance)
 {
-    assert(model);
+    assert(instance);
     
-    SkelAnimatorInfo info = SkelAnimator_Tick(&model->animator);
-    Skel_Pose(&model->skel);
+    SkelAnimatorInfo info = SkelAnimator_Tick(&instance->animator);
+    SkelPose_Update(&instance->pose);
     
     return info;
 }
 
-const SkelAttachPoint* SkelModel_AttachPointAt(const SkelModel* model, int loc)
+const SkelAttachPose* SkelModelInstance_AttachPointAt(const SkelModelInstance* instance, int loc)
 {
-    int index = model->attachPointTable[loc];
-    assert(index >= 0 && index < model->skel.attachPointCount);
-    return model->skel.attachPoints + index;
+    int index = instance->attachPointTable[loc];
+    assert(index >= 0 && index < instance->pose.skel->attachPointCount);
+    return instance->pose.attachPoints + index;
 }
 
 
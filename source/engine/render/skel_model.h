@@ -9,7 +9,7 @@
 
 /*
  
- Each frame the SkelModel selectes the last and next frame from its anim, interpolates
+ Each frame the SkelModelInstance selectes the last and next frame from its anim, interpolates
  animation state between that too and applies it as the current local pose.
  World space skeleton is then calculated and applied to vertices.
  
@@ -19,10 +19,25 @@
  
  */
 
+/* the loaded skeleton and skin, read only and shared by every instance */
 typedef struct
 {
     Skel skel;
     SkelSkin skin;
+    
+    Material material;
+    
+    // instances using this model, it should not be unloaded while any remain
+    int refCount;
+} SkelModel;
+
+/* a model placed in the scene, such as on a unit. Only the pose and animation belong to it. */
+typedef struct
+{
+    // NULL if there is no model
+    SkelModel* shared;
+    
+    SkelPose pose;
     SkelAnimator animator;
     
     Material material;
@@ -31,15 +46,24 @@ typedef struct
     // this is in here, instead of the skel to keep the skel pure
     short attachPointTable[SKEL_ATTACH_POINTS_MAX];
     
-} SkelModel;
+} SkelModelInstance;
 
-extern int SkelModel_Copy(SkelModel* dest, const SkelModel* source);
 extern int SkelModel_FromPath(SkelModel* model, const char* path);
 
 extern void SkelModel_Shutdown(SkelModel* model);
 
-extern SkelAnimatorInfo SkelModel_Tick(SkelModel* model);
+extern void SkelModelInstance_Init(SkelModelInstance* instance);
+
+/* releases any model already set, and poses the new one from slot in the pool */
+extern int SkelModelInstance_Set(SkelModelInstance* instance,
+                                 SkelModel* model,
+                                 SkelPosePool* pool,
+                                 int slot);
+
+extern void SkelModelInstance_Clear(SkelModelInstance* instance);
+
+extern SkelAnimatorInfo SkelModelInstance_Tick(SkelModelInstance* instance);
 
-extern const SkelAttachPoint* SkelModel_AttachPointAt(const SkelModel* model, int loc);
+extern const SkelAttachPose* SkelModelInstance_AttachPointAt(const SkelModelInstance* instance, int loc);
 
 #endif
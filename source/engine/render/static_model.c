@@ -326,5 +326,31 @@ void StaticModel_Shutdown(StaticModel* model)
     }
 }
 
+void StaticModelInstance_Init(StaticModelInstance* instance)
+{
+    instance->shared = NULL;
+    Material_Init(&instance->material);
+}
+
+void StaticModelInstance_Set(StaticModelInstance* instance, StaticModel* model)
+{
+    assert(model);
+    
+    StaticModelInstance_Clear(instance);
+    
+    ++model->refCount;
+    instance->shared = model;
+    Material_Copy(&instance->material, &model->material);
+}
+
+void StaticModelInstance_Clear(StaticModelInstance* instance)
+{
+    if (instance->shared)
+    {
+        assert(instance->shared->refCount > 0);
+        --instance->shared->refCount;
+        instance->shared = NULL;
+    }
+}
 
 
@@ -10,11 +10,33 @@ typedef struct
     int loaded;
     StaticMesh mesh;
     Material material;
+    
+    // instances using this model, it should not be unloaded while any remain
+    int refCount;
 } StaticModel;
 
+/*
+ A loaded model placed in the scene, such as on a prop.
+ The mesh is shared and read only, only the material belongs to the instance.
+ Setting one allocates nothing.
+ */
+
+typedef struct
+{
+    // NULL if there is no model
+    StaticModel* shared;
+    Material material;
+} StaticModelInstance;
+
 extern int StaticModel_FromPath(StaticModel* model, const char* path);
 extern int StaticModel_Copy(StaticModel* dest, const StaticModel* source);
 
 extern void StaticModel_Shutdown(StaticModel* model);
 
+extern void StaticModelInstance_Init(StaticModelInstance* instance);
+
+/* releases any model already set, and starts with the model's material */
+extern void StaticModelInstance_Set(StaticModelInstance* instance, StaticModel* model);
+extern void StaticModelInstance_Clear(StaticModelInstance* instance);
+
 #endif
@@ -1,7 +1,10 @@
 
 #include "vec_math.h"
+
+#ifdef __APPLE__
 #include <Accelerate/Accelerate.h>
 #define APPLE_ACCELERATE 1
+#endif
 
 
 Mat4 Mat4_CreateIdentity()
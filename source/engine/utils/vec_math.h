@@ -56,6 +56,8 @@ static inline float Interp_Lerp(float t, float min, float max)
     return t * max + (1.0f - t) * min;
 }
 
+#define Vec2_Get(v, i) ((&(v).x)[(i)])
+
 static const Vec2 Vec2_Zero = {0.0f, 0.0f};
 
 static inline Vec2 Vec2_Create(float x, float y)
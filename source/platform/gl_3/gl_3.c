@@ -519,8 +519,8 @@ static void Gl_RenderObjectOutlines(Renderer* gl,
         int unitIndex = renderList->units[i];
         const Unit* unit = engine->sceneSystem.units + unitIndex;
         
-        glUniform4fv(GlProg_UniformLoc(skelProg, kProgLocJointRotations), unit->skelModel.skel.jointCount, (float*)unit->skelModel.skel.renderJointRotations);
-        glUniform3fv(GlProg_UniformLoc(skelProg, kProgLocJointOrigins), unit->skelModel.skel.jointCount, (float*)unit->skelModel.skel.renderJointOrigins);
+        glUniform4fv(GlProg_UniformLoc(skelProg, kProgLocJointRotations), unit->skelModel.shared->skel.jointCount, (float*)unit->skelModel.pose.modelRotations);
+        glUniform3fv(GlProg_UniformLoc(skelProg, kProgLocJointOrigins), unit->skelModel.shared->skel.jointCount, (float*)unit->skelModel.pose.modelHeads);
 
         // start with hidden pass
         glDepthFunc(GL_GEQUAL);
@@ -530,8 +530,8 @@ static void Gl_RenderObjectOutlines(Renderer* gl,
         glUniformMatrix4fv(GlProg_UniformLoc(skelProg, kProgLocModel), 1, GL_FALSE, translate.m);
         glUniform1f(GlProg_UniformLoc(skelProg, kProgLocVisibility), fogView->unitVisibility[unitIndex]);
 
-        glBindVertexArray(unit->skelModel.skin.vaoGpuId);
-        glDrawArrays(GL_TRIANGLES, 0, unit->skelModel.skin.vertCount);
+        glBindVertexArray(unit->skelModel.shared->skin.vaoGpuId);
+        glDrawArrays(GL_TRIANGLES, 0, unit->skelModel.shared->skin.vertCount);
         
         // switch to shadow (projection with stencil to avoid blending overlap)
         glDepthFunc(GL_LESS);
@@ -551,7 +551,7 @@ static void Gl_RenderObjectOutlines(Renderer* gl,
         Mat4_Mult(&translate, &shadowTransform, &object);
         
         glUniformMatrix4fv(GlProg_UniformLoc(skelProg, kProgLocModel), 1, GL_FALSE, object.m);
-        glDrawArrays(GL_TRIANGLES, 0, unit->skelModel.skin.vertCount);
+        glDrawArrays(GL_TRIANGLES, 0, unit->skelModel.shared->skin.vertCount);
         glDisable(GL_STENCIL_TEST);
     }
     
@@ -575,8 +575,8 @@ static void Gl_RenderObjectOutlines(Renderer* gl,
         glUniform1f(GlProg_UniformLoc(objectProg, kProgLocVisibility), fogView->propVisibility[propIndex]);
         glUniformMatrix4fv(GlProg_UniformLoc(objectProg, kProgLocModel), 1, GL_FALSE, prop->worldMatrix.m);
 
-        glBindVertexArray(prop->model.mesh.vaoGpuId);
-        glDrawArrays(GL_TRIANGLES, 0, prop->model.mesh.vertCount);
+        glBindVertexArray(prop->model.shared->mesh.vaoGpuId);
+        glDrawArrays(GL_TRIANGLES, 0, prop->model.shared->mesh.vertCount);
     }
     
     glDepthFunc(GL_LESS);
@@ -641,8 +641,8 @@ static void Gl_RenderObjects(Renderer* gl,
         
         glBindTexture(GL_TEXTURE_2D, engine->renderSystem.textures[prop->model.material.diffuseMap].gpuId);
 
-        glBindVertexArray(prop->model.mesh.vaoGpuId);
-        glDrawArrays(GL_TRIANGLES, 0, prop->model.mesh.vertCount);
+        glBindVertexArray(prop->model.shared->mesh.vaoGpuId);
+        glDrawArrays(GL_TRIANGLES, 0, prop->model.shared->mesh.vertCount);
     }
    
     glDisable(GL_CULL_FACE);
@@ -660,10 +660,10 @@ static void Gl_RenderObjects(Renderer* gl,
         const Unit* unit = engine->sceneSystem.units + unitIndex;
         
         glBindTexture(GL_TEXTURE_2D, engine->renderSystem.textures[unit->skelModel.material.diffuseMap].gpuId);
-        glBindVertexArray(unit->skelModel.skin.vaoGpuId);
+        glBindVertexArray(unit->skelModel.shared->skin.vaoGpuId);
 
-        glUniform4fv(GlProg_UniformLoc(skelProg, kProgLocJointRotations), unit->skelModel.skel.jointCount, (float*)unit->skelModel.skel.renderJointRotations);
-        glUniform3fv(GlProg_UniformLoc(skelProg, kProgLocJointOrigins), unit->skelModel.skel.jointCount, (float*)unit->skelModel.skel.renderJointOrigins);
+        glUniform4fv(GlProg_UniformLoc(skelProg, kProgLocJointRotations), unit->skelModel.shared->skel.jointCount, (float*)unit->skelModel.pose.modelRotations);
+        glUniform3fv(GlProg_UniformLoc(skelProg, kProgLocJointOrigins), unit->skelModel.shared->skel.jointCount, (float*)unit->skelModel.pose.modelHeads);
         glUniform1f(GlProg_UniformLoc(skelProg, kProgLocVisibility), fogView->unitVisibility[unitIndex]);
         
         for (int j = 0; j < LIGHTS_PER_OBJECT; ++j)
@@ -691,7 +691,7 @@ static void Gl_RenderObjects(Renderer* gl,
         Mat4 translate = Mat4_CreateTranslate(unit->position);
         glUniformMatrix4fv(GlProg_UniformLoc(skelProg, kProgLocModel), 1, GL_FALSE, translate.m);
 
-        glDrawArrays(GL_TRIANGLES, 0, unit->skelModel.skin.vertCount);
+        glDrawArrays(GL_TRIANGLES, 0, unit->skelModel.shared->skin.vertCount);
     }
     
     glEnable(GL_CULL_FACE);
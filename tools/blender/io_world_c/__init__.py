@@ -176,6 +176,29 @@ class NavExport(bpy.types.Operator):
         wm.fileselect_add(self)
         return {'RUNNING_MODAL'}
 
+class BinaryNavExport(bpy.types.Operator):
+    bl_idname = "export_nav.bnav"
+    bl_label = bl_info['name']
+
+    filepath = StringProperty(name="File Path", description="Filepath used for exporting", maxlen=1024, default= "")
+
+    def execute(self, context):
+        selection = bpy.context.selected_objects
+        if not len(selection) == 1:
+            return {'CANCELLED'}
+
+        b_nav = selection[0]
+
+        export_nav.export_binary(b_nav, self.filepath)
+        return {'FINISHED'}
+
+    def invoke(self, context, event):
+        if not self.filepath:
+            self.filepath = bpy.path.ensure_ext(bpy.data.filepath, ".bnav")
+        wm = context.window_manager
+        wm.fileselect_add(self)
+        return {'RUNNING_MODAL'}
+
 class EventItem(bpy.types.PropertyGroup):
     event = bpy.props.StringProperty(name="Event", default="DEFAULT")
     target = bpy.props.StringProperty(name="Target", default="")
@@ -261,6 +284,9 @@ def menu_skanim_export(self, context):
 def menu_nav_export(self, context):
     self.layout.operator(NavExport.bl_idname, text="Nav (.nav)")
 
+def menu_bnav_export(self, context):
+    self.layout.operator(BinaryNavExport.bl_idname, text="Nav (.bnav)")
+
 def register():
     bpy.utils.register_module(__name__)
     bpy.types.INFO_MT_file_export.append(menu_level_export)
@@ -269,6 +295,7 @@ def register():
     bpy.types.INFO_MT_file_export.append(menu_skmesh_export)
     bpy.types.INFO_MT_file_export.append(menu_skanim_export)
     bpy.types.INFO_MT_file_export.append(menu_nav_export)
+    bpy.types.INFO_MT_file_export.append(menu_bnav_export)
 
     bpy.types.Scene.atlas = bpy.props.StringProperty(name="Atlas")
     bpy.types.Scene.data_path = bpy.props.StringProperty(name="Data Path")
@@ -284,6 +311,7 @@ def unregister():
     bpy.types.INFO_MT_file_export.remove(menu_skmesh_export)
     bpy.types.INFO_MT_file_export.remove(menu_skanim_export)
     bpy.types.INFO_MT_file_export.remove(menu_nav_export)
+    bpy.types.INFO_MT_file_export.remove(menu_bnav_export)
 
 if __name__ == "__main__":
     register()
@@ -151,6 +151,10 @@ def export(filepath):
     if 'skulls' in scene:
         file.write('skulls: %i\n' % scene['skulls'])
 
+    # must come before any props
+    if 'unit_capacity' in scene or 'prop_capacity' in scene:
+        file.write('capacity: %i %i\n' % (scene.get('unit_capacity', 48), scene.get('prop_capacity', 96)))
+
     nav_filename = "main.nav"
     file.write("nav: %s\n" % (data_path + nav_filename))
 
@@ -1,11 +1,20 @@
 import bpy
 import math
+import struct
+
+# must match NAV_AREA_COUNT in nav_mesh.h
+NAV_AREA_COUNT = 16
+
+# a fully creased edge costs this much more to cross
+NAV_CREASE_COST = 3.0
 
 class NavEdge(object):
     def __init__(self):
         self.neighbor_index = -1
         self.vertices = []
         self.solid = False
+        # path cost multiplier, from the edge crease
+        self.cost = 1.0
 
     def __eq__(self, other):
         if self.vertices[0] == other.vertices[0] and self.vertices[1] == other.vertices[1]:
@@ -18,6 +27,15 @@ class NavPoly(object):
         self.edge_start = 0
         self.edge_count = 0
         self.normal = []
+        # area type, from the material slot
+        self.area = 0
+
+        # computed by NavMesh.prepare() for binary export
+        self.center = []
+        self.bounds_min = []
+        self.bounds_max = []
+        self.right = []
+        self.up = []
 
 class NavMesh(object):
     def __init__(self):
@@ -36,12 +54,14 @@ class NavMesh(object):
             new_poly.edge_start = len(self.edges)
             new_poly.edge_count = 0
             new_poly.normal = [e for e in poly.normal]
+            new_poly.area = min(poly.material_index, NAV_AREA_COUNT - 1)
 
             for ek in poly.edge_keys:
                 edge = poly_edge_map[ek]
                 new_edge = NavEdge()
                 new_edge.vertices = [e for e in edge.vertices]
                 new_edge.solid = edge.use_seam
+                new_edge.cost = 1.0 + edge.crease * NAV_CREASE_COST
                 self.edges.append(new_edge)
                 new_poly.edge_count += 1
 
@@ -57,9 +77,60 @@ class NavMesh(object):
                         if self.edges[edge_index] == self.edges[other_edge_index]:
                             self.edges[edge_index].neighbor_index = other_poly_index
 
+    def prepare(self):
+        # the engine does this work when loading a text .nav (see NavMesh_FromNAV)
+
+        # swap the vertex order of each edge so they make a loop in sequence
+        for poly in self.polys:
+            edges = self.edges[poly.edge_start:poly.edge_start + poly.edge_count]
+
+            if len(edges) > 1 and edges[0].vertices[0] in edges[1].vertices:
+                edges[0].vertices.reverse()
+
+            for current, following in zip(edges, edges[1:]):
+                if current.vertices[1] == following.vertices[1]:
+                    following.vertices.reverse()
+
+        for poly in self.polys:
+            edges = self.edges[poly.edge_start:poly.edge_start + poly.edge_count]
+            points = [self.vertices[v] for edge in edges for v in edge.vertices]
+
+            poly.bounds_min = [min(p[k] for p in points) for k in range(3)]
+            poly.bounds_max = [max(p[k] for p in points) for k in range(3)]
+
+            # average of edge midpoints
+            poly.center = [sum(p[k] for p in points) / len(points) for k in range(3)]
+
+            # local 2D basis for point in polygon tests
+            origin = self.vertices[edges[0].vertices[0]]
+            poly.right = normalize(sub(self.vertices[edges[0].vertices[1]], origin))
+            poly.up = normalize(cross(poly.right, poly.normal))
+
+    def edge_point(self, poly, edge):
+        # first vertex of the edge, projected into the poly basis
+        origin = self.vertices[self.edges[poly.edge_start].vertices[0]]
+        pa = sub(self.vertices[edge.vertices[0]], origin)
+        return [dot(pa, poly.right), dot(pa, poly.up)]
+
+
+def sub(a, b):
+    return [a[0] - b[0], a[1] - b[1], a[2] - b[2]]
+
+def dot(a, b):
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]
+
+def cross(a, b):
+    return [a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]]
+
+def normalize(a):
+    length = math.sqrt(dot(a, a))
+    if length == 0.0:
+        return [0.0, 0.0, 0.0]
+    return [a[0] / length, a[1] / length, a[2] / length]
+
 
 def export(b_mesh, filepath):
-    file_version = 2
+    file_version = 3
 
     file = open(filepath, "w")
 
@@ -78,11 +149,59 @@ def export(b_mesh, filepath):
 
     file.write("edges: \n")
     for edge in mesh.edges:
-        file.write("%i, %i, %i, %i\n" % (edge.neighbor_index, edge.vertices[0], edge.vertices[1], edge.solid))
+        file.write("%i, %i, %i, %i, %f\n" % (edge.neighbor_index, edge.vertices[0], edge.vertices[1], edge.solid, edge.cost))
 
     file.write("polys: \n")
     for poly in mesh.polys:
-        file.write("%i, %i\n" % (poly.edge_start, poly.edge_count))
+        file.write("%i, %i, %i\n" % (poly.edge_start, poly.edge_count, poly.area))
         file.write("%f, %f, %f\n" % (poly.normal[0], poly.normal[1], poly.normal[2]))
 
     file.close()
+
+
+# must match the C structs NavPoly and NavEdge in nav_mesh.h
+BNAV_POLY_FORMAT = '<ii3f3f3f3f3f3fiBxxx'
+BNAV_EDGE_FORMAT = '<iiiif'
+
+def export_binary(b_mesh, filepath):
+    file_version = 3
+
+    mesh = NavMesh()
+    mesh.extract(b_mesh)
+    mesh.prepare()
+
+    file = open(filepath, "wb")
+    write_binary(mesh, file, file_version)
+    file.close()
+
+def write_binary(mesh, file, file_version):
+    file.write(struct.pack('<iiiiii',
+                           file_version,
+                           len(mesh.vertices),
+                           len(mesh.polys),
+                           len(mesh.edges),
+                           struct.calcsize(BNAV_POLY_FORMAT),
+                           struct.calcsize(BNAV_EDGE_FORMAT)))
+
+    for vert in mesh.vertices:
+        file.write(struct.pack('<fff', vert[0], vert[1], vert[2]))
+
+    for index, poly in enumerate(mesh.polys):
+        file.write(struct.pack(BNAV_POLY_FORMAT,
+                               poly.edge_start,
+                               poly.edge_count,
+                               *(poly.center + poly.normal +
+                                 poly.bounds_min + poly.bounds_max +
+                                 poly.right + poly.up + [index, poly.area])))
+
+    for edge in mesh.edges:
+        file.write(struct.pack(BNAV_EDGE_FORMAT,
+                               1 if edge.solid else 0,
+                               edge.neighbor_index,
+                               edge.vertices[0],
+                               edge.vertices[1],
+                               edge.cost))
+
+    for poly in mesh.polys:
+        for edge in mesh.edges[poly.edge_start:poly.edge_start + poly.edge_count]:
+            file.write(struct.pack('<ff', *mesh.edge_point(poly, edge)))
@@ -0,0 +1,66 @@
+/*
+ Offline nav mesh baking.
+ 
+ Loads a .nav or .bnav file, builds the visibility table
+ and writes everything out as a .bnav, so the game loads it with no extra work.
+ Builds against the engine nav and utils modules only:
+    
+    cc -std=gnu99 -O2 -I../../source/engine/nav -I../../source/engine/utils \
+        main.c ../../source/engine/nav/nav*.c \
+        ../../source/engine/utils/geo_math.c \
+        ../../source/engine/utils/vec_math.c \
+        ../../source/engine/utils/platform.c -lm -lpthread -o navbake
+ 
+ usage: navbake <in.nav> <out.bnav> [visibility range]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "nav_mesh.h"
+
+int main(int argc, const char * argv[])
+{
+    if (argc < 3)
+    {
+        printf("usage: navbake <in.nav> <out.bnav> [visibility range]\n");
+        return 1;
+    }
+    
+    float range = (argc > 3) ? atof(argv[3]) : NAV_VISIBILITY_RANGE;
+    
+    NavMesh mesh;
+    
+    if (!NavMesh_FromPath(&mesh, argv[1]))
+    {
+        printf("failed to load: %s\n", argv[1]);
+        return 1;
+    }
+    
+    if (!NavMesh_BuildVisibility(&mesh, range))
+    {
+        printf("failed to build visibility\n");
+        NavMesh_Shutdown(&mesh);
+        return 1;
+    }
+    
+    int counts[3] = {0, 0, 0};
+    
+    for (int i = 0; i < mesh.polyCount; ++i)
+        for (int j = 0; j < mesh.polyCount; ++j)
+            ++counts[NavVisibility_Get(&mesh.visibility, i, j)];
+    
+    printf("visibility: %i bytes, %i clear pairs, %i blocked when sampled, %i unknown\n",
+           mesh.visibility.rowOffset[mesh.polyCount],
+           counts[kNavVisibilityAll],
+           counts[kNavVisibilityNone],
+           counts[kNavVisibilityUnknown]);
+    
+    int status = NavMesh_WriteBNAV(&mesh, argv[2]);
+    
+    if (!status)
+        printf("failed to write: %s\n", argv[2]);
+    
+    NavMesh_Shutdown(&mesh);
+    return status ? 0 : 1;
+}
@@ -0,0 +1,1120 @@
+/*
+ Headless nav mesh benchmark.
+ 
+ Loads a .nav file, then solves random start/end pairs, casts random rays
+ and locates moving points, reporting queries per second.
+ Paths are solved again from a cold cache, and once regions are built, to compare,
+ then a tick budget at a time, batched across worker threads, from shared flow fields,
+ and through the path cache. A crowd of units is also steered through itself with local avoidance.
+ Builds against the engine nav and utils modules only:
+    
+    cc -std=gnu99 -O2 -I../../source/engine/nav -I../../source/engine/utils \
+        main.c ../../source/engine/nav/nav*.c \
+        ../../source/engine/utils/geo_math.c \
+        ../../source/engine/utils/vec_math.c \
+        ../../source/engine/utils/platform.c -lm -lpthread -o navbench
+ 
+ usage: navbench <file.nav> [query count] [seed] [max threads]
+ 
+ With --replay it instead runs a query log recorded in game by a NAV_PROFILE build,
+ so nav performance can be compared on real level data. Add -DNAV_PROFILE
+ to the build above to also print the engine's own counters for the replay.
+ 
+ usage: navbench <file.nav> --replay <query log>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "nav_system.h"
+#include "platform.h"
+
+static float Bench_Random()
+{
+    return rand() / (float)RAND_MAX;
+}
+
+static double Bench_Seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* random start/end pairs, timing long paths (over half the mesh size) on their own too.
+   Returns the total solve time. */
+static double Bench_Solve(const NavMesh* mesh, NavSolver* solver, const char* label, int queryCount, unsigned int seed)
+{
+    NavPath path;
+    NavPath_Init(&path);
+    
+    AABB bounds = mesh->polys[0].bounds;
+    
+    for (int i = 1; i < mesh->polyCount; ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            Vec3_Get(bounds.min, k) = MIN(Vec3_Get(bounds.min, k), Vec3_Get(mesh->polys[i].bounds.min, k));
+            Vec3_Get(bounds.max, k) = MAX(Vec3_Get(bounds.max, k), Vec3_Get(mesh->polys[i].bounds.max, k));
+        }
+    }
+    
+    float longDistance = Vec3_Dist(bounds.min, bounds.max) * 0.5f;
+    
+    srand(seed);
+    
+    int found = 0;
+    int longCount = 0;
+    long nodeTotal = 0;
+    double solveTime = 0.0;
+    double longTime = 0.0;
+    double smoothTime = 0.0;
+    
+    for (int i = 0; i < queryCount; ++i)
+    {
+        const NavPoly* startPoly = mesh->polys + (rand() % mesh->polyCount);
+        const NavPoly* endPoly = mesh->polys + (rand() % mesh->polyCount);
+        
+        double t0 = Bench_Seconds();
+        int status = NavSolver_Solve(solver,
+                                     mesh,
+                                     startPoly->plane.point,
+                                     endPoly->plane.point,
+                                     startPoly,
+                                     endPoly,
+                                     NULL,
+                                     &path);
+        double t1 = Bench_Seconds();
+        
+        solveTime += t1 - t0;
+        
+        if (Vec3_Dist(startPoly->plane.point, endPoly->plane.point) > longDistance)
+        {
+            ++longCount;
+            longTime += t1 - t0;
+        }
+        
+        if (status)
+        {
+            ++found;
+            nodeTotal += path.nodeCount;
+            
+            t1 = Bench_Seconds();
+            NavSolver_SmoothPath(mesh, &path, 2.0f);
+            smoothTime += Bench_Seconds() - t1;
+        }
+    }
+    
+    printf("%s solves: %i (%i found, %.1f avg corridor nodes)\n",
+           label,
+           queryCount,
+           found,
+           found > 0 ? (double)nodeTotal / found : 0.0);
+    
+    printf("%s solve: %.0f solves/sec (%.3f us/solve)\n",
+           label,
+           queryCount / solveTime,
+           (solveTime * 1e6) / queryCount);
+    
+    if (longCount > 0)
+    {
+        printf("%s long solve: %.3f us/solve (%i long)\n",
+               label,
+               (longTime * 1e6) / longCount,
+               longCount);
+    }
+    
+    if (found > 0)
+    {
+        printf("%s smooth: %.0f smooths/sec (%.3f us/smooth)\n",
+               label,
+               found / smoothTime,
+               (smoothTime * 1e6) / found);
+    }
+    
+    NavPath_Shutdown(&path);
+    return solveTime;
+}
+
+// larger than any last level cache
+#define BENCH_EVICT_SIZE (64 * 1024 * 1024)
+
+/* solves starting from a cold cache, like the first path in a tick after rendering,
+   where time goes to misses on the mesh data the search reads */
+static void Bench_ColdSolve(const NavMesh* mesh, NavSolver* solver, int queryCount, unsigned int seed)
+{
+    // volatile so the writes are not optimized away
+    volatile unsigned char* evict = malloc(BENCH_EVICT_SIZE);
+    
+    if (!evict)
+        return;
+    
+    NavPath path;
+    NavPath_Init(&path);
+    
+    srand(seed);
+    
+    double solveTime = 0.0;
+    int solveCount = MAX(queryCount / 10, 1);
+    
+    for (int i = 0; i < solveCount; ++i)
+    {
+        const NavPoly* startPoly = mesh->polys + (rand() % mesh->polyCount);
+        const NavPoly* endPoly = mesh->polys + (rand() % mesh->polyCount);
+        
+        // a line per write pushes the mesh and solver out of every cache level
+        for (int j = 0; j < BENCH_EVICT_SIZE; j += 64)
+            evict[j] = (unsigned char)(i + j);
+        
+        double t0 = Bench_Seconds();
+        NavSolver_Solve(solver, mesh, startPoly->plane.point, endPoly->plane.point, startPoly, endPoly, NULL, &path);
+        solveTime += Bench_Seconds() - t0;
+    }
+    
+    size_t searchBytes = mesh->polyCount * (sizeof(int) + sizeof(unsigned char)) +
+        mesh->edgeCount * (sizeof(int) + sizeof(float) + sizeof(Vec3));
+    
+    size_t geometryBytes = mesh->polyCount * sizeof(NavPoly) +
+        mesh->edgeCount * sizeof(NavEdge) +
+        mesh->vertexCount * sizeof(Vec3);
+    
+    printf("cold solve: %.3f us/solve (%i solves, caches flushed before each)\n",
+           (solveTime * 1e6) / solveCount,
+           solveCount);
+    
+    printf("cold solve: search reads %.0f KB of links, geometry is %.0f KB\n",
+           searchBytes / 1024.0,
+           geometryBytes / 1024.0);
+    
+    NavPath_Shutdown(&path);
+    free((void*)evict);
+}
+
+#define BENCH_SMOOTH_CORRIDORS 256
+
+/* smoothing alone, repeated over the longest corridors out of queryCount solves */
+static void Bench_Smooth(const NavMesh* mesh, NavSolver* solver, int queryCount, unsigned int seed)
+{
+    static NavPath corridors[BENCH_SMOOTH_CORRIDORS];
+    int corridorCount = 0;
+    
+    NavPath path;
+    NavPath_Init(&path);
+    
+    for (int i = 0; i < BENCH_SMOOTH_CORRIDORS; ++i)
+        NavPath_Init(corridors + i);
+    
+    srand(seed);
+    
+    // keep the longest, replacing the shortest kept so far
+    for (int i = 0; i < queryCount; ++i)
+    {
+        const NavPoly* startPoly = mesh->polys + (rand() % mesh->polyCount);
+        const NavPoly* endPoly = mesh->polys + (rand() % mesh->polyCount);
+        
+        if (!NavSolver_Solve(solver, mesh, startPoly->plane.point, endPoly->plane.point, startPoly, endPoly, NULL, &path))
+            continue;
+        
+        int slot = corridorCount;
+        
+        if (corridorCount == BENCH_SMOOTH_CORRIDORS)
+        {
+            slot = 0;
+            
+            for (int j = 1; j < corridorCount; ++j)
+            {
+                if (corridors[j].nodeCount < corridors[slot].nodeCount)
+                    slot = j;
+            }
+            
+            if (corridors[slot].nodeCount >= path.nodeCount)
+                continue;
+        }
+        else
+        {
+            ++corridorCount;
+        }
+        
+        NavPath_Copy(&path, corridors + slot);
+    }
+    
+    long portalTotal = 0;
+    double smoothTime = 0.0;
+    int rounds = 20;
+    
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (int i = 0; i < corridorCount; ++i)
+        {
+            NavPath_Copy(corridors + i, &path);
+            portalTotal += path.nodeCount;
+            
+            double t0 = Bench_Seconds();
+            NavSolver_SmoothPath(mesh, &path, 2.0f);
+            smoothTime += Bench_Seconds() - t0;
+        }
+    }
+    
+    if (corridorCount > 0)
+    {
+        printf("long smooth: %.3f us/smooth, %.2f ns/portal (%.1f avg corridor nodes)\n",
+               (smoothTime * 1e6) / (corridorCount * rounds),
+               (smoothTime * 1e9) / portalTotal,
+               (double)portalTotal / (corridorCount * rounds));
+    }
+    
+    for (int i = 0; i < BENCH_SMOOTH_CORRIDORS; ++i)
+        NavPath_Shutdown(corridors + i);
+    
+    NavPath_Shutdown(&path);
+}
+
+/* the same requests solved a budget of nodes at a time, like units planning a path each tick.
+   Reports the slowest single step against the slowest whole solve. */
+static void Bench_Slice(const NavMesh* mesh, NavSolver* solver, int queryCount, unsigned int seed, int budget)
+{
+    srand(seed);
+    
+    long tickTotal = 0;
+    int tickMax = 0;
+    double stepMax = 0.0;
+    double solveMax = 0.0;
+    
+    for (int i = 0; i < queryCount; ++i)
+    {
+        const NavPoly* startPoly = mesh->polys + (rand() % mesh->polyCount);
+        const NavPoly* endPoly = mesh->polys + (rand() % mesh->polyCount);
+        
+        double solveStart = Bench_Seconds();
+        NavSolveStatus status = NavSolver_Begin(solver,
+                                                mesh,
+                                                startPoly->plane.point,
+                                                endPoly->plane.point,
+                                                startPoly,
+                                                endPoly,
+                                                NULL);
+        int ticks = 0;
+        
+        while (status == kNavSolveRunning)
+        {
+            double t0 = Bench_Seconds();
+            status = NavSolver_Step(solver, mesh, budget);
+            stepMax = MAX(stepMax, Bench_Seconds() - t0);
+            ++ticks;
+        }
+        
+        solveMax = MAX(solveMax, Bench_Seconds() - solveStart);
+        tickTotal += ticks;
+        tickMax = MAX(tickMax, ticks);
+    }
+    
+    printf("sliced solve (%i nodes/tick): %.2f avg ticks, %i max ticks, %.3f us max step, %.3f us max solve\n",
+           budget,
+           (double)tickTotal / queryCount,
+           tickMax,
+           stepMax * 1e6,
+           solveMax * 1e6);
+}
+
+/* groups of units heading to the same goal, each solving its own path
+   against one flow field per goal read by every unit */
+static void Bench_Flow(const NavMesh* mesh, NavSolver* solver, int queryCount, unsigned int seed, int unitsPerGoal)
+{
+    NavPath path;
+    NavPath_Init(&path);
+    
+    NavFlowField field;
+    NavFlowField_Init(&field);
+    
+    enum { kUnitMax = 64 };
+    const NavPoly* starts[kUnitMax];
+    unitsPerGoal = MIN(unitsPerGoal, kUnitMax);
+    
+    int goalCount = MAX(queryCount / unitsPerGoal, 1);
+    
+    double solveTime = 0.0;
+    double flowTime = 0.0;
+    double solveLength = 0.0;
+    double flowLength = 0.0;
+    int mismatched = 0;
+    
+    srand(seed);
+    
+    for (int g = 0; g < goalCount; ++g)
+    {
+        const NavPoly* goalPoly = mesh->polys + (rand() % mesh->polyCount);
+        
+        for (int i = 0; i < unitsPerGoal; ++i)
+            starts[i] = mesh->polys + (rand() % mesh->polyCount);
+        
+        int solveFound[kUnitMax];
+        float solveLengths[kUnitMax];
+        
+        double t0 = Bench_Seconds();
+        
+        for (int i = 0; i < unitsPerGoal; ++i)
+        {
+            solveFound[i] = NavSolver_Solve(solver, mesh, starts[i]->plane.point, goalPoly->plane.point, starts[i], goalPoly, NULL, &path);
+            solveLengths[i] = 0.0f;
+            
+            for (int j = 1; solveFound[i] && j < path.nodeCount; ++j)
+                solveLengths[i] += Vec3_Dist(path.nodes[j - 1].point, path.nodes[j].point);
+        }
+        
+        double t1 = Bench_Seconds();
+        solveTime += t1 - t0;
+        
+        NavFlowField_Build(&field, solver, mesh, goalPoly, goalPoly->plane.point);
+        
+        for (int i = 0; i < unitsPerGoal; ++i)
+        {
+            int found = NavFlowField_Path(&field, mesh, starts[i]->plane.point, goalPoly->plane.point, starts[i], &path);
+            
+            if (found != solveFound[i])
+            {
+                ++mismatched;
+                continue;
+            }
+            
+            float length = 0.0f;
+            
+            for (int j = 1; found && j < path.nodeCount; ++j)
+                length += Vec3_Dist(path.nodes[j - 1].point, path.nodes[j].point);
+            
+            flowLength += length;
+            solveLength += solveLengths[i];
+        }
+        
+        flowTime += Bench_Seconds() - t1;
+    }
+    
+    int pathCount = goalCount * unitsPerGoal;
+    
+    printf("flow field (%i units/goal): %.3f us/path vs %.3f us/solve, corridors %.3fx solved length, %i reach mismatches\n",
+           unitsPerGoal,
+           (flowTime * 1e6) / pathCount,
+           (solveTime * 1e6) / pathCount,
+           flowLength / MAX(solveLength, 1e-6),
+           mismatched);
+    
+    NavFlowField_Shutdown(&field);
+    NavPath_Shutdown(&path);
+}
+
+/* units on a circle all walking to the opposite side, the worst case for a crowd.
+   Counts ticks where two units overlap, with and without avoidance. */
+static void Bench_Avoid(int unitCount, int tickCount)
+{
+    const float radius = 1.0f;
+    const float speed = 0.2f;
+    
+    NavAvoidance avoidance;
+    NavAvoidance_Init(&avoidance, NAV_AVOID_TIME_HORIZON);
+    
+    Vec2* positions = malloc(sizeof(Vec2) * unitCount);
+    Vec2* velocities = malloc(sizeof(Vec2) * unitCount);
+    Vec2* goals = malloc(sizeof(Vec2) * unitCount);
+    
+    // spaced a little more than a unit apart around the circle
+    float circleRadius = MAX(unitCount * radius * 3.0f / (2.0f * M_PI), 10.0f);
+    
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int i = 0; i < unitCount; ++i)
+        {
+            float angle = (2.0f * M_PI * i) / unitCount;
+            positions[i] = Vec2_Create(cosf(angle) * circleRadius, sinf(angle) * circleRadius);
+            goals[i] = Vec2_Negate(positions[i]);
+            velocities[i] = Vec2_Zero;
+        }
+        
+        long overlaps = 0;
+        int arrived = 0;
+        double solveTime = 0.0;
+        
+        for (int t = 0; t < tickCount; ++t)
+        {
+            NavAvoidance_Clear(&avoidance);
+            
+            for (int i = 0; i < unitCount; ++i)
+            {
+                Vec2 toGoal = Vec2_Sub(goals[i], positions[i]);
+                float dist = Vec2_Length(toGoal);
+                Vec2 preferred = dist > speed ? Vec2_Scale(toGoal, speed / dist) : toGoal;
+                
+                NavAvoidance_AddAgent(&avoidance, positions[i], velocities[i], preferred, radius, speed);
+            }
+            
+            if (pass == 1)
+            {
+                double t0 = Bench_Seconds();
+                NavAvoidance_Solve(&avoidance);
+                solveTime += Bench_Seconds() - t0;
+            }
+            
+            for (int i = 0; i < unitCount; ++i)
+            {
+                const NavAgent* agent = avoidance.agents + i;
+                velocities[i] = pass == 1 ? agent->newVelocity : agent->preferredVelocity;
+                positions[i] = Vec2_Add(positions[i], velocities[i]);
+            }
+            
+            for (int i = 0; i < unitCount; ++i)
+            {
+                for (int j = i + 1; j < unitCount; ++j)
+                {
+                    if (Vec2_Dist(positions[i], positions[j]) < radius * 2.0f * 0.9f)
+                        ++overlaps;
+                }
+            }
+        }
+        
+        for (int i = 0; i < unitCount; ++i)
+            arrived += Vec2_Dist(positions[i], goals[i]) < 1.0f;
+        
+        if (pass == 0)
+        {
+            printf("crowd (%i units, %i ticks) no avoidance: %li overlaps, %i arrived\n", unitCount, tickCount, overlaps, arrived);
+        }
+        else
+        {
+            printf("crowd (%i units, %i ticks) avoidance: %.3f us/tick (%.1f neighbors tested/unit), %li overlaps, %i arrived\n",
+                   unitCount,
+                   tickCount,
+                   (solveTime * 1e6) / tickCount,
+                   avoidance.neighborsTested / (float)unitCount,
+                   overlaps,
+                   arrived);
+        }
+    }
+    
+    free(positions);
+    free(velocities);
+    free(goals);
+    NavAvoidance_Shutdown(&avoidance);
+}
+
+/* the same requests solved one at a time, then batched on 1 to threadMax threads */
+static void Bench_Batch(const NavMesh* mesh, NavSolver* solver, int queryCount, unsigned int seed, int threadMax)
+{
+    NavPathRequest* requests = malloc(sizeof(NavPathRequest) * queryCount);
+    NavPath* serialPaths = malloc(sizeof(NavPath) * queryCount);
+    NavPath* batchPaths = malloc(sizeof(NavPath) * queryCount);
+    int* serialResults = malloc(sizeof(int) * queryCount);
+    
+    srand(seed);
+    
+    for (int i = 0; i < queryCount; ++i)
+    {
+        NavPath_Init(serialPaths + i);
+        NavPath_Init(batchPaths + i);
+        
+        NavPathRequest* request = requests + i;
+        request->startPoly = mesh->polys + (rand() % mesh->polyCount);
+        request->startPoint = request->startPoly->plane.point;
+        request->endPoint = mesh->polys[rand() % mesh->polyCount].plane.point;
+        request->radius = 2.0f;
+        request->filter = NULL;
+        request->outPath = batchPaths + i;
+    }
+    
+    double t0 = Bench_Seconds();
+    
+    for (int i = 0; i < queryCount; ++i)
+    {
+        const NavPathRequest* request = requests + i;
+        Ray3 targetRay = Ray3_Create(Vec3_Offset(request->endPoint, 0.0f, 0.0f, 1.0f), Vec3_Create(0.0f, 0.0f, -1.0f));
+        
+        float t;
+        const NavPoly* endPoly = NavMesh_Raycast(mesh, targetRay, &t);
+        
+        serialResults[i] = endPoly && NavSolver_Solve(solver,
+                                                      mesh,
+                                                      request->startPoint,
+                                                      request->endPoint,
+                                                      request->startPoly,
+                                                      endPoly,
+                                                      NULL,
+                                                      serialPaths + i);
+        
+        if (serialResults[i])
+            NavSolver_SmoothPath(mesh, serialPaths + i, request->radius);
+    }
+    
+    double serialTime = Bench_Seconds() - t0;
+    
+    printf("serial: %.0f paths/sec\n", queryCount / serialTime);
+    
+    for (int threadCount = 1; threadCount <= threadMax; ++threadCount)
+    {
+        NavBatch batch;
+        
+        if (!NavBatch_Init(&batch, threadCount))
+            break;
+        
+        NavBatch_Prepare(&batch, mesh);
+        
+        t0 = Bench_Seconds();
+        NavBatch_Solve(&batch, mesh, requests, queryCount);
+        double batchTime = Bench_Seconds() - t0;
+        
+        int mismatches = 0;
+        
+        for (int i = 0; i < queryCount; ++i)
+        {
+            const NavPath* a = serialPaths + i;
+            const NavPath* b = batchPaths + i;
+            
+            if (requests[i].result != serialResults[i] ||
+                (serialResults[i] && (a->nodeCount != b->nodeCount ||
+                                      memcmp(a->nodes, b->nodes, sizeof(NavPathNode) * a->nodeCount) != 0)))
+            {
+                ++mismatches;
+            }
+        }
+        
+        printf("batch %i threads: %.0f paths/sec (%.2fx serial, %i mismatches)\n",
+               batch.threadCount,
+               queryCount / batchTime,
+               serialTime / batchTime,
+               mismatches);
+        
+        NavBatch_Shutdown(&batch);
+    }
+    
+    for (int i = 0; i < queryCount; ++i)
+    {
+        NavPath_Shutdown(serialPaths + i);
+        NavPath_Shutdown(batchPaths + i);
+    }
+    
+    free(requests);
+    free(serialPaths);
+    free(batchPaths);
+    free(serialResults);
+}
+
+/* a small set of poly pairs requested over and over, like AI evaluation and hover previews */
+static void Bench_Cache(const char* path, int queryCount, unsigned int seed)
+{
+    static NavSystem system;
+    NavSystem_Init(&system);
+    
+    // load through the system so its cache and solvers are set up
+    Filepath_SetDirectory(kDirectoryData, path[0] == '/' ? "" : ".");
+    NavSystem_LoadMesh(&system, path);
+    
+    const NavMesh* mesh = &system.navMesh;
+    
+    if (mesh->polyCount > 0)
+    {
+        NavPath outPath;
+        NavPath_Init(&outPath);
+        
+        enum { kPairCount = 24 };
+        const NavPoly* pairs[kPairCount][2];
+        
+        srand(seed);
+        
+        for (int i = 0; i < kPairCount; ++i)
+        {
+            pairs[i][0] = mesh->polys + (rand() % mesh->polyCount);
+            pairs[i][1] = mesh->polys + (rand() % mesh->polyCount);
+        }
+        
+        double t0 = Bench_Seconds();
+        
+        for (int i = 0; i < queryCount; ++i)
+        {
+            const NavPoly** pair = pairs[rand() % kPairCount];
+            
+            // endpoints move around inside the same polys
+            Vec3 offset = Vec3_Create(Bench_Random() - 0.5f, Bench_Random() - 0.5f, 0.0f);
+            
+            NavSystem_FindPath(&system,
+                               2.0f,
+                               Vec3_Add(pair[0]->plane.point, offset),
+                               Vec3_Sub(pair[1]->plane.point, offset),
+                               pair[0],
+                               pair[1],
+                               NULL,
+                               &outPath);
+        }
+        
+        double cacheTime = Bench_Seconds() - t0;
+        
+        printf("cached find path: %.0f paths/sec (%.3f us/path, %i hits, %i misses)\n",
+               queryCount / cacheTime,
+               (cacheTime * 1e6) / queryCount,
+               system.pathCache.hits,
+               system.pathCache.misses);
+        
+        NavPath_Shutdown(&outPath);
+    }
+    
+    NavSystem_Shutdown(&system);
+}
+
+enum
+{
+    kReplayRaycast = 0,
+    kReplayLocate,
+    kReplayLine,
+    kReplayPolyLine,
+    kReplayPath,
+    kReplayPlan,
+    kReplayStep,
+    kReplayFlow,
+    kReplayFlood,
+    kReplayCount,
+};
+
+static const char* g_replayNames[kReplayCount] = {
+    "raycast", "locate", "line", "polyline", "path", "plan", "step", "flow", "flood",
+};
+
+static const NavPoly* Bench_ReplayPoly(const NavMesh* mesh, int index, int* valid)
+{
+    if (index < -1 || index >= mesh->polyCount)
+    {
+        *valid = 0;
+        return NULL;
+    }
+    
+    return index == -1 ? NULL : mesh->polys + index;
+}
+
+/* replays a query log written by a NAV_PROFILE build (see nav_profile.h) through a NavSystem,
+   reporting the time spent on each kind of query and the slowest tick */
+static int Bench_Replay(const char* path, const char* logPath)
+{
+    FILE* file = fopen(logPath, "r");
+    
+    if (!file)
+    {
+        fprintf(stderr, "failed to open query log: %s\n", logPath);
+        return 1;
+    }
+    
+    // a profile build would record over the log being replayed
+    unsetenv("NAV_QUERY_LOG");
+    
+    static NavSystem system;
+    NavSystem_Init(&system);
+    
+    Filepath_SetDirectory(kDirectoryData, path[0] == '/' ? "" : ".");
+    NavSystem_LoadMesh(&system, path);
+    
+    const NavMesh* mesh = &system.navMesh;
+    
+    if (mesh->polyCount < 1)
+    {
+        fprintf(stderr, "failed to load nav mesh: %s\n", path);
+        fclose(file);
+        NavSystem_Shutdown(&system);
+        return 1;
+    }
+    
+    NavPath outPath;
+    NavPath_Init(&outPath);
+    
+    // planned paths have a path of their own, so a cancel only stops the planner
+    NavPath planPath;
+    NavPath_Init(&planPath);
+    
+    int calls[kReplayCount] = {0};
+    double times[kReplayCount] = {0.0};
+    
+    int ticks = 0;
+    int skipped = 0;
+    int meshes = 0;
+    double tickTime = 0.0;
+    double maxTickTime = 0.0;
+    
+    char line[LINE_BUFFER_MAX];
+    char name[64];
+    
+    while (fgets(line, LINE_BUFFER_MAX, file))
+    {
+        if (sscanf(line, "%63s", name) != 1)
+            continue;
+        
+        if (strcmp(name, "tick") == 0)
+        {
+            NavSystem_EndTick(&system);
+            maxTickTime = MAX(maxTickTime, tickTime);
+            tickTime = 0.0;
+            ++ticks;
+            continue;
+        }
+        
+        if (strcmp(name, "mesh") == 0)
+        {
+            if (meshes++ == 0)
+                printf("replaying queries recorded on %s", line + 5);
+            continue;
+        }
+        
+        int kind = -1;
+        int valid = 1;
+        
+        float radius, maxCost;
+        int polyA, polyB, budget;
+        Vec3 a, b;
+        
+        double t0 = Bench_Seconds();
+        
+        if (strcmp(name, "raycast") == 0 &&
+            sscanf(line, "%*s %f %f %f %f %f %f", &a.x, &a.y, &a.z, &b.x, &b.y, &b.z) == 6)
+        {
+            NavRaycastResult hitInfo;
+            kind = kReplayRaycast;
+            t0 = Bench_Seconds();
+            NavSystem_Raycast(&system, Ray3_Create(a, b), &hitInfo);
+        }
+        else if (strcmp(name, "locate") == 0 &&
+                 sscanf(line, "%*s %i %f %f %f", &polyA, &a.x, &a.y, &a.z) == 4)
+        {
+            NavRaycastResult hitInfo;
+            const NavPoly* hintPoly = Bench_ReplayPoly(mesh, polyA, &valid);
+            kind = kReplayLocate;
+            t0 = Bench_Seconds();
+            
+            if (valid)
+                NavSystem_LocatePoint(&system, hintPoly, a, &hitInfo);
+        }
+        else if (strcmp(name, "line") == 0 &&
+                 sscanf(line, "%*s %i %f %f %f %f %f %f", &polyA, &a.x, &a.y, &a.z, &b.x, &b.y, &b.z) == 7)
+        {
+            const NavPoly* hintPoly = Bench_ReplayPoly(mesh, polyA, &valid);
+            kind = kReplayLine;
+            t0 = Bench_Seconds();
+            
+            if (valid)
+                NavSystem_LineIntersectsSolid(&system, hintPoly, a, b);
+        }
+        else if (strcmp(name, "polyline") == 0 &&
+                 sscanf(line, "%*s %i %i %f %f %f %f %f %f", &polyA, &polyB, &a.x, &a.y, &a.z, &b.x, &b.y, &b.z) == 8)
+        {
+            const NavPoly* startPoly = Bench_ReplayPoly(mesh, polyA, &valid);
+            const NavPoly* endPoly = Bench_ReplayPoly(mesh, polyB, &valid);
+            kind = kReplayPolyLine;
+            t0 = Bench_Seconds();
+            
+            if (valid)
+                NavSystem_PolyLineIntersectsSolid(&system, startPoly, endPoly, a, b);
+        }
+        else if ((strcmp(name, "path") == 0 || strcmp(name, "plan") == 0 || strcmp(name, "flow") == 0) &&
+                 sscanf(line, "%*s %f %f %f %f %f %f %f %i %i", &radius, &a.x, &a.y, &a.z, &b.x, &b.y, &b.z, &polyA, &polyB) == 9)
+        {
+            const NavPoly* startPoly = Bench_ReplayPoly(mesh, polyA, &valid);
+            const NavPoly* endPoly = Bench_ReplayPoly(mesh, polyB, &valid);
+            kind = (name[0] == 'p') ? ((name[1] == 'a') ? kReplayPath : kReplayPlan) : kReplayFlow;
+            t0 = Bench_Seconds();
+            
+            if (valid && kind == kReplayPath)
+                NavSystem_FindPath(&system, radius, a, b, startPoly, endPoly, NULL, &outPath);
+            else if (valid && kind == kReplayPlan)
+                NavSystem_BeginPlan(&system, radius, a, b, startPoly, endPoly, NULL, &planPath);
+            else if (valid)
+                NavSystem_FindFlowPath(&system, radius, a, b, startPoly, endPoly, &outPath);
+        }
+        else if (strcmp(name, "step") == 0 && sscanf(line, "%*s %i", &budget) == 1)
+        {
+            kind = kReplayStep;
+            t0 = Bench_Seconds();
+            NavSystem_StepPlan(&system, budget);
+        }
+        else if (strcmp(name, "cancel") == 0)
+        {
+            NavSystem_CancelPlan(&system, &planPath);
+            continue;
+        }
+        else if (strcmp(name, "flood") == 0 &&
+                 sscanf(line, "%*s %i %f %f %f %f", &polyA, &a.x, &a.y, &a.z, &maxCost) == 5)
+        {
+            const NavPoly* startPoly = Bench_ReplayPoly(mesh, polyA, &valid);
+            kind = kReplayFlood;
+            t0 = Bench_Seconds();
+            
+            if (valid)
+                NavSystem_Flood(&system, startPoly, a, maxCost, NULL);
+        }
+        
+        double elapsed = Bench_Seconds() - t0;
+        
+        // recorded on a different mesh, or a line this build does not know
+        if (kind == -1 || !valid)
+        {
+            ++skipped;
+            continue;
+        }
+        
+        ++calls[kind];
+        times[kind] += elapsed;
+        tickTime += elapsed;
+    }
+    
+    maxTickTime = MAX(maxTickTime, tickTime);
+    
+    double totalTime = 0.0;
+    
+    for (int i = 0; i < kReplayCount; ++i)
+    {
+        totalTime += times[i];
+        
+        if (calls[i] == 0)
+            continue;
+        
+        printf("replay %-8s %8i calls %10.3f us/call %10.3f ms total\n",
+               g_replayNames[i],
+               calls[i],
+               (times[i] * 1e6) / calls[i],
+               times[i] * 1000.0);
+    }
+    
+    printf("replay: %i ticks, %.3f ms total, %.3f us/tick, %.3f us slowest tick, %i lines skipped\n",
+           ticks,
+           totalTime * 1000.0,
+           (totalTime * 1e6) / MAX(ticks, 1),
+           maxTickTime * 1e6,
+           skipped);
+    
+    if (meshes > 1)
+        printf("replay: the log spans %i mesh loads, all were replayed on %s\n", meshes, path);
+
+#ifdef NAV_PROFILE
+    NavProfile_Print(system.profile, stdout);
+#endif
+
+    fclose(file);
+    NavPath_Shutdown(&outPath);
+    NavPath_Shutdown(&planPath);
+    NavSystem_Shutdown(&system);
+    return 0;
+}
+
+int main(int argc, const char * argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <file.nav> [query count] [seed] [max threads]\n", argv[0]);
+        fprintf(stderr, "       %s <file.nav> --replay <query log>\n", argv[0]);
+        return 1;
+    }
+    
+    if (argc > 3 && strcmp(argv[2], "--replay") == 0)
+        return Bench_Replay(argv[1], argv[3]);
+    
+    int queryCount = (argc > 2) ? atoi(argv[2]) : 5000;
+    unsigned int seed = (argc > 3) ? (unsigned int)atoi(argv[3]) : 1;
+    int threadMax = (argc > 4) ? atoi(argv[4]) : NavBatch_DefaultThreadCount();
+    
+    NavMesh mesh;
+    
+    double loadStart = Bench_Seconds();
+    
+    if (!NavMesh_FromPath(&mesh, argv[1]))
+    {
+        fprintf(stderr, "failed to load nav mesh: %s\n", argv[1]);
+        return 1;
+    }
+    
+    double loadTime = Bench_Seconds() - loadStart;
+    
+    printf("mesh: %s\n", argv[1]);
+    printf("polys: %i edges: %i vertices: %i\n", mesh.polyCount, mesh.edgeCount, mesh.vertexCount);
+    printf("load: %.3f ms\n", loadTime * 1000.0);
+    
+    NavSolver solver;
+    NavSolver_Init(&solver);
+    NavSolver_Prepare(&solver, &mesh);
+    
+    double flatSolveTime = Bench_Solve(&mesh, &solver, "flat", queryCount, seed);
+    Bench_Smooth(&mesh, &solver, queryCount, seed);
+    Bench_ColdSolve(&mesh, &solver, queryCount, seed);
+    
+    double regionStart = Bench_Seconds();
+    NavMesh_BuildRegions(&mesh);
+    double regionTime = Bench_Seconds() - regionStart;
+    
+    if (mesh.regions.regionCount > 0)
+    {
+        printf("regions: %i exits: %i build: %.3f ms\n",
+               mesh.regions.regionCount,
+               mesh.regions.exitCount,
+               regionTime * 1000.0);
+        
+        NavSolver_Prepare(&solver, &mesh);
+        Bench_Solve(&mesh, &solver, "regions", queryCount, seed);
+    }
+    
+    Bench_Slice(&mesh, &solver, queryCount, seed, NAV_PLAN_EXPANSIONS_PER_TICK);
+    Bench_Batch(&mesh, &solver, queryCount, seed, threadMax);
+    Bench_Flow(&mesh, &solver, queryCount, seed, 4);
+    Bench_Flow(&mesh, &solver, queryCount, seed, 32);
+    Bench_Avoid(48, 3000);
+    Bench_Avoid(256, 4000);
+    
+    /* move range floods, like AI reports, against one solve per reached poly */
+    float* costs = malloc(sizeof(float) * mesh.polyCount);
+    
+    srand(seed);
+    
+    long reachedTotal = 0;
+    double floodTime = 0.0;
+    
+    for (int i = 0; i < queryCount; ++i)
+    {
+        const NavPoly* startPoly = mesh.polys + (rand() % mesh.polyCount);
+        
+        double t0 = Bench_Seconds();
+        reachedTotal += NavSolver_Flood(&solver, &mesh, startPoly, startPoly->plane.point, 40.0f, NULL, costs);
+        floodTime += Bench_Seconds() - t0;
+    }
+    
+    printf("flood: %.0f floods/sec (%.3f us/flood, %.1f avg polys in range 40)\n",
+           queryCount / floodTime,
+           (floodTime * 1e6) / queryCount,
+           (double)reachedTotal / queryCount);
+    
+    printf("flood: %.3f us/reached poly, vs %.3f us/solve\n",
+           (floodTime * 1e6) / MAX(reachedTotal, 1),
+           (flatSolveTime * 1e6) / queryCount);
+    
+    free(costs);
+    
+    Bench_Cache(argv[1], queryCount, seed);
+    
+    /* rays straight down, like unit ground checks,
+     and angled down, like camera and tap rays */
+    srand(seed);
+    
+    AABB bounds = mesh.polys[0].bounds;
+    
+    for (int i = 1; i < mesh.polyCount; ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            Vec3_Get(bounds.min, k) = MIN(Vec3_Get(bounds.min, k), Vec3_Get(mesh.polys[i].bounds.min, k));
+            Vec3_Get(bounds.max, k) = MAX(Vec3_Get(bounds.max, k), Vec3_Get(mesh.polys[i].bounds.max, k));
+        }
+    }
+    
+    const Vec3 angledDir = Vec3_Norm(Vec3_Create(0.0f, 1.0f, -1.5f));
+    
+    int hits = 0;
+    double rayTime = 0.0;
+    
+    for (int i = 0; i < queryCount; ++i)
+    {
+        Vec3 target = Vec3_Create(Interp_Lerp(Bench_Random(), bounds.min.x, bounds.max.x),
+                                  Interp_Lerp(Bench_Random(), bounds.min.y, bounds.max.y),
+                                  bounds.min.z);
+        
+        Ray3 ray;
+        
+        if (i % 2 == 0)
+        {
+            ray = Ray3_Create(Vec3_Offset(target, 0.0f, 0.0f, 2.0f), Vec3_Create(0.0f, 0.0f, -1.0f));
+        }
+        else
+        {
+            ray = Ray3_Create(Vec3_Sub(target, Vec3_Scale(angledDir, 40.0f)), angledDir);
+        }
+        
+        float t;
+        double t0 = Bench_Seconds();
+        
+        if (NavMesh_Raycast(&mesh, ray, &t))
+            ++hits;
+        
+        rayTime += Bench_Seconds() - t0;
+    }
+    
+    printf("raycast: %.0f rays/sec (%.3f us/ray, %i hits)\n",
+           queryCount / rayTime,
+           (rayTime * 1e6) / queryCount,
+           hits);
+    
+    /* points moving a short step each query, like units following paths */
+    const NavPoly* hint = NULL;
+    Vec3 walker = mesh.polys[0].plane.point;
+    Vec3 walkDir = Vec3_Create(1.0f, 0.0f, 0.0f);
+    
+    int located = 0;
+    double locateTime = 0.0;
+    
+    for (int i = 0; i < queryCount; ++i)
+    {
+        if (i % 64 == 0)
+        {
+            float angle = Bench_Random() * 2.0f * M_PI;
+            walkDir = Vec3_Create(cosf(angle) * 0.5f, sinf(angle) * 0.5f, 0.0f);
+        }
+        
+        walker = Vec3_Add(walker, walkDir);
+        
+        if (walker.x < bounds.min.x || walker.x > bounds.max.x ||
+            walker.y < bounds.min.y || walker.y > bounds.max.y)
+        {
+            walker = mesh.polys[rand() % mesh.polyCount].plane.point;
+        }
+        
+        float t;
+        double t0 = Bench_Seconds();
+        
+        hint = NavMesh_LocatePoint(&mesh, hint, Vec3_Offset(walker, 0.0f, 0.0f, 2.0f), &t);
+        
+        locateTime += Bench_Seconds() - t0;
+        
+        if (hint)
+            ++located;
+    }
+    
+    printf("locate: %.0f locates/sec (%.3f us/locate, %i hits)\n",
+           queryCount / locateTime,
+           (locateTime * 1e6) / queryCount,
+           located);
+    
+    /* short lines above the ground, like bullets each tick and ai sight checks */
+    int lineHits = 0;
+    int surfaceHits = 0;
+    double lineTime = 0.0;
+    
+    for (int i = 0; i < queryCount; ++i)
+    {
+        const NavPoly* startPoly = mesh.polys + rand() % mesh.polyCount;
+        Vec3 start = Vec3_Offset(startPoly->plane.point, 0.0f, 0.0f, 1.0f);
+        
+        float angle = Bench_Random() * 2.0f * M_PI;
+        float length = Interp_Lerp(Bench_Random(), 2.0f, 40.0f);
+        Vec3 end = Vec3_Add(start, Vec3_Create(cosf(angle) * length, sinf(angle) * length, 0.0f));
+        
+        NavLineHit hit;
+        double t0 = Bench_Seconds();
+        
+        if (NavMesh_LineWalk(&mesh, startPoly, start, end, kNavEdgeFlagSolid, &hit))
+        {
+            ++lineHits;
+            
+            if (hit.edgeIndex == -1)
+                ++surfaceHits;
+        }
+        
+        lineTime += Bench_Seconds() - t0;
+    }
+    
+    printf("line walk: %.0f lines/sec (%.3f us/line, %i hits, %i through the ground)\n",
+           queryCount / lineTime,
+           (lineTime * 1e6) / queryCount,
+           lineHits,
+           surfaceHits);
+    
+    NavSolver_Shutdown(&solver);
+    NavMesh_Shutdown(&mesh);
+    
+    return 0;
+}